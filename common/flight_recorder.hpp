@@ -1,11 +1,21 @@
 #pragma once
 
+#include <endian.h>
+
 #include <common/utils.hpp>
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
+#include <span>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 PHOSPHOR_LOG2_USING;
@@ -15,18 +25,135 @@ namespace pldm
 namespace flightrecorder
 {
 using ReqOrResponse = bool;
-using FlightRecorderData = std::vector<uint8_t>;
-using FlightRecorderTimeStamp = std::string;
-using FlightRecorderRecord =
-    std::tuple<FlightRecorderTimeStamp, ReqOrResponse, FlightRecorderData>;
-using FlightRecorderCassette = std::vector<FlightRecorderRecord>;
 static constexpr auto flightRecorderDumpPath = "/tmp/pldm_flight_recorder";
+static constexpr auto flightRecorderBinaryDumpPath =
+    "/tmp/pldm_flight_recorder.bin";
+
+/** @brief Binary dump format
+ *
+ *  All fields are little-endian. The file starts with the 8 byte magic, a
+ *  uint16_t format version and a uint32_t record count, followed by the
+ *  records. Each record is a uint64_t steady clock timestamp in ns, the
+ *  uint32_t message length, the uint8_t EID, a uint8_t that is 1 for a
+ *  transmitted message, the uint16_t number of captured bytes and then the
+ *  captured bytes themselves.
+ */
+static constexpr std::array<char, 8> flightRecorderMagic = {
+    'P', 'L', 'D', 'M', 'F', 'R', 'E', 'C'};
+static constexpr uint16_t flightRecorderFormatVersion = 1;
+
+/** @brief A PLDM message captured by the flight recorder */
+struct FlightRecorderRecord
+{
+    /** @brief steady clock time the message was recorded at, in ns */
+    uint64_t timestamp;
+    /** @brief length of the message, which may exceed the captured payload */
+    uint32_t length;
+    /** @brief MCTP EID of the remote endpoint */
+    uint8_t eid;
+    /** @brief true for a transmitted message, false for a received one */
+    ReqOrResponse isTx;
+    /** @brief first FLIGHT_RECORDER_PAYLOAD_SIZE bytes of the message */
+    std::array<uint8_t, FLIGHT_RECORDER_PAYLOAD_SIZE> payload;
+};
+
+/** @brief A PLDM message read back from a binary flight recorder dump */
+struct RecordedMessage
+{
+    uint64_t timestamp;
+    uint32_t length;
+    uint8_t eid;
+    ReqOrResponse isTx;
+    /** @brief captured bytes, shorter than length if truncated */
+    std::vector<uint8_t> payload;
+};
+
+/** @brief Read a binary flight recorder dump
+ *
+ *  @param[in] path - path of the dump written by
+ *                    FlightRecorder::dumpRecorderBinary()
+ *  @return the recorded messages, oldest first
+ *  @throw std::runtime_error if the file can't be read or is malformed
+ */
+inline std::vector<RecordedMessage> loadRecorderDump(const std::string& path)
+{
+    std::ifstream dumpFile(path, std::ios::binary);
+    if (!dumpFile)
+    {
+        throw std::runtime_error("Failed to open " + path);
+    }
+
+    auto readLe = [&dumpFile, &path]<typename T>(T& value) {
+        if (!dumpFile.read(reinterpret_cast<char*>(&value), sizeof(value)))
+        {
+            throw std::runtime_error("Truncated flight recorder dump " +
+                                     path);
+        }
+        if constexpr (sizeof(T) == 2)
+        {
+            value = le16toh(value);
+        }
+        else if constexpr (sizeof(T) == 4)
+        {
+            value = le32toh(value);
+        }
+        else if constexpr (sizeof(T) == 8)
+        {
+            value = le64toh(value);
+        }
+    };
+
+    std::array<char, flightRecorderMagic.size()> magic{};
+    uint16_t version{};
+    uint32_t count{};
+    dumpFile.read(magic.data(), magic.size());
+    if (!dumpFile || magic != flightRecorderMagic)
+    {
+        throw std::runtime_error(path + " is not a flight recorder dump");
+    }
+    readLe(version);
+    if (version != flightRecorderFormatVersion)
+    {
+        throw std::runtime_error("Unsupported flight recorder dump version " +
+                                 std::to_string(version));
+    }
+    readLe(count);
+
+    std::vector<RecordedMessage> messages;
+    messages.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        RecordedMessage message{};
+        uint8_t isTx{};
+        uint16_t captured{};
+        readLe(message.timestamp);
+        readLe(message.length);
+        readLe(message.eid);
+        readLe(isTx);
+        readLe(captured);
+        message.isTx = isTx != 0;
+        message.payload.resize(captured);
+        if (!dumpFile.read(reinterpret_cast<char*>(message.payload.data()),
+                           captured))
+        {
+            throw std::runtime_error("Truncated flight recorder dump " +
+                                     path);
+        }
+        messages.push_back(std::move(message));
+    }
+    return messages;
+}
 
 /** @class FlightRecorder
  *
  *  The class for implementing the PLDM flight recorder logic. This class
  *  handles the insertion of the data into the recorder and also provides
  *  API's to dump the flight recorder into a file.
+ *
+ *  Messages are stored in a preallocated ring of fixed size slots claimed
+ *  with an atomic counter, so saveRecord() neither allocates nor locks and
+ *  may be called from any thread. Timestamps are only formatted when the
+ *  recorder is dumped.
  */
 
 class FlightRecorder
@@ -37,13 +164,23 @@ class FlightRecorder
         flightRecorderPolicy = FLIGHT_RECORDER_MAX_ENTRIES ? true : false;
         if (flightRecorderPolicy)
         {
-            tapeRecorder = FlightRecorderCassette(FLIGHT_RECORDER_MAX_ENTRIES);
+            tapeRecorder =
+                std::make_unique<Slot[]>(FLIGHT_RECORDER_MAX_ENTRIES);
         }
     }
 
+    /** @brief A ring slot, guarded by a sequence number that is odd while
+     *         the slot is being written
+     */
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence{0};
+        FlightRecorderRecord record;
+    };
+
   protected:
-    int index;
-    FlightRecorderCassette tapeRecorder;
+    std::atomic<uint64_t> index;
+    std::unique_ptr<Slot[]> tapeRecorder;
     bool flightRecorderPolicy;
 
   public:
@@ -60,29 +197,143 @@ class FlightRecorder
     }
 
     /** @brief Add records to the flightRecorder
+     *
+     *  Only the first FLIGHT_RECORDER_PAYLOAD_SIZE bytes of the message are
+     *  kept.
      *
      *  @param[in] buffer  - The request/respose byte buffer
      *  @param[in] isRequest - bool that captures if it is a request message or
      *                         a response message
+     *  @param[in] eid - MCTP EID of the remote endpoint
      *
      *  @return void
      */
-    void saveRecord(const FlightRecorderData& buffer, ReqOrResponse isRequest)
+    void saveRecord(std::span<const uint8_t> buffer, ReqOrResponse isRequest,
+                    uint8_t eid = 0)
     {
         // if the flight recorder policy is enabled, then only insert the
         // messages into the flight recorder, if not this function will be just
         // a no-op
         if (flightRecorderPolicy)
         {
-            int currentIndex = index++;
-            tapeRecorder[currentIndex] = std::make_tuple(
-                pldm::utils::getCurrentSystemTime(), isRequest, buffer);
-            index = (currentIndex == FLIGHT_RECORDER_MAX_ENTRIES - 1) ? 0
-                                                                      : index;
+            auto currentIndex = index.fetch_add(1, std::memory_order_relaxed);
+            auto& slot = tapeRecorder[currentIndex %
+                                      FLIGHT_RECORDER_MAX_ENTRIES];
+
+            slot.sequence.store(2 * currentIndex + 1,
+                                std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            auto& record = slot.record;
+            record.timestamp =
+                std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now().time_since_epoch())
+                    .count();
+            record.length = buffer.size();
+            record.eid = eid;
+            record.isTx = isRequest;
+            std::copy_n(buffer.begin(),
+                        std::min(buffer.size(), record.payload.size()),
+                        record.payload.begin());
+
+            slot.sequence.store(2 * currentIndex + 2,
+                                std::memory_order_release);
+        }
+    }
+
+    /** @brief Take a consistent copy of the recorded messages
+     *
+     *  Slots that are being written while the snapshot is taken are skipped.
+     *
+     *  @return the recorded messages, oldest first
+     */
+    std::vector<FlightRecorderRecord> snapshot() const
+    {
+        std::vector<FlightRecorderRecord> records;
+        if (!flightRecorderPolicy)
+        {
+            return records;
+        }
+
+        auto end = index.load(std::memory_order_acquire);
+        auto begin = end > FLIGHT_RECORDER_MAX_ENTRIES
+                         ? end - FLIGHT_RECORDER_MAX_ENTRIES
+                         : 0;
+        records.reserve(end - begin);
+        for (auto i = begin; i < end; i++)
+        {
+            const auto& slot = tapeRecorder[i % FLIGHT_RECORDER_MAX_ENTRIES];
+            auto sequence = slot.sequence.load(std::memory_order_acquire);
+            if (sequence != 2 * i + 2)
+            {
+                continue;
+            }
+            auto record = slot.record;
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == sequence)
+            {
+                records.push_back(record);
+            }
+        }
+        return records;
+    }
+
+    /** @brief Write the recorded messages to a compact binary file, which
+     *         can be read back with loadRecorderDump()
+     *
+     *  @param[in] path - path of the dump file
+     *
+     *  @return void
+     */
+    void dumpRecorderBinary(const std::string& path) const
+    {
+        auto records = snapshot();
+        std::ofstream dumpFile(path, std::ios::binary | std::ios::trunc);
+
+        auto writeLe = [&dumpFile](auto value) {
+            if constexpr (sizeof(value) == 2)
+            {
+                value = htole16(value);
+            }
+            else if constexpr (sizeof(value) == 4)
+            {
+                value = htole32(value);
+            }
+            else if constexpr (sizeof(value) == 8)
+            {
+                value = htole64(value);
+            }
+            dumpFile.write(reinterpret_cast<const char*>(&value),
+                           sizeof(value));
+        };
+
+        dumpFile.write(flightRecorderMagic.data(), flightRecorderMagic.size());
+        writeLe(flightRecorderFormatVersion);
+        writeLe(static_cast<uint32_t>(records.size()));
+        for (const auto& record : records)
+        {
+            auto captured = static_cast<uint16_t>(
+                std::min<size_t>(record.length, record.payload.size()));
+            writeLe(record.timestamp);
+            writeLe(record.length);
+            writeLe(record.eid);
+            writeLe(static_cast<uint8_t>(record.isTx));
+            writeLe(captured);
+            dumpFile.write(reinterpret_cast<const char*>(record.payload.data()),
+                           captured);
+        }
+
+        if (!dumpFile)
+        {
+            error("Failed to write the flight recorder dump {DUMP_PATH}",
+                  "DUMP_PATH", path);
         }
     }
 
     /** @brief play flight recorder
+     *
+     *  Writes a text dump to flightRecorderDumpPath and a binary dump, for
+     *  pldm-replay, to flightRecorderBinaryDumpPath.
      *
      *  @return void
      */
@@ -91,27 +342,49 @@ class FlightRecorder
     {
         if (flightRecorderPolicy)
         {
+            dumpRecorderBinary(flightRecorderBinaryDumpPath);
             std::ofstream recorderOutputFile(flightRecorderDumpPath);
             info("Dumping the flight recorder into : {DUMP_PATH}", "DUMP_PATH",
                  flightRecorderDumpPath);
-            for (const auto& message : tapeRecorder)
+
+            // Map steady clock timestamps onto the wall clock
+            auto steadyNow = std::chrono::steady_clock::now();
+            auto systemNow = std::chrono::system_clock::now();
+            for (const auto& record : snapshot())
             {
-                recorderOutputFile << std::get<FlightRecorderTimeStamp>(message)
-                                   << " : ";
-                if (std::get<ReqOrResponse>(message))
+                auto age = steadyNow.time_since_epoch() -
+                           std::chrono::nanoseconds(record.timestamp);
+                recorderOutputFile
+                    << pldm::utils::formatSystemTime(
+                           systemNow -
+                           std::chrono::duration_cast<
+                               std::chrono::system_clock::duration>(age))
+                    << " : ";
+                if (record.isTx)
                 {
-                    recorderOutputFile << "Tx : \n";
+                    recorderOutputFile << "Tx : ";
                 }
                 else
                 {
-                    recorderOutputFile << "Rx : \n";
+                    recorderOutputFile << "Rx : ";
+                }
+                recorderOutputFile << "EID " << std::dec
+                                   << static_cast<unsigned>(record.eid);
+                if (record.length > record.payload.size())
+                {
+                    recorderOutputFile << " (" << record.length
+                                       << " bytes, truncated)";
                 }
-                for (const auto& word : std::get<FlightRecorderData>(message))
+                recorderOutputFile << " : \n";
+                auto length = std::min<size_t>(record.length,
+                                               record.payload.size());
+                for (size_t i = 0; i < length; i++)
                 {
                     recorderOutputFile << std::setfill('0') << std::setw(2)
-                                       << std::hex << (unsigned)word << " ";
+                                       << std::hex
+                                       << (unsigned)record.payload[i] << " ";
                 }
-                recorderOutputFile << std::endl;
+                recorderOutputFile << std::dec << std::endl;
             }
             recorderOutputFile.close();
         }
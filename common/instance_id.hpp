@@ -39,7 +39,7 @@ class InstanceIdDb
         }
     }
 
-    ~InstanceIdDb()
+    virtual ~InstanceIdDb()
     {
         /*
          * Abandon error-reporting. We shouldn't throw an exception from the
@@ -56,7 +56,7 @@ class InstanceIdDb
      *  @return - PLDM instance id or -EAGAIN if there are no available instance
      *            IDs
      */
-    uint8_t next(uint8_t tid)
+    virtual uint8_t next(uint8_t tid)
     {
         uint8_t id;
         int rc = pldm_instance_id_alloc(pldmInstanceIdDb, tid, &id);
@@ -78,7 +78,7 @@ class InstanceIdDb
      *  @param[in] tid - the terminus ID the instance ID is associated with
      *  @param[in] instanceId - PLDM instance id to be freed
      */
-    void free(uint8_t tid, uint8_t instanceId)
+    virtual void free(uint8_t tid, uint8_t instanceId)
     {
         int rc = pldm_instance_id_free(pldmInstanceIdDb, tid, instanceId);
         if (rc == -EINVAL)
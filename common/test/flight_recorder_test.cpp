@@ -0,0 +1,58 @@
+#include "common/flight_recorder.hpp"
+
+#include <filesystem>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::flightrecorder;
+
+TEST(FlightRecorder, binaryDumpRoundTrip)
+{
+    if (!FLIGHT_RECORDER_MAX_ENTRIES)
+    {
+        GTEST_SKIP() << "flight recorder disabled";
+    }
+
+    std::vector<uint8_t> request{0x80, 0x02, 0x01};
+    std::vector<uint8_t> response(FLIGHT_RECORDER_PAYLOAD_SIZE + 8, 0xa5);
+
+    auto& recorder = FlightRecorder::GetInstance();
+    recorder.saveRecord(request, false, 9);
+    recorder.saveRecord(response, true, 9);
+
+    auto path = std::filesystem::temp_directory_path() /
+                "pldm_flight_recorder_test.bin";
+    recorder.dumpRecorderBinary(path);
+    auto messages = loadRecorderDump(path);
+    std::filesystem::remove(path);
+
+    ASSERT_GE(messages.size(), 2u);
+    const auto& rx = messages[messages.size() - 2];
+    const auto& tx = messages.back();
+
+    EXPECT_EQ(rx.eid, 9);
+    EXPECT_FALSE(rx.isTx);
+    EXPECT_EQ(rx.length, request.size());
+    EXPECT_EQ(rx.payload, request);
+
+    EXPECT_EQ(tx.eid, 9);
+    EXPECT_TRUE(tx.isTx);
+    EXPECT_EQ(tx.length, response.size());
+    EXPECT_EQ(tx.payload.size(), FLIGHT_RECORDER_PAYLOAD_SIZE);
+    EXPECT_LE(rx.timestamp, tx.timestamp);
+}
+
+TEST(FlightRecorder, loadRejectsBadDump)
+{
+    auto path = std::filesystem::temp_directory_path() /
+                "pldm_flight_recorder_bad.bin";
+    {
+        std::ofstream dumpFile(path);
+        dumpFile << "not a dump";
+    }
+    EXPECT_THROW(loadRecorderDump(path), std::runtime_error);
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(loadRecorderDump(path), std::runtime_error);
+}
@@ -0,0 +1,53 @@
+#include "common/utils.hpp"
+
+#include <libpldm/utils.h>
+
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+using namespace pldm::utils;
+
+/** @brief Compare libpldm's byte-at-a-time crc32() with crc32Update() over
+ *         buffers sized like typical FRU and BIOS tables
+ */
+int main()
+{
+    constexpr auto iterations = 2000;
+
+    for (size_t size : {256, 4096, 65536})
+    {
+        std::vector<uint8_t> data(size);
+        for (size_t i = 0; i < size; i++)
+        {
+            data[i] = static_cast<uint8_t>(i * 131 + 17);
+        }
+
+        volatile uint32_t sink = 0;
+
+        auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            sink = crc32(data.data(), data.size());
+        }
+        auto libpldmTime = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++)
+        {
+            sink = crc32Final(crc32Update(crc32Init, data.data(), data.size()));
+        }
+        auto utilsTime = std::chrono::steady_clock::now() - start;
+        (void)sink;
+
+        auto mbps = [size](auto elapsed) {
+            auto secs = std::chrono::duration<double>(elapsed).count();
+            return (double(size) * iterations) / secs / (1024 * 1024);
+        };
+        std::printf("%6zu bytes: libpldm crc32 %8.1f MiB/s, "
+                    "crc32Update %8.1f MiB/s\n",
+                    size, mbps(libpldmTime), mbps(utilsTime));
+    }
+
+    return 0;
+}
@@ -1012,3 +1012,35 @@ TEST(Split, allTestCases)
     auto results5 = split(s5, "\\");
     EXPECT_EQ(results5[0], "aa");
 }
+
+TEST(Crc32, matchesLibpldm)
+{
+    std::vector<uint8_t> data(1031);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+
+    for (auto size : {0, 1, 7, 8, 9, 64, 1031})
+    {
+        EXPECT_EQ(crc32Final(crc32Update(crc32Init, data.data(), size)),
+                  crc32(data.data(), size));
+    }
+
+    const char check[] = "123456789";
+    EXPECT_EQ(crc32Final(crc32Update(crc32Init, check, 9)), 0xCBF43926);
+}
+
+TEST(Crc32, incrementalUpdate)
+{
+    std::vector<uint8_t> data(100);
+    for (size_t i = 0; i < data.size(); i++)
+    {
+        data[i] = static_cast<uint8_t>(i);
+    }
+
+    auto state = crc32Update(crc32Init, data.data(), 13);
+    state = crc32Update(state, data.data() + 13, 50);
+    state = crc32Update(state, data.data() + 63, 37);
+    EXPECT_EQ(crc32Final(state), crc32(data.data(), data.size()));
+}
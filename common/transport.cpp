@@ -131,6 +131,10 @@ PldmTransport::PldmTransport()
     // }
 }
 
+PldmTransport::PldmTransport(std::nullptr_t) :
+    pfd{-1, 0, 0}, impl{}, transport(nullptr)
+{}
+
 PldmTransport::~PldmTransport()
 {
     // transport_impl_destroy(impl);
@@ -5,6 +5,8 @@
 #include <poll.h>
 #include <stddef.h>
 
+#include <cstddef>
+
 struct pldm_transport_mctp_demux;
 struct pldm_transport_af_mctp;
 
@@ -23,7 +25,7 @@ class PldmTransport
     PldmTransport(const PldmTransport&& other) = delete;
     PldmTransport& operator=(const PldmTransport& other) = delete;
     PldmTransport& operator=(const PldmTransport&& other) = delete;
-    ~PldmTransport();
+    virtual ~PldmTransport();
 
     /** @brief Provides a file descriptor that can be polled for readiness.
      *
@@ -32,7 +34,7 @@ class PldmTransport
      *
      * @return The relevant file descriptor.
      */
-    int getEventSource() const;
+    virtual int getEventSource() const;
 
     /** @brief Asynchronously send a PLDM message to the specified terminus
      *
@@ -45,7 +47,8 @@ class PldmTransport
      * @return PLDM_REQUESTER_SUCCESS on success, otherwise an appropriate
      *         PLDM_REQUESTER_* error code.
      */
-    pldm_requester_rc_t sendMsg(pldm_tid_t tid, const void* tx, size_t len);
+    virtual pldm_requester_rc_t sendMsg(pldm_tid_t tid, const void* tx,
+                                        size_t len);
 
     /** @brief Asynchronously receive a PLDM message addressed to the local
      * terminus
@@ -59,7 +62,8 @@ class PldmTransport
      * @return PLDM_REQUESTER_SUCCESS on success, otherwise an appropriate
      *         PLDM_REQUESTER_* error code.
      */
-    pldm_requester_rc_t recvMsg(pldm_tid_t& tid, void*& rx, size_t& len);
+    virtual pldm_requester_rc_t recvMsg(pldm_tid_t& tid, void*& rx,
+                                        size_t& len);
 
     /** @brief Synchronously exchange a request and response with the specified
      * terminus.
@@ -87,6 +91,13 @@ class PldmTransport
     pldm_requester_rc_t sendRecvMsg(pldm_tid_t tid, const void* tx,
                                     size_t txLen, void*& rx, size_t& rxLen);
 
+  protected:
+    /** @brief Construct a transport that isn't connected to MCTP, for
+     *         stand-ins overriding sendMsg(), and recvMsg() and
+     *         getEventSource() if they deliver messages
+     */
+    explicit PldmTransport(std::nullptr_t);
+
   private:
     /** @brief A pollfd object for holding a file descriptor from the libpldm
      *         transport implementation
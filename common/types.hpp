@@ -74,6 +74,17 @@ using CompKey = std::pair<CompClassification, CompIdentifier>;
 using CompClassificationIndex = uint8_t;
 using ComponentInfo = std::map<CompKey, CompClassificationIndex>;
 using ComponentInfoMap = std::unordered_map<eid, ComponentInfo>;
+// Component version strings the FDs report as pending activation
+using PendingCompVersions = std::map<CompKey, std::string>;
+using PendingCompVersionMap = std::unordered_map<eid, PendingCompVersions>;
+
+// Route (MCTP network or bus) each endpoint is reached through
+using EndpointRoute = std::string;
+using EndpointRoutes = std::unordered_map<eid, EndpointRoute>;
+
+// UUID each endpoint reports on D-Bus, identifying the device behind the EID
+using EndpointUUID = std::string;
+using EndpointUUIDs = std::unordered_map<eid, EndpointUUID>;
 
 // PackageHeaderInformation
 using PackageHeaderSize = size_t;
@@ -3,6 +3,10 @@
 #include <libpldm/pdr.h>
 #include <libpldm/pldm_types.h>
 
+#if defined(__ARM_FEATURE_CRC32)
+#include <arm_acle.h>
+#endif
+
 #include <phosphor-logging/lg2.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 #include <xyz/openbmc_project/Logging/Create/client.hpp>
@@ -11,6 +15,7 @@
 #include <algorithm>
 #include <array>
 #include <cctype>
+#include <cstring>
 #include <ctime>
 #include <fstream>
 #include <iostream>
@@ -361,6 +366,75 @@ uint8_t getNumPadBytes(uint32_t data)
     return pad;
 } // end getNumPadBytes
 
+namespace
+{
+/** @brief Slice-by-8 lookup tables for the reflected CRC32 polynomial,
+ *         crc32Tables[0] is the classic byte-at-a-time table and
+ *         crc32Tables[n] advances a byte through n further zero bytes
+ */
+constexpr std::array<std::array<uint32_t, 256>, 8> crc32Tables = []() {
+    std::array<std::array<uint32_t, 256>, 8> tables{};
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        uint32_t crc = i;
+        for (int bit = 0; bit < 8; bit++)
+        {
+            crc = (crc & 1) ? (crc >> 1) ^ 0xEDB88320 : crc >> 1;
+        }
+        tables[0][i] = crc;
+    }
+    for (uint32_t i = 0; i < 256; i++)
+    {
+        for (size_t slice = 1; slice < tables.size(); slice++)
+        {
+            auto prev = tables[slice - 1][i];
+            tables[slice][i] = tables[0][prev & 0xFF] ^ (prev >> 8);
+        }
+    }
+    return tables;
+}();
+} // namespace
+
+uint32_t crc32Update(uint32_t state, const void* data, size_t size)
+{
+    auto ptr = static_cast<const uint8_t*>(data);
+
+#if defined(__ARM_FEATURE_CRC32)
+    // ARMv8 CRC32 instructions implement the same (non-Castagnoli)
+    // polynomial, use them when the target has them.
+    while (size >= sizeof(uint64_t))
+    {
+        uint64_t word;
+        std::memcpy(&word, ptr, sizeof(word));
+        state = __crc32d(state, word);
+        ptr += sizeof(word);
+        size -= sizeof(word);
+    }
+    while (size--)
+    {
+        state = __crc32b(state, *ptr++);
+    }
+#else
+    const auto& t = crc32Tables;
+    while (size >= 8)
+    {
+        uint32_t lo = state ^ (uint32_t(ptr[0]) | uint32_t(ptr[1]) << 8 |
+                               uint32_t(ptr[2]) << 16 | uint32_t(ptr[3]) << 24);
+        state = t[7][lo & 0xFF] ^ t[6][(lo >> 8) & 0xFF] ^
+                t[5][(lo >> 16) & 0xFF] ^ t[4][lo >> 24] ^ t[3][ptr[4]] ^
+                t[2][ptr[5]] ^ t[1][ptr[6]] ^ t[0][ptr[7]];
+        ptr += 8;
+        size -= 8;
+    }
+    while (size--)
+    {
+        state = t[0][(state ^ *ptr++) & 0xFF] ^ (state >> 8);
+    }
+#endif
+
+    return state;
+}
+
 bool uintToDate(uint64_t data, uint16_t* year, uint8_t* month, uint8_t* day,
                 uint8_t* hour, uint8_t* min, uint8_t* sec)
 {
@@ -712,7 +786,7 @@ uint16_t findStateSensorId(const pldm_pdr* pdrRepo, uint8_t tid,
     return PLDM_INVALID_EFFECTER_ID;
 }
 
-void printBuffer(bool isTx, const std::vector<uint8_t>& buffer)
+void printBuffer(bool isTx, std::span<const uint8_t> buffer)
 {
     if (!buffer.empty())
     {
@@ -775,9 +849,13 @@ std::vector<std::string> split(std::string_view srcStr, std::string_view delim,
 }
 
 std::string getCurrentSystemTime()
+{
+    return formatSystemTime(std::chrono::system_clock::now());
+}
+
+std::string formatSystemTime(std::chrono::system_clock::time_point tp)
 {
     using namespace std::chrono;
-    const time_point<system_clock> tp = system_clock::now();
     std::time_t tt = system_clock::to_time_t(tp);
     auto ms = duration_cast<microseconds>(tp.time_since_epoch()) -
               duration_cast<seconds>(tp.time_since_epoch());
@@ -16,11 +16,13 @@
 #include <sdbusplus/server.hpp>
 #include <xyz/openbmc_project/Logging/Entry/server.hpp>
 
+#include <chrono>
 #include <deque>
 #include <exception>
 #include <filesystem>
 #include <iostream>
 #include <map>
+#include <span>
 #include <string>
 #include <variant>
 #include <vector>
@@ -124,6 +126,32 @@ struct CustomFD
  */
 uint8_t getNumPadBytes(uint32_t data);
 
+/** @brief Initial state for an incremental CRC32 computation */
+constexpr uint32_t crc32Init = 0xFFFFFFFF;
+
+/** @brief Feed data into an incremental CRC32 (ISO 3309, as used by PLDM)
+ *
+ *  Computing crc32Final(crc32Update(crc32Init, data, size)) yields the same
+ *  value as libpldm's crc32(data, size), but the intermediate state can be
+ *  saved and resumed, e.g. to checksum a table that is only appended to.
+ *
+ *  @param[in] state - CRC32 state returned by a previous call or crc32Init
+ *  @param[in] data - data to feed into the CRC
+ *  @param[in] size - length of data
+ *  @return - uint32_t - the updated CRC32 state
+ */
+uint32_t crc32Update(uint32_t state, const void* data, size_t size);
+
+/** @brief Convert an incremental CRC32 state into the CRC32 value
+ *
+ *  @param[in] state - CRC32 state
+ *  @return - uint32_t - CRC32 of all the data fed into state
+ */
+constexpr uint32_t crc32Final(uint32_t state)
+{
+    return state ^ 0xFFFFFFFF;
+}
+
 /** @brief Convert uint64 to date
  *
  *  @param[in] data - time date of uint64
@@ -435,7 +463,7 @@ int emitStateSensorEventSignal(uint8_t tid, uint16_t sensorId,
  *
  *  @return - None
  */
-void printBuffer(bool isTx, const std::vector<uint8_t>& buffer);
+void printBuffer(bool isTx, std::span<const uint8_t> buffer);
 
 /** @brief Convert the buffer to std::string
  *
@@ -467,6 +495,14 @@ std::vector<std::string> split(std::string_view srcStr, std::string_view delim,
  */
 std::string getCurrentSystemTime();
 
+/** @brief Format a system time in the format of getCurrentSystemTime()
+ *
+ *  @param[in] tp - system time
+ *
+ *  @return - std::string equivalent of the system time
+ */
+std::string formatSystemTime(std::chrono::system_clock::time_point tp);
+
 /** @brief checks if the FRU is actually present.
  *  @param[in] objPath - FRU object path.
  *
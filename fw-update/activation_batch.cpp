@@ -0,0 +1,73 @@
+#include "activation_batch.hpp"
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+void ActivationBatch::add(mctp_eid_t eid)
+{
+    expected.emplace(eid);
+}
+
+void ActivationBatch::applied(mctp_eid_t eid)
+{
+    if (expected.erase(eid))
+    {
+        ready.emplace(eid);
+        release();
+    }
+}
+
+void ActivationBatch::failed(mctp_eid_t eid)
+{
+    // A device failing after it applied, on activation, is already released
+    if (expected.erase(eid))
+    {
+        anyFailed = true;
+        release();
+    }
+}
+
+std::vector<mctp_eid_t> ActivationBatch::expire()
+{
+    std::vector<mctp_eid_t> dropped(expected.begin(), expected.end());
+    if (!dropped.empty())
+    {
+        expected.clear();
+        anyFailed = true;
+        release();
+    }
+    return dropped;
+}
+
+void ActivationBatch::clear()
+{
+    expected.clear();
+    ready.clear();
+    anyFailed = false;
+}
+
+void ActivationBatch::release()
+{
+    if (!expected.empty())
+    {
+        return;
+    }
+
+    bool selfContained = policy == SelfContainedActivation::Always ||
+                         (policy == SelfContainedActivation::AllApplied &&
+                          !anyFailed);
+    auto devices = std::move(ready);
+    ready.clear();
+    anyFailed = false;
+    for (auto eid : devices)
+    {
+        activate(eid, selfContained);
+    }
+}
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "common/types.hpp"
+
+#include <libpldm/base.h>
+
+#include <functional>
+#include <set>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @brief When the FDs are asked to activate their self-contained
+ *         components along with the ActivateFirmware command
+ */
+enum class SelfContainedActivation
+{
+    /** @brief Self-contained components wait for the next reset */
+    Never,
+    /** @brief Every FD that applied its components activates them */
+    Always,
+    /** @brief Only if every FD of the package applied its components, so a
+     *         partial update doesn't leave the FDs running mixed firmware
+     */
+    AllApplied,
+};
+
+/** @class ActivationBatch
+ *
+ *  @brief Holds the activation of the firmware devices of a package until
+ *         every device has applied its components or dropped out
+ *
+ *  The devices that applied their components are then activated together,
+ *  so the ActivateFirmware requests go out in parallel instead of trailing
+ *  the update of each device.
+ */
+class ActivationBatch
+{
+  public:
+    using Activate = std::function<void(mctp_eid_t eid, bool selfContained)>;
+
+    ActivationBatch() = delete;
+    ActivationBatch(const ActivationBatch&) = delete;
+    ActivationBatch(ActivationBatch&&) = delete;
+    ActivationBatch& operator=(const ActivationBatch&) = delete;
+    ActivationBatch& operator=(ActivationBatch&&) = delete;
+    ~ActivationBatch() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] policy - when self-contained activation is requested
+     *  @param[in] activate - sends ActivateFirmware to a device
+     */
+    ActivationBatch(SelfContainedActivation policy, Activate activate) :
+        policy(policy), activate(std::move(activate))
+    {}
+
+    /** @brief Expect a device to apply its components before the batch is
+     *         activated
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     */
+    void add(mctp_eid_t eid);
+
+    /** @brief A device applied all its components
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     */
+    void applied(mctp_eid_t eid);
+
+    /** @brief A device dropped out of the update, it isn't activated
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     */
+    void failed(mctp_eid_t eid);
+
+    /** @brief Stop waiting for the pending devices
+     *
+     *  The pending devices drop out as failed and the devices that applied
+     *  their components are activated.
+     *
+     *  @return the devices that dropped out, to abort their update
+     */
+    std::vector<mctp_eid_t> expire();
+
+    /** @brief Drop all the devices without activating them */
+    void clear();
+
+    /** @brief Number of devices the batch is waiting for */
+    size_t pending() const
+    {
+        return expected.size();
+    }
+
+  private:
+    /** @brief Activate the applied devices once none is pending */
+    void release();
+
+    SelfContainedActivation policy;
+    Activate activate;
+    std::set<mctp_eid_t> expected;
+    std::set<mctp_eid_t> ready;
+    bool anyFailed = false;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -7,6 +7,7 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <functional>
 
 PHOSPHOR_LOG2_USING;
@@ -17,12 +18,138 @@ namespace pldm
 namespace fw_update
 {
 
+uint64_t DeviceUpdater::getUpdateSize() const
+{
+    uint64_t updateSize = 0;
+    for (auto index : std::get<ApplicableComponents>(fwDeviceIDRecord))
+    {
+        updateSize += std::get<static_cast<size_t>(
+            ComponentImageInfoPos::CompSizePos)>(compImageInfos[index]);
+    }
+    return updateSize;
+}
+
+uint32_t DeviceUpdater::alignTransferSize(uint32_t maxTransferSize,
+                                          uint32_t mtu)
+{
+    // MCTP message type, PLDM header and completion code
+    constexpr uint32_t overhead = 1 + sizeof(pldm_msg_hdr) + 1;
+    if (!mtu)
+    {
+        return maxTransferSize;
+    }
+    uint64_t units = (uint64_t(maxTransferSize) + overhead) / mtu;
+    if (units * mtu < PLDM_FWUP_BASELINE_TRANSFER_SIZE + overhead)
+    {
+        return maxTransferSize;
+    }
+    return static_cast<uint32_t>(units * mtu - overhead);
+}
+
+void DeviceUpdater::resumeFrom(const UpdateCheckpoint& checkpoint)
+{
+    this->checkpoint = checkpoint;
+    savedOffset = checkpoint.offset;
+    if (!checkpoint.appliedComponents.empty())
+    {
+        info(
+            "Resuming the firmware update, EID={EID}, APPLIED={APPLIED}, COMPONENT_INDEX={COMP_INDEX}, OFFSET={OFFSET}",
+            "EID", unsigned(eid), "APPLIED",
+            checkpoint.appliedComponents.size(), "COMP_INDEX",
+            checkpoint.componentIndex, "OFFSET", checkpoint.offset);
+    }
+}
+
+size_t DeviceUpdater::nextComponent(size_t index) const
+{
+    const auto& applied = checkpoint.appliedComponents;
+    const auto& applicableComponents =
+        std::get<ApplicableComponents>(fwDeviceIDRecord);
+    while (index < applicableComponents.size() &&
+           std::find(applied.begin(), applied.end(), index) != applied.end())
+    {
+        index++;
+    }
+    return index;
+}
+
+void DeviceUpdater::saveCheckpoint()
+{
+    savedOffset = checkpoint.offset;
+    if (updateManager)
+    {
+        updateManager->checkpoints.store(eid, checkpoint);
+    }
+}
+
+void DeviceUpdater::abortUpdate()
+{
+    if (aborted)
+    {
+        return;
+    }
+    aborted = true;
+    error("Aborting the firmware update, EID={EID}", "EID", unsigned(eid));
+    updateManager->checkpoints.remove(eid);
+
+    // An FD the update flow wasn't started for isn't in update mode
+    if (transferStartTime != std::chrono::steady_clock::time_point{})
+    {
+        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+            updateManager->event,
+            std::bind(&DeviceUpdater::sendCancelUpdateRequest, this));
+    }
+    updateManager->updateDeviceCompletion(eid, false);
+}
+
+void DeviceUpdater::startTransfer()
+{
+    if (transferStartTime == std::chrono::steady_clock::time_point{})
+    {
+        startFwUpdateFlow();
+        return;
+    }
+    if (aborted)
+    {
+        return;
+    }
+    pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+        updateManager->event,
+        std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
+                  componentIndex));
+}
+
+void DeviceUpdater::activate(bool selfContained)
+{
+    if (aborted)
+    {
+        return;
+    }
+    pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+        updateManager->event,
+        std::bind(&DeviceUpdater::sendActivateFirmwareRequest, this,
+                  selfContained));
+}
+
 void DeviceUpdater::startFwUpdateFlow()
 {
+    if (aborted)
+    {
+        return;
+    }
+    transferStartTime = std::chrono::steady_clock::now();
     auto instanceId = updateManager->instanceIdDb.next(eid);
     // NumberOfComponents
     const auto& applicableComponents =
         std::get<ApplicableComponents>(fwDeviceIDRecord);
+    // Components applied before an interruption count as transferred
+    bytesTransferred = 0;
+    for (auto index : checkpoint.appliedComponents)
+    {
+        bytesTransferred +=
+            std::get<static_cast<size_t>(ComponentImageInfoPos::CompSizePos)>(
+                compImageInfos[applicableComponents[index]]);
+    }
     // PackageDataLength
     const auto& fwDevicePkgData =
         std::get<FirmwareDevicePackageData>(fwDeviceIDRecord);
@@ -51,7 +178,8 @@ void DeviceUpdater::startFwUpdateFlow()
         updateManager->instanceIdDb.free(eid, instanceId);
         error("encode_request_update_req failed, EID = {EID}, RC = {RC}", "EID",
               unsigned(eid), "RC", rc);
-        // Handle error scenario
+        abortUpdate();
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -61,7 +189,7 @@ void DeviceUpdater::startFwUpdateFlow()
     {
         error("Failed to send RequestUpdate request, EID = {EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
-        // Handle error scenario
+        abortUpdate();
     }
 }
 
@@ -70,9 +198,9 @@ void DeviceUpdater::requestUpdate(mctp_eid_t eid, const pldm_msg* response,
 {
     if (response == nullptr || !respMsgLen)
     {
-        // Handle error scenario
         error("No response received for RequestUpdate, EID = {EID}", "EID",
               unsigned(eid));
+        abortUpdate();
         return;
     }
 
@@ -86,6 +214,20 @@ void DeviceUpdater::requestUpdate(mctp_eid_t eid, const pldm_msg* response,
     {
         error("Decoding RequestUpdate response failed, EID = {EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
+        abortUpdate();
+        return;
+    }
+    if (completionCode == PLDM_FWUP_ALREADY_IN_UPDATE_MODE && !reentering)
+    {
+        // The FD is still in update mode from an interrupted update, leave it
+        // and start over. Cancelling may discard the applied components.
+        info("FD already in update mode, re-entering, EID = {EID}", "EID",
+             unsigned(eid));
+        reentering = true;
+        checkpoint.appliedComponents.clear();
+        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+            updateManager->event,
+            std::bind(&DeviceUpdater::sendCancelUpdateRequest, this));
         return;
     }
     if (completionCode)
@@ -93,6 +235,7 @@ void DeviceUpdater::requestUpdate(mctp_eid_t eid, const pldm_msg* response,
         error(
             "RequestUpdate response failed with error completion code, EID = {EID}, CC = {CC}",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        abortUpdate();
         return;
     }
 
@@ -173,7 +316,8 @@ void DeviceUpdater::sendPassCompTableRequest(size_t offset)
         updateManager->instanceIdDb.free(eid, instanceId);
         error("encode_pass_component_table_req failed, EID = {EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
-        // Handle error scenario
+        abortUpdate();
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -185,7 +329,7 @@ void DeviceUpdater::sendPassCompTableRequest(size_t offset)
         error(
             "Failed to send PassComponentTable request, EID = {EID}, RC = {RC}",
             "EID", unsigned(eid), "RC", rc);
-        // Handle error scenario
+        abortUpdate();
     }
 }
 
@@ -194,9 +338,9 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
 {
     if (response == nullptr || !respMsgLen)
     {
-        // Handle error scenario
         error("No response received for PassComponentTable, EID = {EID}", "EID",
               unsigned(eid));
+        abortUpdate();
         return;
     }
 
@@ -209,18 +353,18 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
                                                &compResponseCode);
     if (rc)
     {
-        // Handle error scenario
         error(
             "Decoding PassComponentTable response failed, EID={EID}, RC = {RC}",
             "EID", unsigned(eid), "RC", rc);
+        abortUpdate();
         return;
     }
     if (completionCode)
     {
-        // Handle error scenario
         error(
             "PassComponentTable response failed with error completion code, EID = {EID}, CC = {CC}",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        abortUpdate();
         return;
     }
     // Handle ComponentResponseCode
@@ -229,11 +373,21 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
         std::get<ApplicableComponents>(fwDeviceIDRecord);
     if (componentIndex == applicableComponents.size() - 1)
     {
-        componentIndex = 0;
-        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
-            updateManager->event,
-            std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
-                      componentIndex));
+        componentIndex = nextComponent(0);
+        if (componentIndex == applicableComponents.size())
+        {
+            // Every component was applied before the update was interrupted
+            componentIndex = 0;
+            updateManager->deviceTransferComplete(eid);
+            updateManager->deviceApplied(eid);
+        }
+        else
+        {
+            pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+                updateManager->event,
+                std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
+                          componentIndex));
+        }
     }
     else
     {
@@ -248,6 +402,12 @@ void DeviceUpdater::passCompTable(mctp_eid_t eid, const pldm_msg* response,
 void DeviceUpdater::sendUpdateComponentRequest(size_t offset)
 {
     pldmRequest.reset();
+    if (checkpoint.componentIndex != offset)
+    {
+        checkpoint.componentIndex = offset;
+        checkpoint.offset = 0;
+        saveCheckpoint();
+    }
 
     auto instanceId = updateManager->instanceIdDb.next(eid);
     const auto& applicableComponents =
@@ -300,7 +460,8 @@ void DeviceUpdater::sendUpdateComponentRequest(size_t offset)
         updateManager->instanceIdDb.free(eid, instanceId);
         error("encode_update_component_req failed, EID={EID}, RC = {RC}", "EID",
               unsigned(eid), "RC", rc);
-        // Handle error scenario
+        abortUpdate();
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -310,7 +471,7 @@ void DeviceUpdater::sendUpdateComponentRequest(size_t offset)
     {
         error("Failed to send UpdateComponent request, EID={EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
-        // Handle error scenario
+        abortUpdate();
     }
 }
 
@@ -319,9 +480,9 @@ void DeviceUpdater::updateComponent(mctp_eid_t eid, const pldm_msg* response,
 {
     if (response == nullptr || !respMsgLen)
     {
-        // Handle error scenario
         error("No response received for updateComponent, EID={EID}", "EID",
               unsigned(eid));
+        abortUpdate();
         return;
     }
 
@@ -339,6 +500,7 @@ void DeviceUpdater::updateComponent(mctp_eid_t eid, const pldm_msg* response,
     {
         error("Decoding UpdateComponent response failed, EID={EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
+        abortUpdate();
         return;
     }
     if (completionCode)
@@ -346,8 +508,17 @@ void DeviceUpdater::updateComponent(mctp_eid_t eid, const pldm_msg* response,
         error(
             "UpdateComponent response failed with error completion code, EID = {EID}, CC = {CC}",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        abortUpdate();
         return;
     }
+
+    // FDs request the component from its start with the length they used
+    // before, read that chunk while the FD prepares for the transfer
+    auto length = updateManager->requestLengths.find(eid);
+    if (length != updateManager->requestLengths.end())
+    {
+        schedulePrefetch(0, length->second);
+    }
 }
 
 Response DeviceUpdater::requestFwData(const pldm_msg* request,
@@ -358,6 +529,20 @@ Response DeviceUpdater::requestFwData(const pldm_msg* request,
     uint32_t length = 0;
     Response response(sizeof(pldm_msg_hdr) + sizeof(completionCode), 0);
     auto responseMsg = reinterpret_cast<pldm_msg*>(response.data());
+    if (aborted)
+    {
+        auto rc = encode_request_firmware_data_resp(
+            request->hdr.instance_id, PLDM_FWUP_CANCEL_PENDING, responseMsg,
+            sizeof(completionCode));
+        if (rc)
+        {
+            error(
+                "Encoding RequestFirmwareData response failed, EID={EID}, RC = {RC}",
+                "EID", unsigned(eid), "RC", rc);
+        }
+        return response;
+    }
+
     auto rc = decode_request_firmware_data_req(request, payloadLength, &offset,
                                                &length);
     if (rc)
@@ -382,8 +567,6 @@ Response DeviceUpdater::requestFwData(const pldm_msg* request,
     const auto& comp = compImageInfos[applicableComponents[componentIndex]];
     auto compOffset = std::get<5>(comp);
     auto compSize = std::get<6>(comp);
-    error("offset = {OFFSET}, length = {LEN}", "OFFSET", unsigned(offset),
-          "LEN", unsigned(length));
     if (length < PLDM_FWUP_BASELINE_TRANSFER_SIZE || length > maxTransferSize)
     {
         rc = encode_request_firmware_data_resp(
@@ -418,13 +601,29 @@ Response DeviceUpdater::requestFwData(const pldm_msg* request,
         padBytes = offset + length - compSize;
     }
 
-    response.resize(sizeof(pldm_msg_hdr) + sizeof(completionCode) + length);
+    // The chunk read ahead after the previous response is used if the FD
+    // asked for it, otherwise the component bytes are appended straight from
+    // the mapped package. The padding past the end of the component is zero
+    // filled.
+    size_t dataSize = length - padBytes;
+    if (prefetchedComponent == componentIndex && prefetchedOffset == offset &&
+        prefetched.size() ==
+            sizeof(pldm_msg_hdr) + sizeof(completionCode) + length)
+    {
+        response = std::move(prefetched);
+        prefetched.clear();
+        prefetchHits++;
+    }
+    else
+    {
+        auto data = package->read(compOffset + offset, dataSize);
+        response.reserve(sizeof(pldm_msg_hdr) + sizeof(completionCode) +
+                         length);
+        response.insert(response.end(), data.begin(), data.end());
+        response.resize(sizeof(pldm_msg_hdr) + sizeof(completionCode) +
+                        length);
+    }
     responseMsg = reinterpret_cast<pldm_msg*>(response.data());
-    package.seekg(compOffset + offset);
-    package.read(reinterpret_cast<char*>(response.data() +
-                                         sizeof(pldm_msg_hdr) +
-                                         sizeof(completionCode)),
-                 length - padBytes);
     rc = encode_request_firmware_data_resp(request->hdr.instance_id,
                                            completionCode, responseMsg,
                                            sizeof(completionCode));
@@ -436,9 +635,74 @@ Response DeviceUpdater::requestFwData(const pldm_msg* request,
         return response;
     }
 
+    chunks++;
+    bytesTransferred += dataSize;
+    if (offset <= checkpoint.offset && offset + dataSize > checkpoint.offset)
+    {
+        checkpoint.offset = offset + dataSize;
+        if (checkpoint.offset - savedOffset >= CheckpointStore::interval)
+        {
+            saveCheckpoint();
+        }
+    }
+    if (updateManager)
+    {
+        updateManager->updateDeviceProgress(eid, bytesTransferred,
+                                            getUpdateSize());
+        // FDs pull the component sequentially with a fixed length, so the
+        // next request is expected right after this one
+        if (!padBytes)
+        {
+            updateManager->requestLengths[eid] = length;
+            if (offset + length < compSize)
+            {
+                schedulePrefetch(offset + length, length);
+            }
+        }
+    }
+
     return response;
 }
 
+void DeviceUpdater::schedulePrefetch(uint32_t offset, uint32_t length)
+{
+    prefetchRequest = std::make_unique<sdeventplus::source::Defer>(
+        updateManager->event,
+        std::bind(&DeviceUpdater::prefetch, this, offset, length));
+}
+
+void DeviceUpdater::prefetch(uint32_t offset, uint32_t length)
+{
+    prefetchRequest.reset();
+    prefetched.clear();
+    if (aborted || length < PLDM_FWUP_BASELINE_TRANSFER_SIZE ||
+        length > maxTransferSize)
+    {
+        return;
+    }
+
+    const auto& applicableComponents =
+        std::get<ApplicableComponents>(fwDeviceIDRecord);
+    const auto& comp = compImageInfos[applicableComponents[componentIndex]];
+    auto compOffset = std::get<5>(comp);
+    auto compSize = std::get<6>(comp);
+    if (offset >= compSize ||
+        offset + length > compSize + PLDM_FWUP_BASELINE_TRANSFER_SIZE)
+    {
+        return;
+    }
+
+    constexpr auto dataOffset = sizeof(pldm_msg_hdr) + sizeof(uint8_t);
+    auto data = package->read(compOffset + offset,
+                              std::min(length, compSize - offset));
+    prefetched.reserve(dataOffset + length);
+    prefetched.resize(dataOffset);
+    prefetched.insert(prefetched.end(), data.begin(), data.end());
+    prefetched.resize(dataOffset + length);
+    prefetchedComponent = componentIndex;
+    prefetchedOffset = offset;
+}
+
 Response DeviceUpdater::transferComplete(const pldm_msg* request,
                                          size_t payloadLength)
 {
@@ -493,6 +757,31 @@ Response DeviceUpdater::transferComplete(const pldm_msg* request,
         return response;
     }
 
+    // A failed transfer ends the update of the FD, so the other FDs of the
+    // package aren't held back from activation
+    if (transferResult != PLDM_FWUP_TRANSFER_SUCCESS)
+    {
+        abortUpdate();
+        return response;
+    }
+
+    // The route slot is freed for the next FD while this one verifies and
+    // applies the component
+    updateManager->deviceTransferComplete(eid);
+    if (nextComponent(componentIndex + 1) == applicableComponents.size())
+    {
+        auto duration = std::chrono::duration<double>(
+                            std::chrono::steady_clock::now() -
+                            transferStartTime)
+                            .count();
+        info(
+            "Firmware transfer complete, EID={EID}, BYTES={BYTES}, CHUNKS={CHUNKS}, PREFETCHED={PREFETCHED}, DURATION={DURATION}s, THROUGHPUT={THROUGHPUT}B/s",
+            "EID", unsigned(eid), "BYTES", bytesTransferred, "CHUNKS", chunks,
+            "PREFETCHED", prefetchHits, "DURATION", duration, "THROUGHPUT",
+            duration > 0 ? static_cast<uint64_t>(bytesTransferred / duration)
+                         : 0);
+    }
+
     return response;
 }
 
@@ -590,6 +879,8 @@ Response DeviceUpdater::applyComplete(const pldm_msg* request,
         info(
             "Component apply complete, EID = {EID}, COMPONENT_VERSION = {COMP_VERS}",
             "EID", unsigned(eid), "COMP_VERS", compVersion);
+        checkpoint.appliedComponents.push_back(componentIndex);
+        saveCheckpoint();
         updateManager->updateActivationProgress();
     }
     else
@@ -609,41 +900,45 @@ Response DeviceUpdater::applyComplete(const pldm_msg* request,
         return response;
     }
 
-    if (componentIndex == applicableComponents.size() - 1)
+    // The FD is activated along with the other FDs of the package, the next
+    // component waits for a transfer slot on the route of the FD
+    auto next = nextComponent(componentIndex + 1);
+    if (next == applicableComponents.size())
     {
         componentIndex = 0;
-        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
-            updateManager->event,
-            std::bind(&DeviceUpdater::sendActivateFirmwareRequest, this));
+        updateManager->deviceApplied(eid);
     }
     else
     {
-        componentIndex++;
-        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
-            updateManager->event,
-            std::bind(&DeviceUpdater::sendUpdateComponentRequest, this,
-                      componentIndex));
+        componentIndex = next;
+        updateManager->requestTransferSlot(eid);
     }
 
     return response;
 }
 
-void DeviceUpdater::sendActivateFirmwareRequest()
+void DeviceUpdater::sendActivateFirmwareRequest(bool selfContained)
 {
     pldmRequest.reset();
+    info("Activating firmware, EID={EID}, SELF_CONTAINED={SELF_CONTAINED}",
+         "EID", unsigned(eid), "SELF_CONTAINED", selfContained);
     auto instanceId = updateManager->instanceIdDb.next(eid);
     Request request(sizeof(pldm_msg_hdr) +
                     sizeof(struct pldm_activate_firmware_req));
     auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
 
     auto rc = encode_activate_firmware_req(
-        instanceId, PLDM_NOT_ACTIVATE_SELF_CONTAINED_COMPONENTS, requestMsg,
-        sizeof(pldm_activate_firmware_req));
+        instanceId,
+        selfContained ? PLDM_ACTIVATE_SELF_CONTAINED_COMPONENTS
+                      : PLDM_NOT_ACTIVATE_SELF_CONTAINED_COMPONENTS,
+        requestMsg, sizeof(pldm_activate_firmware_req));
     if (rc)
     {
         updateManager->instanceIdDb.free(eid, instanceId);
         error("encode_activate_firmware_req failed, EID={EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
+        updateManager->updateDeviceCompletion(eid, false);
+        return;
     }
 
     rc = updateManager->handler.registerRequest(
@@ -653,6 +948,7 @@ void DeviceUpdater::sendActivateFirmwareRequest()
     {
         error("Failed to send ActivateFirmware request, EID={EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
+        updateManager->updateDeviceCompletion(eid, false);
     }
 }
 
@@ -661,9 +957,9 @@ void DeviceUpdater::activateFirmware(mctp_eid_t eid, const pldm_msg* response,
 {
     if (response == nullptr || !respMsgLen)
     {
-        // Handle error scenario
         error("No response received for ActivateFirmware, EID={EID}", "EID",
               unsigned(eid));
+        updateManager->updateDeviceCompletion(eid, false);
         return;
     }
 
@@ -674,23 +970,114 @@ void DeviceUpdater::activateFirmware(mctp_eid_t eid, const pldm_msg* response,
         response, respMsgLen, &completionCode, &estimatedTimeForActivation);
     if (rc)
     {
-        // Handle error scenario
         error("Decoding ActivateFirmware response failed, EID={EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
+        updateManager->updateDeviceCompletion(eid, false);
         return;
     }
     if (completionCode)
     {
-        // Handle error scenario
         error(
             "ActivateFirmware response failed with error completion code, EID = {EID}, CC = {CC}",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        updateManager->updateDeviceCompletion(eid, false);
         return;
     }
 
     updateManager->updateDeviceCompletion(eid, true);
 }
 
+void DeviceUpdater::sendCancelUpdateRequest()
+{
+    pldmRequest.reset();
+    auto instanceId = updateManager->instanceIdDb.next(eid);
+    Request request(sizeof(pldm_msg_hdr) + PLDM_CANCEL_UPDATE_REQ_BYTES);
+    auto requestMsg = reinterpret_cast<pldm_msg*>(request.data());
+
+    auto rc = encode_cancel_update_req(instanceId, requestMsg,
+                                       PLDM_CANCEL_UPDATE_REQ_BYTES);
+    if (rc)
+    {
+        updateManager->instanceIdDb.free(eid, instanceId);
+        error("encode_cancel_update_req failed, EID={EID}, RC = {RC}", "EID",
+              unsigned(eid), "RC", rc);
+        cancelFailed();
+        return;
+    }
+
+    rc = updateManager->handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_CANCEL_UPDATE, std::move(request),
+        std::move(std::bind_front(&DeviceUpdater::cancelUpdate, this)));
+    if (rc)
+    {
+        error("Failed to send CancelUpdate request, EID={EID}, RC = {RC}",
+              "EID", unsigned(eid), "RC", rc);
+        cancelFailed();
+    }
+}
+
+void DeviceUpdater::cancelFailed()
+{
+    // An FD found in update mode can't start over, its update fails. The
+    // CancelUpdate of an aborted update is already reported as failed.
+    if (reentering && !aborted)
+    {
+        aborted = true;
+        updateManager->checkpoints.remove(eid);
+        updateManager->updateDeviceCompletion(eid, false);
+    }
+}
+
+void DeviceUpdater::cancelUpdate(mctp_eid_t eid, const pldm_msg* response,
+                                 size_t respMsgLen)
+{
+    if (response == nullptr || !respMsgLen)
+    {
+        error("No response received for CancelUpdate, EID={EID}", "EID",
+              unsigned(eid));
+        cancelFailed();
+        return;
+    }
+
+    uint8_t completionCode = 0;
+    bool8_t nonFunctioningComponentIndication = 0;
+    bitfield64_t nonFunctioningComponentBitmap{};
+    auto rc = decode_cancel_update_resp(response, respMsgLen, &completionCode,
+                                        &nonFunctioningComponentIndication,
+                                        &nonFunctioningComponentBitmap);
+    if (rc)
+    {
+        error("Decoding CancelUpdate response failed, EID={EID}, RC = {RC}",
+              "EID", unsigned(eid), "RC", rc);
+        cancelFailed();
+        return;
+    }
+    if (completionCode)
+    {
+        error(
+            "CancelUpdate response failed with error completion code, EID = {EID}, CC = {CC}",
+            "EID", unsigned(eid), "CC", unsigned(completionCode));
+        cancelFailed();
+        return;
+    }
+    if (nonFunctioningComponentIndication)
+    {
+        error(
+            "Firmware update cancelled with non functioning components, EID={EID}, COMPONENTS={COMPONENTS}",
+            "EID", unsigned(eid), "COMPONENTS",
+            nonFunctioningComponentBitmap.value);
+    }
+
+    if (reentering && !aborted)
+    {
+        pldmRequest = std::make_unique<sdeventplus::source::Defer>(
+            updateManager->event, [this](sdeventplus::source::EventBase&) {
+            pldmRequest.reset();
+            startFwUpdateFlow();
+        });
+    }
+}
+
 } // namespace fw_update
 
 } // namespace pldm
@@ -1,13 +1,16 @@
 #pragma once
 
 #include "common/types.hpp"
+#include "package_image.hpp"
+#include "update_checkpoint.hpp"
 #include "requester/handler.hpp"
 #include "requester/request.hpp"
 
 #include <sdeventplus/event.hpp>
 #include <sdeventplus/source/event.hpp>
 
-#include <fstream>
+#include <chrono>
+#include <memory>
 
 namespace pldm
 {
@@ -35,7 +38,7 @@ class DeviceUpdater
     /** @brief Constructor
      *
      *  @param[in] eid - Endpoint ID of the firmware device
-     *  @param[in] package - File stream for firmware update package
+     *  @param[in] package - Mapped firmware update package
      *  @param[in] fwDeviceIDRecord - FirmwareDeviceIDRecord in the fw update
      *                                package that matches this firmware device
      *  @param[in] compImageInfos - Component image information for all the
@@ -47,14 +50,15 @@ class DeviceUpdater
      *  @param[in] updateManager - To update the status of fw update of the
      *                             device
      */
-    explicit DeviceUpdater(mctp_eid_t eid, std::ifstream& package,
+    explicit DeviceUpdater(mctp_eid_t eid,
+                           std::shared_ptr<const PackageImage> package,
                            const FirmwareDeviceIDRecord& fwDeviceIDRecord,
                            const ComponentImageInfos& compImageInfos,
                            const ComponentInfo& compInfo,
                            uint32_t maxTransferSize,
                            UpdateManager* updateManager) :
         eid(eid),
-        package(package), fwDeviceIDRecord(fwDeviceIDRecord),
+        package(std::move(package)), fwDeviceIDRecord(fwDeviceIDRecord),
         compImageInfos(compImageInfos), compInfo(compInfo),
         maxTransferSize(maxTransferSize), updateManager(updateManager)
     {}
@@ -66,6 +70,60 @@ class DeviceUpdater
      */
     void startFwUpdateFlow();
 
+    /** @brief Start transferring the next component to the FD
+     *
+     *  Called when the FD gets a transfer slot on its route. The update flow
+     *  is started for the first component, the following components are
+     *  sent with UpdateComponent once the previous one is applied.
+     */
+    void startTransfer();
+
+    /** @brief Send ActivateFirmware to the FD, once every FD of the package
+     *         has applied its components
+     *
+     *  @param[in] selfContained - request the activation of the
+     *                             self-contained components
+     */
+    void activate(bool selfContained);
+
+    /** @brief Total size in bytes of the components to send to the FD */
+    uint64_t getUpdateSize() const;
+
+    /** @brief Align the MaximumTransferSize offered to the FDs to the
+     *         transport MTU
+     *
+     *  A RequestFirmwareData response carries the MCTP message type, the PLDM
+     *  header and the completion code ahead of the data. The size returned is
+     *  the largest one not above maxTransferSize whose response fills whole
+     *  transmission units, so that a full chunk isn't followed by a packet
+     *  with a few bytes in it.
+     *
+     *  @param[in] maxTransferSize - largest transfer size allowed
+     *  @param[in] mtu - transmission unit of the transport, 0 if unknown
+     *
+     *  @return the aligned transfer size, maxTransferSize if no aligned size
+     *          is at least the baseline transfer size
+     */
+    static uint32_t alignTransferSize(uint32_t maxTransferSize, uint32_t mtu);
+
+    /** @brief Set the checkpoint the update of the FD starts from
+     *
+     *  Components the checkpoint lists as applied are not updated again.
+     *
+     *  @param[in] checkpoint - progress of an interrupted update of the FD
+     *                          with the same package, or an empty checkpoint
+     *                          naming the package
+     */
+    void resumeFrom(const UpdateCheckpoint& checkpoint);
+
+    /** @brief Abort the update of the FD
+     *
+     *  CancelUpdate is sent to the FD, further firmware data requests are
+     *  refused and the update of the FD is reported as failed, so it no
+     *  longer holds back the activation of the other FDs of the package.
+     */
+    void abortUpdate();
+
     /** @brief Handler for RequestUpdate command response
      *
      *  The response of the RequestUpdate is processed and if the response
@@ -154,6 +212,15 @@ class DeviceUpdater
     void activateFirmware(mctp_eid_t eid, const pldm_msg* response,
                           size_t respMsgLen);
 
+    /** @brief Handler for CancelUpdate command response
+     *
+     *  @param[in] eid - Remote MCTP endpoint
+     *  @param[in] response - PLDM response message
+     *  @param[in] respMsgLen - Response message length
+     */
+    void cancelUpdate(mctp_eid_t eid, const pldm_msg* response,
+                      size_t respMsgLen);
+
   private:
     /** @brief Send PassComponentTable command request
      *
@@ -167,14 +234,56 @@ class DeviceUpdater
      */
     void sendUpdateComponentRequest(size_t offset);
 
-    /** @brief Send ActivateFirmware command request */
-    void sendActivateFirmwareRequest();
+    /** @brief Send ActivateFirmware command request
+     *
+     *  @param[in] selfContained - request the activation of the
+     *                             self-contained components
+     */
+    void sendActivateFirmwareRequest(bool selfContained);
+
+    /** @brief Send CancelUpdate command request */
+    void sendCancelUpdateRequest();
+
+    /** @brief Fail the update of an FD that couldn't be taken out of update
+     *         mode
+     */
+    void cancelFailed();
+
+    /** @brief Index of the first component from index on that isn't applied
+     *
+     *  @param[in] index - index in ApplicableComponents
+     *
+     *  @return the index, or the number of applicable components if all the
+     *          remaining components are applied
+     */
+    size_t nextComponent(size_t index) const;
+
+    /** @brief Persist the progress of the update of the FD */
+    void saveCheckpoint();
+
+    /** @brief Read the chunk the FD is expected to request next, once the
+     *         current response is sent
+     *
+     *  @param[in] offset - offset in the component of the chunk
+     *  @param[in] length - length of the chunk
+     */
+    void schedulePrefetch(uint32_t offset, uint32_t length);
+
+    /** @brief Build the RequestFirmwareData response data for a chunk of the
+     *         component in transfer, the header is encoded when it is sent
+     *
+     *  @param[in] offset - offset in the component of the chunk
+     *  @param[in] length - length of the chunk
+     */
+    void prefetch(uint32_t offset, uint32_t length);
 
     /** @brief Endpoint ID of the firmware device */
     mctp_eid_t eid;
 
-    /** @brief File stream for firmware update package */
-    std::ifstream& package;
+    /** @brief Mapped firmware update package, read without a stream
+     *         position so it can be shared with other DeviceUpdaters
+     */
+    std::shared_ptr<const PackageImage> package;
 
     /** @brief FirmwareDeviceIDRecord in the fw update package that matches this
      *         firmware device
@@ -208,6 +317,42 @@ class DeviceUpdater
 
     /** @brief To send a PLDM request after the current command handling */
     std::unique_ptr<sdeventplus::source::Defer> pldmRequest;
+
+    /** @brief Component bytes sent to the FD, to report progress */
+    uint64_t bytesTransferred = 0;
+
+    /** @brief Time the update of the FD started, to report throughput */
+    std::chrono::steady_clock::time_point transferStartTime;
+
+    /** @brief The update of the FD was aborted */
+    bool aborted = false;
+
+    /** @brief The FD was found in update mode and is being taken out of it
+     *         to start over
+     */
+    bool reentering = false;
+
+    /** @brief Progress of the update of the FD */
+    UpdateCheckpoint checkpoint;
+
+    /** @brief Component offset of the last persisted checkpoint */
+    uint32_t savedOffset = 0;
+
+    /** @brief To read ahead the next chunk after the current response */
+    std::unique_ptr<sdeventplus::source::Defer> prefetchRequest;
+
+    /** @brief Response to the RequestFirmwareData expected next */
+    Response prefetched;
+
+    /** @brief Component and offset of the prefetched chunk */
+    size_t prefetchedComponent = 0;
+    uint32_t prefetchedOffset = 0;
+
+    /** @brief RequestFirmwareData requests served, and how many of them were
+     *         prefetched
+     */
+    uint64_t chunks = 0;
+    uint64_t prefetchHits = 0;
 };
 
 } // namespace fw_update
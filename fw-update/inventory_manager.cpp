@@ -7,6 +7,7 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <functional>
 
 PHOSPHOR_LOG2_USING;
@@ -15,39 +16,104 @@ namespace pldm
 {
 namespace fw_update
 {
-void InventoryManager::discoverFDs(const std::vector<mctp_eid_t>& eids)
+void InventoryManager::discoverFDs(const std::vector<mctp_eid_t>& eids,
+                                   const EndpointUUIDs& uuids)
 {
     for (const auto& eid : eids)
     {
-        auto instanceId = instanceIdDb.next(eid);
-        Request requestMsg(sizeof(pldm_msg_hdr) +
-                           PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES);
-        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
-        auto rc = encode_query_device_identifiers_req(
-            instanceId, PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES, request);
-        if (rc)
+        if (discoveriesInFlight.contains(eid) ||
+            std::find(discoveryQueue.begin(), discoveryQueue.end(), eid) !=
+                discoveryQueue.end())
         {
-            instanceIdDb.free(eid, instanceId);
-            error(
-                "encode_query_device_identifiers_req failed, EID={EID}, RC = {RC}",
-                "EID", unsigned(eid), "RC", rc);
             continue;
         }
 
-        rc = handler.registerRequest(
-            eid, instanceId, PLDM_FWUP, PLDM_QUERY_DEVICE_IDENTIFIERS,
-            std::move(requestMsg),
-            std::move(std::bind_front(&InventoryManager::queryDeviceIdentifiers,
-                                      this)));
-        if (rc)
+        auto uuid = uuids.find(eid);
+        EndpointUUID endpointUUID =
+            uuid != uuids.end() ? uuid->second : EndpointUUID{};
+        auto cached = inventoriedUUIDs.find(eid);
+        if (cached != inventoriedUUIDs.end() && !endpointUUID.empty() &&
+            cached->second == endpointUUID)
         {
-            error(
-                "Failed to send QueryDeviceIdentifiers request, EID={EID}, RC = {RC}",
-                "EID", unsigned(eid), "RC", rc);
+            info("Using the cached firmware inventory, EID={EID}, UUID={UUID}",
+                 "EID", unsigned(eid), "UUID", endpointUUID);
+            continue;
+        }
+
+        inventoriedUUIDs.erase(eid);
+        discoveryUUIDs.insert_or_assign(eid, std::move(endpointUUID));
+        discoveryQueue.push_back(eid);
+    }
+
+    startDiscoveries();
+}
+
+void InventoryManager::startDiscoveries()
+{
+    while (discoveriesInFlight.size() < maxConcurrentDiscovery &&
+           !discoveryQueue.empty())
+    {
+        auto eid = discoveryQueue.front();
+        discoveryQueue.pop_front();
+        if (sendQueryDeviceIdentifiersRequest(eid))
+        {
+            discoveriesInFlight.insert(eid);
+        }
+        else
+        {
+            discoveryUUIDs.erase(eid);
         }
     }
 }
 
+void InventoryManager::discoveryDone(mctp_eid_t eid, bool success)
+{
+    if (!discoveriesInFlight.erase(eid))
+    {
+        return;
+    }
+
+    // Without a UUID the FD can't be recognised, so it isn't cached
+    auto uuid = discoveryUUIDs.extract(eid);
+    if (success && !uuid.empty() && !uuid.mapped().empty())
+    {
+        inventoriedUUIDs.insert_or_assign(eid, std::move(uuid.mapped()));
+    }
+    startDiscoveries();
+}
+
+bool InventoryManager::sendQueryDeviceIdentifiersRequest(mctp_eid_t eid)
+{
+    auto instanceId = instanceIdDb.next(eid);
+    Request requestMsg(sizeof(pldm_msg_hdr) +
+                       PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES);
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    auto rc = encode_query_device_identifiers_req(
+        instanceId, PLDM_QUERY_DEVICE_IDENTIFIERS_REQ_BYTES, request);
+    if (rc)
+    {
+        instanceIdDb.free(eid, instanceId);
+        error(
+            "encode_query_device_identifiers_req failed, EID={EID}, RC = {RC}",
+            "EID", unsigned(eid), "RC", rc);
+        return false;
+    }
+
+    rc = handler.registerRequest(
+        eid, instanceId, PLDM_FWUP, PLDM_QUERY_DEVICE_IDENTIFIERS,
+        std::move(requestMsg),
+        std::move(
+            std::bind_front(&InventoryManager::queryDeviceIdentifiers, this)));
+    if (rc)
+    {
+        error(
+            "Failed to send QueryDeviceIdentifiers request, EID={EID}, RC = {RC}",
+            "EID", unsigned(eid), "RC", rc);
+        return false;
+    }
+    return true;
+}
+
 void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
                                               const pldm_msg* response,
                                               size_t respMsgLen)
@@ -56,6 +122,7 @@ void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
     {
         error("No response received for QueryDeviceIdentifiers, EID={EID}",
               "EID", unsigned(eid));
+        discoveryDone(eid, false);
         return;
     }
 
@@ -72,6 +139,7 @@ void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
         error(
             "Decoding QueryDeviceIdentifiers response failed, EID={EID}, RC = {RC}",
             "EID", unsigned(eid), "RC", rc);
+        discoveryDone(eid, false);
         return;
     }
 
@@ -80,6 +148,7 @@ void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
         error(
             "QueryDeviceIdentifiers response failed with error completion code, EID={EID}, CC = {CC}",
             "EID", unsigned(eid), "CC", unsigned(completionCode));
+        discoveryDone(eid, false);
         return;
     }
 
@@ -97,6 +166,7 @@ void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
             error(
                 "Decoding descriptor type, length and value failed, EID={EID}, RC = {RC}",
                 "EID", unsigned(eid), "RC", rc);
+            discoveryDone(eid, false);
             return;
         }
 
@@ -121,6 +191,7 @@ void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
                 error(
                     "Decoding Vendor-defined descriptor value failed, EID={EID}, RC = {RC}",
                     "EID", unsigned(eid), "RC", rc);
+                discoveryDone(eid, false);
                 return;
             }
 
@@ -142,7 +213,7 @@ void InventoryManager::queryDeviceIdentifiers(mctp_eid_t eid,
         deviceIdentifiersLen -= nextDescriptorOffset;
     }
 
-    descriptorMap.emplace(eid, std::move(descriptors));
+    descriptorMap.insert_or_assign(eid, std::move(descriptors));
 
     // Send GetFirmwareParameters request
     sendGetFirmwareParametersRequest(eid);
@@ -161,6 +232,7 @@ void InventoryManager::sendGetFirmwareParametersRequest(mctp_eid_t eid)
         instanceIdDb.free(eid, instanceId);
         error("encode_get_firmware_parameters_req failed, EID={EID}, RC = {RC}",
               "EID", unsigned(eid), "RC", rc);
+        discoveryDone(eid, false);
         return;
     }
 
@@ -174,6 +246,7 @@ void InventoryManager::sendGetFirmwareParametersRequest(mctp_eid_t eid)
         error(
             "Failed to send GetFirmwareParameters request, EID={EID}, RC = {RC}",
             "EID", unsigned(eid), "RC", rc);
+        discoveryDone(eid, false);
     }
 }
 
@@ -186,6 +259,7 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
         error("No response received for GetFirmwareParameters, EID={EID}",
               "EID", unsigned(eid));
         descriptorMap.erase(eid);
+        discoveryDone(eid, false);
         return;
     }
 
@@ -202,6 +276,7 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
         error(
             "Decoding GetFirmwareParameters response failed, EID={EID}, RC = {RC}",
             "EID", unsigned(eid), "RC", rc);
+        discoveryDone(eid, false);
         return;
     }
 
@@ -210,6 +285,7 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
         error(
             "GetFirmwareParameters response failed with error completion code, EID={EID}, CC = {CC}",
             "EID", unsigned(eid), "CC", unsigned(fwParams.completion_code));
+        discoveryDone(eid, false);
         return;
     }
 
@@ -220,6 +296,7 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
     variable_field pendingCompVerStr{};
 
     ComponentInfo componentInfo{};
+    PendingCompVersions pendingCompVersions{};
     while (fwParams.comp_count-- && (compParamTableLen > 0))
     {
         auto rc = decode_get_firmware_parameters_resp_comp_entry(
@@ -230,6 +307,7 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
             error(
                 "Decoding component parameter table entry failed, EID={EID}, RC = {RC}",
                 "EID", unsigned(eid), "RC", rc);
+            discoveryDone(eid, false);
             return;
         }
 
@@ -238,12 +316,22 @@ void InventoryManager::getFirmwareParameters(mctp_eid_t eid,
         componentInfo.emplace(
             std::make_pair(compClassification, compIdentifier),
             compEntry.comp_classification_index);
+        if (pendingCompVerStr.length)
+        {
+            pendingCompVersions.emplace(
+                std::make_pair(compClassification, compIdentifier),
+                std::string(
+                    reinterpret_cast<const char*>(pendingCompVerStr.ptr),
+                    pendingCompVerStr.length));
+        }
         compParamPtr += sizeof(pldm_component_parameter_entry) +
                         activeCompVerStr.length + pendingCompVerStr.length;
         compParamTableLen -= sizeof(pldm_component_parameter_entry) +
                              activeCompVerStr.length + pendingCompVerStr.length;
     }
-    componentInfoMap.emplace(eid, std::move(componentInfo));
+    componentInfoMap.insert_or_assign(eid, std::move(componentInfo));
+    pendingCompVersionMap.insert_or_assign(eid, std::move(pendingCompVersions));
+    discoveryDone(eid, true);
 }
 
 } // namespace fw_update
@@ -4,6 +4,11 @@
 #include "common/types.hpp"
 #include "requester/handler.hpp"
 
+#include <algorithm>
+#include <deque>
+#include <unordered_map>
+#include <unordered_set>
+
 namespace pldm
 {
 
@@ -17,6 +22,10 @@ namespace fw_update
  *  details of the FD. Firmware identifiers, component details and update
  *  capabilities of FD are populated by the InventoryManager and is used for the
  *  firmware update of the FDs.
+ *
+ *  The inventory of an FD is cached, keyed by its EID and UUID, and is only
+ *  queried again when the FD is new, reports another UUID or was
+ *  invalidated. At most maxConcurrentDiscovery FDs are queried at once.
  */
 class InventoryManager
 {
@@ -36,25 +45,48 @@ class InventoryManager
      *                              FDs managed by the BMC.
      *  @param[out] componentInfoMap - Populate the component info for the FDs
      *                                 managed by the BMC.
+     *  @param[out] pendingCompVersionMap - Populate the versions of the
+     *                                      components pending activation on
+     *                                      the FDs
+     *  @param[in] maxConcurrentDiscovery - Maximum number of FDs queried at
+     *                                      once
      */
     explicit InventoryManager(
         pldm::requester::Handler<pldm::requester::Request>& handler,
         InstanceIdDb& instanceIdDb, DescriptorMap& descriptorMap,
-        ComponentInfoMap& componentInfoMap) :
+        ComponentInfoMap& componentInfoMap,
+        PendingCompVersionMap& pendingCompVersionMap,
+        size_t maxConcurrentDiscovery = FW_INVENTORY_MAX_CONCURRENT) :
         handler(handler),
         instanceIdDb(instanceIdDb), descriptorMap(descriptorMap),
-        componentInfoMap(componentInfoMap)
+        componentInfoMap(componentInfoMap),
+        pendingCompVersionMap(pendingCompVersionMap),
+        maxConcurrentDiscovery(std::max<size_t>(maxConcurrentDiscovery, 1))
     {}
 
     /** @brief Discover the firmware identifiers and component details of FDs
      *
      *  Inventory commands QueryDeviceIdentifiers and GetFirmwareParmeters
-     *  commands are sent to every FD and the response is used to populate
-     *  the firmware identifiers and component details of the FDs.
+     *  commands are sent to the FDs whose inventory isn't cached and the
+     *  response is used to populate the firmware identifiers and component
+     *  details of the FDs.
      *
      *  @param[in] eids - MCTP endpoint ID of the FDs
+     *  @param[in] uuids - UUID of the FDs, if known. The inventory of an FD
+     *                     without UUID is always queried again.
+     */
+    void discoverFDs(const std::vector<mctp_eid_t>& eids,
+                     const EndpointUUIDs& uuids = {});
+
+    /** @brief Drop the cached inventory of an FD, so that it is queried again
+     *         the next time the FD is discovered
+     *
+     *  @param[in] eid - MCTP endpoint ID of the FD
      */
-    void discoverFDs(const std::vector<mctp_eid_t>& eids);
+    void invalidate(mctp_eid_t eid)
+    {
+        inventoriedUUIDs.erase(eid);
+    }
 
     /** @brief Handler for QueryDeviceIdentifiers command response
      *
@@ -82,12 +114,33 @@ class InventoryManager
                                size_t respMsgLen);
 
   private:
+    /** @brief Query the queued FDs while fewer than maxConcurrentDiscovery
+     *         are in flight
+     */
+    void startDiscoveries();
+
+    /** @brief Send QueryDeviceIdentifiers command request
+     *
+     *  @param[in] eid - Remote MCTP endpoint
+     *
+     *  @return true if the request was sent
+     */
+    bool sendQueryDeviceIdentifiersRequest(mctp_eid_t eid);
+
     /** @brief Send GetFirmwareParameters command request
      *
      *  @param[in] eid - Remote MCTP endpoint
      */
     void sendGetFirmwareParametersRequest(mctp_eid_t eid);
 
+    /** @brief The inventory of an FD is complete or failed, start the next
+     *         queued discovery
+     *
+     *  @param[in] eid - Remote MCTP endpoint
+     *  @param[in] success - the inventory of the FD is complete
+     */
+    void discoveryDone(mctp_eid_t eid, bool success);
+
     /** @brief PLDM request handler */
     pldm::requester::Handler<pldm::requester::Request>& handler;
 
@@ -99,6 +152,24 @@ class InventoryManager
 
     /** @brief Component information needed for the update of the managed FDs */
     ComponentInfoMap& componentInfoMap;
+
+    /** @brief Versions of the components pending activation on the FDs */
+    PendingCompVersionMap& pendingCompVersionMap;
+
+    /** @brief Maximum number of FDs queried at once */
+    size_t maxConcurrentDiscovery;
+
+    /** @brief FDs waiting to be queried */
+    std::deque<mctp_eid_t> discoveryQueue;
+
+    /** @brief FDs being queried */
+    std::unordered_set<mctp_eid_t> discoveriesInFlight;
+
+    /** @brief UUID of the queued and in flight FDs */
+    EndpointUUIDs discoveryUUIDs;
+
+    /** @brief UUID of the FDs whose inventory is cached */
+    EndpointUUIDs inventoriedUUIDs;
 };
 
 } // namespace fw_update
@@ -8,6 +8,7 @@
 #include "requester/handler.hpp"
 #include "update_manager.hpp"
 
+#include <functional>
 #include <unordered_map>
 #include <vector>
 
@@ -39,21 +40,33 @@ class Manager
     explicit Manager(Event& event,
                      requester::Handler<requester::Request>& handler,
                      pldm::InstanceIdDb& instanceIdDb) :
-        inventoryMgr(handler, instanceIdDb, descriptorMap, componentInfoMap),
+        inventoryMgr(handler, instanceIdDb, descriptorMap, componentInfoMap,
+                     pendingCompVersionMap),
         updateManager(event, handler, instanceIdDb, descriptorMap,
-                      componentInfoMap)
+                      componentInfoMap, endpointRoutes, pendingCompVersionMap,
+                      std::bind_front(&InventoryManager::invalidate,
+                                      &inventoryMgr))
     {}
 
     /** @brief Discover MCTP endpoints that support the PLDM firmware update
      *         specification
      *
      *  @param[in] eids - Array of MCTP endpoints
+     *  @param[in] routes - Route each of the endpoints is reached through,
+     *                      if known
+     *  @param[in] uuids - UUID of each of the endpoints, if known
      *
      *  @return return PLDM_SUCCESS on success and PLDM_ERROR otherwise
      */
-    void handleMCTPEndpoints(const std::vector<mctp_eid_t>& eids)
+    void handleMCTPEndpoints(const std::vector<mctp_eid_t>& eids,
+                             const EndpointRoutes& routes = {},
+                             const EndpointUUIDs& uuids = {})
     {
-        inventoryMgr.discoverFDs(eids);
+        for (const auto& [eid, route] : routes)
+        {
+            endpointRoutes.insert_or_assign(eid, route);
+        }
+        inventoryMgr.discoverFDs(eids, uuids);
     }
 
     /** @brief Handle PLDM request for the commands in the FW update
@@ -78,6 +91,12 @@ class Manager
     /** Component information of all the discovered MCTP endpoints */
     ComponentInfoMap componentInfoMap;
 
+    /** Route of the discovered MCTP endpoints */
+    EndpointRoutes endpointRoutes;
+
+    /** Versions of the components pending activation on the endpoints */
+    PendingCompVersionMap pendingCompVersionMap;
+
     /** @brief PLDM firmware inventory manager */
     InventoryManager inventoryMgr;
 
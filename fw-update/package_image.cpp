@@ -0,0 +1,124 @@
+#include "package_image.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/sendfile.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <string>
+#include <system_error>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+namespace
+{
+
+/** @brief File descriptor closed when it goes out of scope */
+struct ScopedFd
+{
+    explicit ScopedFd(int fd) : fd(fd) {}
+    ScopedFd(const ScopedFd&) = delete;
+    ScopedFd& operator=(const ScopedFd&) = delete;
+    ~ScopedFd()
+    {
+        if (fd >= 0)
+        {
+            close(fd);
+        }
+    }
+
+    int fd;
+};
+
+[[noreturn]] void throwErrno(int err, const std::string& what)
+{
+    throw std::system_error(err, std::generic_category(), what);
+}
+
+} // namespace
+
+PackageImage::PackageImage(const std::filesystem::path& path)
+{
+    ScopedFd file(open(path.c_str(), O_RDONLY | O_CLOEXEC));
+    if (file.fd < 0)
+    {
+        throwErrno(errno, "Failed to open " + path.string());
+    }
+
+    struct stat st{};
+    if (fstat(file.fd, &st) < 0)
+    {
+        throwErrno(errno, "Failed to stat " + path.string());
+    }
+
+    // The package directory is writable by other processes, a package
+    // rewritten or truncated there would fault the reads of a mapping of
+    // it. The package is copied into a sealed memfd which is mapped instead.
+    ScopedFd copy(memfd_create("pldm-fw-package",
+                               MFD_CLOEXEC | MFD_ALLOW_SEALING));
+    if (copy.fd < 0)
+    {
+        throwErrno(errno, "Failed to create a copy of " + path.string());
+    }
+
+    size_t size = st.st_size;
+    if (ftruncate(copy.fd, size) < 0)
+    {
+        throwErrno(errno, "Failed to size the copy of " + path.string());
+    }
+    off_t offset = 0;
+    while (static_cast<size_t>(offset) < size)
+    {
+        auto copied = sendfile(copy.fd, file.fd, &offset, size - offset);
+        if (copied < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throwErrno(errno, "Failed to copy " + path.string());
+        }
+        if (copied == 0)
+        {
+            throwErrno(EIO, path.string() + " was truncated while copied");
+        }
+    }
+
+    if (fcntl(copy.fd, F_ADD_SEALS,
+              F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_WRITE | F_SEAL_SEAL) < 0)
+    {
+        throwErrno(errno, "Failed to seal the copy of " + path.string());
+    }
+
+    if (size)
+    {
+        auto ptr = mmap(nullptr, size, PROT_READ, MAP_SHARED, copy.fd, 0);
+        if (ptr == MAP_FAILED)
+        {
+            throwErrno(errno, "Failed to map " + path.string());
+        }
+        madvise(ptr, size, MADV_SEQUENTIAL);
+        addr = static_cast<const uint8_t*>(ptr);
+    }
+
+    // The mapping keeps the copy alive after the descriptors are closed
+    length = size;
+}
+
+PackageImage::~PackageImage()
+{
+    if (addr)
+    {
+        munmap(const_cast<uint8_t*>(addr), length);
+    }
+}
+
+} // namespace fw_update
+
+} // namespace pldm
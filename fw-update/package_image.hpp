@@ -0,0 +1,80 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @class PackageImage
+ *
+ *  @brief Read-only memory mapping of a firmware update package
+ *
+ *  The package is copied into a sealed memfd, so a package rewritten or
+ *  truncated in its directory afterwards does not change or fault the
+ *  mapping. The copy is mapped once and advised for sequential access. Reading
+ *  only returns spans into the mapping, so any number of DeviceUpdaters can
+ *  read their components concurrently without a shared stream position.
+ */
+class PackageImage
+{
+  public:
+    PackageImage() = delete;
+    PackageImage(const PackageImage&) = delete;
+    PackageImage(PackageImage&&) = delete;
+    PackageImage& operator=(const PackageImage&) = delete;
+    PackageImage& operator=(PackageImage&&) = delete;
+
+    /** @brief Copy and map a firmware update package
+     *
+     *  @param[in] path - path of the package
+     *
+     *  @throw std::system_error if the package can't be opened, copied or
+     *         mapped
+     */
+    explicit PackageImage(const std::filesystem::path& path);
+
+    ~PackageImage();
+
+    /** @brief Size of the package in bytes */
+    size_t size() const
+    {
+        return length;
+    }
+
+    /** @brief The whole package */
+    std::span<const uint8_t> data() const
+    {
+        return {addr, length};
+    }
+
+    /** @brief Bytes of the package, clamped to the end of the package
+     *
+     *  @param[in] offset - offset from the start of the package
+     *  @param[in] count - number of bytes
+     *
+     *  @return the bytes, fewer than count if the range passes the end
+     */
+    std::span<const uint8_t> read(size_t offset, size_t count) const
+    {
+        if (offset >= length)
+        {
+            return {};
+        }
+        return data().subspan(offset, std::min(count, length - offset));
+    }
+
+  private:
+    const uint8_t* addr = nullptr;
+    size_t length = 0;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
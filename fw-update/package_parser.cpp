@@ -8,7 +8,11 @@
 #include <phosphor-logging/lg2.hpp>
 #include <xyz/openbmc_project/Common/error.hpp>
 
+#include <algorithm>
+#include <bit>
+#include <functional>
 #include <memory>
+#include <string_view>
 
 PHOSPHOR_LOG2_USING;
 
@@ -21,12 +25,145 @@ namespace fw_update
 using InternalFailure =
     sdbusplus::xyz::openbmc_project::Common::Error::InternalFailure;
 
+namespace
+{
+
+/** @brief Call fn(type, value, preceding) for the type-length-value encoded
+ *         descriptors of a record, preceding being the descriptors before
+ *         this one. fn returns false to stop.
+ *
+ *  @return false if a descriptor can't be decoded
+ */
+template <typename Fn>
+bool forEachDescriptor(std::span<const uint8_t> tlvs, size_t count, Fn fn)
+{
+    size_t offset = 0;
+    while (count-- && offset < tlvs.size())
+    {
+        uint16_t descriptorType = 0;
+        variable_field descriptorData{};
+        auto rc = decode_descriptor_type_length_value(
+            tlvs.data() + offset, tlvs.size() - offset, &descriptorType,
+            &descriptorData);
+        if (rc)
+        {
+            error("Decoding descriptor type, length and value failed, RC={RC}",
+                  "RC", rc);
+            return false;
+        }
+        if (!fn(descriptorType,
+                std::span<const uint8_t>(descriptorData.ptr,
+                                         descriptorData.length),
+                tlvs.first(offset)))
+        {
+            return true;
+        }
+        offset += sizeof(pldm_descriptor_tlv().descriptor_type) +
+                  sizeof(pldm_descriptor_tlv().descriptor_length) +
+                  descriptorData.length;
+    }
+    return true;
+}
+
+/** @brief Decode the value of a vendor-defined descriptor
+ *
+ *  @return false if the value can't be decoded
+ */
+bool decodeVendorDefined(std::span<const uint8_t> value,
+                         variable_field& descTitleStr,
+                         variable_field& vendorDefinedDescData)
+{
+    uint8_t descTitleStrType = 0;
+    auto rc = decode_vendor_defined_descriptor_value(
+        value.data(), value.size(), &descTitleStrType, &descTitleStr,
+        &vendorDefinedDescData);
+    if (rc)
+    {
+        error("Decoding Vendor-defined descriptor value failed, RC={RC}", "RC",
+              rc);
+        return false;
+    }
+    return true;
+}
+
+/** @brief The character utils::toString() keeps in a descriptor title */
+char printable(uint8_t c)
+{
+    return isprint(c) ? static_cast<char>(c) : ' ';
+}
+
+size_t hashBytes(DescriptorType type, std::span<const uint8_t> data)
+{
+    auto hash = std::hash<std::string_view>{}(std::string_view(
+        reinterpret_cast<const char*>(data.data()), data.size()));
+    return hash ^ (std::hash<DescriptorType>{}(type) + 0x9e3779b9 +
+                   (hash << 6) + (hash >> 2));
+}
+
+/** @brief Build a FirmwareDeviceIDRecord from its view, the view is valid
+ *         as it was decoded when the package header was parsed
+ */
+FirmwareDeviceIDRecord toRecord(const FirmwareDeviceIDRecordView& view)
+{
+    Descriptors descriptors{};
+    forEachDescriptor(
+        view.descriptors, view.descriptorCount,
+        [&descriptors](DescriptorType type, std::span<const uint8_t> value,
+                       std::span<const uint8_t>) {
+        if (type != PLDM_FWUP_VENDOR_DEFINED)
+        {
+            descriptors.emplace(type,
+                                DescriptorData{value.begin(), value.end()});
+            return true;
+        }
+        variable_field descTitleStr{};
+        variable_field vendorDefinedDescData{};
+        if (decodeVendorDefined(value, descTitleStr, vendorDefinedDescData))
+        {
+            descriptors.emplace(
+                type, std::make_tuple(utils::toString(descTitleStr),
+                                      VendorDefinedDescriptorData{
+                                          vendorDefinedDescData.ptr,
+                                          vendorDefinedDescData.ptr +
+                                              vendorDefinedDescData.length}));
+        }
+        return true;
+    });
+
+    ApplicableComponents componentsList;
+    for (size_t varBitfieldIdx = 0;
+         varBitfieldIdx < view.applicableComponents.size(); varBitfieldIdx++)
+    {
+        std::bitset<8> entry{view.applicableComponents[varBitfieldIdx]};
+        for (size_t idx = 0; idx < entry.size(); idx++)
+        {
+            if (entry[idx])
+            {
+                componentsList.emplace_back(idx +
+                                            (varBitfieldIdx * entry.size()));
+            }
+        }
+    }
+
+    variable_field compImageSetVersionStr{
+        reinterpret_cast<const uint8_t*>(view.compImageSetVersion.data()),
+        view.compImageSetVersion.size()};
+    return std::make_tuple(
+        view.deviceUpdateOptionFlags, std::move(componentsList),
+        utils::toString(compImageSetVersionStr), std::move(descriptors),
+        FirmwareDevicePackageData{view.fwDevicePkgData.begin(),
+                                  view.fwDevicePkgData.end()});
+}
+
+} // namespace
+
 size_t PackageParser::parseFDIdentificationArea(
-    DeviceIDRecordCount deviceIdRecCount, const std::vector<uint8_t>& pkgHdr,
+    DeviceIDRecordCount deviceIdRecCount, std::span<const uint8_t> pkgHdr,
     size_t offset)
 {
     size_t pkgHdrRemainingSize = pkgHdr.size() - offset;
 
+    fwDeviceIDRecordViews.reserve(deviceIdRecCount);
     while (deviceIdRecCount-- && (pkgHdrRemainingSize > 0))
     {
         pldm_firmware_device_id_record deviceIdRecHeader{};
@@ -46,90 +183,34 @@ size_t PackageParser::parseFDIdentificationArea(
             throw InternalFailure();
         }
 
-        Descriptors descriptors{};
-        while (deviceIdRecHeader.descriptor_count-- &&
-               (recordDescriptors.length > 0))
-        {
-            uint16_t descriptorType = 0;
-            variable_field descriptorData{};
-
-            rc = decode_descriptor_type_length_value(
-                recordDescriptors.ptr, recordDescriptors.length,
-                &descriptorType, &descriptorData);
-            if (rc)
-            {
-                error(
-                    "Decoding descriptor type, length and value failed, RC={RC}",
-                    "RC", rc);
-                throw InternalFailure();
-            }
-
-            if (descriptorType != PLDM_FWUP_VENDOR_DEFINED)
-            {
-                descriptors.emplace(
-                    descriptorType,
-                    DescriptorData{descriptorData.ptr,
-                                   descriptorData.ptr + descriptorData.length});
-            }
-            else
-            {
-                uint8_t descTitleStrType = 0;
-                variable_field descTitleStr{};
-                variable_field vendorDefinedDescData{};
-
-                rc = decode_vendor_defined_descriptor_value(
-                    descriptorData.ptr, descriptorData.length,
-                    &descTitleStrType, &descTitleStr, &vendorDefinedDescData);
-                if (rc)
-                {
-                    error(
-                        "Decoding Vendor-defined descriptor value failed, RC={RC}",
-                        "RC", rc);
-                    throw InternalFailure();
-                }
-
-                descriptors.emplace(
-                    descriptorType,
-                    std::make_tuple(utils::toString(descTitleStr),
-                                    VendorDefinedDescriptorData{
-                                        vendorDefinedDescData.ptr,
-                                        vendorDefinedDescData.ptr +
-                                            vendorDefinedDescData.length}));
-            }
-
-            auto nextDescriptorOffset =
-                sizeof(pldm_descriptor_tlv().descriptor_type) +
-                sizeof(pldm_descriptor_tlv().descriptor_length) +
-                descriptorData.length;
-            recordDescriptors.ptr += nextDescriptorOffset;
-            recordDescriptors.length -= nextDescriptorOffset;
-        }
-
-        DeviceUpdateOptionFlags deviceUpdateOptionFlags =
-            deviceIdRecHeader.device_update_option_flags.value;
-
-        ApplicableComponents componentsList;
-
-        for (size_t varBitfieldIdx = 0;
-             varBitfieldIdx < applicableComponents.length; varBitfieldIdx++)
+        // The descriptors are validated here, so building the record from its
+        // view later can't fail
+        FirmwareDeviceIDRecordView view{
+            deviceIdRecHeader.device_update_option_flags.value,
+            {applicableComponents.ptr, applicableComponents.length},
+            {reinterpret_cast<const char*>(compImageSetVersionStr.ptr),
+             compImageSetVersionStr.length},
+            {recordDescriptors.ptr, recordDescriptors.length},
+            deviceIdRecHeader.descriptor_count,
+            {fwDevicePkgData.ptr, fwDevicePkgData.length}};
+        bool valid = true;
+        valid &= forEachDescriptor(
+            view.descriptors, view.descriptorCount,
+            [&valid](DescriptorType type, std::span<const uint8_t> value,
+                     std::span<const uint8_t>) {
+            variable_field descTitleStr{};
+            variable_field vendorDefinedDescData{};
+            valid = type != PLDM_FWUP_VENDOR_DEFINED ||
+                    decodeVendorDefined(value, descTitleStr,
+                                        vendorDefinedDescData);
+            return valid;
+        });
+        if (!valid)
         {
-            std::bitset<8> entry{*(applicableComponents.ptr + varBitfieldIdx)};
-            for (size_t idx = 0; idx < entry.size(); idx++)
-            {
-                if (entry[idx])
-                {
-                    componentsList.emplace_back(
-                        idx + (varBitfieldIdx * entry.size()));
-                }
-            }
+            throw InternalFailure();
         }
 
-        fwDeviceIDRecords.emplace_back(std::make_tuple(
-            deviceUpdateOptionFlags, componentsList,
-            utils::toString(compImageSetVersionStr), std::move(descriptors),
-            FirmwareDevicePackageData{fwDevicePkgData.ptr,
-                                      fwDevicePkgData.ptr +
-                                          fwDevicePkgData.length}));
+        fwDeviceIDRecordViews.emplace_back(view);
         offset += deviceIdRecHeader.record_length;
         pkgHdrRemainingSize -= deviceIdRecHeader.record_length;
     }
@@ -138,7 +219,7 @@ size_t PackageParser::parseFDIdentificationArea(
 }
 
 size_t PackageParser::parseCompImageInfoArea(ComponentImageCount compImageCount,
-                                             const std::vector<uint8_t>& pkgHdr,
+                                             std::span<const uint8_t> pkgHdr,
                                              size_t offset)
 {
     size_t pkgHdrRemainingSize = pkgHdr.size() - offset;
@@ -216,7 +297,7 @@ void PackageParser::validatePkgTotalSize(uintmax_t pkgSize)
     }
 }
 
-void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
+void PackageParserV1::parse(std::span<const uint8_t> pkgHdr,
                             uintmax_t pkgSize)
 {
     if (pkgHeaderSize != pkgHdr.size())
@@ -238,7 +319,7 @@ void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
     offset += sizeof(DeviceIDRecordCount);
 
     offset = parseFDIdentificationArea(deviceIdRecCount, pkgHdr, offset);
-    if (deviceIdRecCount != fwDeviceIDRecords.size())
+    if (deviceIdRecCount != fwDeviceIDRecordViews.size())
     {
         error(
             "DeviceIDRecordCount entries not found, DEVICE_ID_REC_COUNT={DREC_CNT}",
@@ -287,7 +368,34 @@ void PackageParserV1::parse(const std::vector<uint8_t>& pkgHdr,
     validatePkgTotalSize(pkgSize);
 }
 
-std::unique_ptr<PackageParser> parsePkgHeader(std::vector<uint8_t>& pkgData)
+const FirmwareDeviceIDRecords& PackageParser::getFwDeviceIDRecords() const
+{
+    if (fwDeviceIDRecords.size() != fwDeviceIDRecordViews.size())
+    {
+        fwDeviceIDRecords.clear();
+        fwDeviceIDRecords.reserve(fwDeviceIDRecordViews.size());
+        for (const auto& view : fwDeviceIDRecordViews)
+        {
+            fwDeviceIDRecords.emplace_back(toRecord(view));
+        }
+    }
+    return fwDeviceIDRecords;
+}
+
+const FirmwareDeviceIDRecord&
+    PackageParser::getFwDeviceIDRecord(size_t index) const
+{
+    auto search = builtRecords.find(index);
+    if (search == builtRecords.end())
+    {
+        search = builtRecords
+                     .emplace(index, toRecord(fwDeviceIDRecordViews.at(index)))
+                     .first;
+    }
+    return search->second;
+}
+
+std::unique_ptr<PackageParser> parsePkgHeader(std::span<const uint8_t> pkgData)
 {
     constexpr std::array<uint8_t, PLDM_FWUP_UUID_LENGTH> hdrIdentifierv1{
         0xF0, 0x18, 0x87, 0x8C, 0xCB, 0x7D, 0x49, 0x43,
@@ -319,6 +427,108 @@ std::unique_ptr<PackageParser> parsePkgHeader(std::vector<uint8_t>& pkgData)
     return nullptr;
 }
 
+size_t countApplicableComponents(const FirmwareDeviceIDRecordView& record)
+{
+    size_t count = 0;
+    for (auto entry : record.applicableComponents)
+    {
+        count += std::popcount(entry);
+    }
+    return count;
+}
+
+size_t hashDescriptor(DescriptorType type,
+                      const Descriptors::mapped_type& value)
+{
+    if (std::holds_alternative<DescriptorData>(value))
+    {
+        return hashBytes(type, std::get<DescriptorData>(value));
+    }
+    return hashBytes(
+        type, std::get<VendorDefinedDescriptorData>(
+                  std::get<VendorDefinedDescriptorInfo>(value)));
+}
+
+std::optional<size_t>
+    hashInitialDescriptor(const FirmwareDeviceIDRecordView& record)
+{
+    std::optional<size_t> hash;
+    forEachDescriptor(record.descriptors, record.descriptorCount,
+                      [&hash](DescriptorType type,
+                              std::span<const uint8_t> value,
+                              std::span<const uint8_t>) {
+        variable_field descTitleStr{};
+        variable_field vendorDefinedDescData{};
+        if (type != PLDM_FWUP_VENDOR_DEFINED)
+        {
+            hash = hashBytes(type, value);
+        }
+        else if (decodeVendorDefined(value, descTitleStr,
+                                     vendorDefinedDescData))
+        {
+            hash = hashBytes(type, {vendorDefinedDescData.ptr,
+                                    vendorDefinedDescData.length});
+        }
+        return false;
+    });
+    return hash;
+}
+
+bool matchDescriptors(const FirmwareDeviceIDRecordView& record,
+                      const Descriptors& descriptors)
+{
+    bool match = true;
+    match &= forEachDescriptor(
+        record.descriptors, record.descriptorCount,
+        [&](DescriptorType type, std::span<const uint8_t> value,
+            std::span<const uint8_t> preceding) {
+        // Only the first descriptor of a type makes it into a Descriptors map
+        bool repeated = false;
+        forEachDescriptor(preceding, record.descriptorCount,
+                          [&repeated, type](DescriptorType precedingType,
+                                            std::span<const uint8_t>,
+                                            std::span<const uint8_t>) {
+            repeated = precedingType == type;
+            return !repeated;
+        });
+        if (repeated)
+        {
+            return true;
+        }
+
+        auto search = descriptors.find(type);
+        if (search == descriptors.end())
+        {
+            match = false;
+            return false;
+        }
+        if (type != PLDM_FWUP_VENDOR_DEFINED)
+        {
+            auto data = std::get_if<DescriptorData>(&search->second);
+            match = data && std::ranges::equal(*data, value);
+            return match;
+        }
+
+        variable_field descTitleStr{};
+        variable_field vendorDefinedDescData{};
+        auto info = std::get_if<VendorDefinedDescriptorInfo>(&search->second);
+        match = info &&
+                decodeVendorDefined(value, descTitleStr,
+                                    vendorDefinedDescData) &&
+                std::ranges::equal(
+                    std::get<VendorDefinedDescriptorTitle>(*info),
+                    std::span<const uint8_t>(descTitleStr.ptr,
+                                             descTitleStr.length),
+                    {}, {}, printable) &&
+                std::ranges::equal(
+                    std::get<VendorDefinedDescriptorData>(*info),
+                    std::span<const uint8_t>(vendorDefinedDescData.ptr,
+                                             vendorDefinedDescData.length));
+        return match;
+    });
+    return match;
+}
+
 } // namespace fw_update
 
 } // namespace pldm
@@ -7,7 +7,11 @@
 #include <array>
 #include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
+#include <string_view>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
 namespace pldm
@@ -16,6 +20,25 @@ namespace pldm
 namespace fw_update
 {
 
+/** @brief Firmware device ID record viewed in place in the package header,
+ *         the fields are only decoded when a FirmwareDeviceIDRecord is built
+ */
+struct FirmwareDeviceIDRecordView
+{
+    DeviceUpdateOptionFlags deviceUpdateOptionFlags;
+    /** @brief ApplicableComponents bitfield */
+    std::span<const uint8_t> applicableComponents;
+    /** @brief ComponentImageSetVersionString */
+    std::string_view compImageSetVersion;
+    /** @brief RecordDescriptors, type-length-value encoded */
+    std::span<const uint8_t> descriptors;
+    uint8_t descriptorCount;
+    /** @brief FirmwareDevicePackageData */
+    std::span<const uint8_t> fwDevicePkgData;
+};
+
+using FirmwareDeviceIDRecordViews = std::vector<FirmwareDeviceIDRecordView>;
+
 /** @class PackageParser
  *
  *  PackageParser is the abstract base class for parsing the PLDM firmware
@@ -53,24 +76,42 @@ class PackageParser
     {}
 
     /** @brief Parse the firmware update package header
+     *
+     *  The firmware device ID records are kept as views into pkgHdr, which
+     *  has to outlive the parser, typically as part of a mapped package.
      *
      *  @param[in] pkgHdr - Package header
      *  @param[in] pkgSize - Size of the firmware update package
      *
      *  @note Throws exception is parsing fails
      */
-    virtual void parse(const std::vector<uint8_t>& pkgHdr,
-                       uintmax_t pkgSize) = 0;
+    virtual void parse(std::span<const uint8_t> pkgHdr, uintmax_t pkgSize) = 0;
+
+    /** @brief Get firmware device ID records from the package, viewed in the
+     *         package header
+     */
+    const FirmwareDeviceIDRecordViews& getFwDeviceIDRecordViews() const
+    {
+        return fwDeviceIDRecordViews;
+    }
 
     /** @brief Get firmware device ID records from the package
+     *
+     *  The records are built from their views on the first call.
      *
      *  @return if parsing the package is successful, return firmware device ID
      *          records
      */
-    const FirmwareDeviceIDRecords& getFwDeviceIDRecords() const
-    {
-        return fwDeviceIDRecords;
-    }
+    const FirmwareDeviceIDRecords& getFwDeviceIDRecords() const;
+
+    /** @brief Get a firmware device ID record from the package, built from its
+     *         view on the first call
+     *
+     *  @param[in] index - index of the record in the package
+     *
+     *  @return the record, valid as long as the parser
+     */
+    const FirmwareDeviceIDRecord& getFwDeviceIDRecord(size_t index) const;
 
     /** @brief Get component image information from the package
      *
@@ -100,7 +141,7 @@ class PackageParser
      *          device identification area, on error throw exception.
      */
     size_t parseFDIdentificationArea(DeviceIDRecordCount deviceIdRecCount,
-                                     const std::vector<uint8_t>& pkgHdr,
+                                     std::span<const uint8_t> pkgHdr,
                                      size_t offset);
 
     /** @brief Parse the component image information area
@@ -114,7 +155,7 @@ class PackageParser
      *          image information area, on error throw exception.
      */
     size_t parseCompImageInfoArea(ComponentImageCount compImageCount,
-                                  const std::vector<uint8_t>& pkgHdr,
+                                  std::span<const uint8_t> pkgHdr,
                                   size_t offset);
 
     /** @brief Validate the total size of the package
@@ -128,8 +169,18 @@ class PackageParser
      */
     void validatePkgTotalSize(uintmax_t pkgSize);
 
-    /** @brief Firmware Device ID Records in the package */
-    FirmwareDeviceIDRecords fwDeviceIDRecords;
+    /** @brief Firmware Device ID Records in the package, viewed in the
+     *         package header
+     */
+    FirmwareDeviceIDRecordViews fwDeviceIDRecordViews;
+
+    /** @brief Firmware Device ID Records in the package, built from the views
+     *         when all of them are asked for
+     */
+    mutable FirmwareDeviceIDRecords fwDeviceIDRecords;
+
+    /** @brief Firmware Device ID Records built one at a time, by index */
+    mutable std::unordered_map<size_t, FirmwareDeviceIDRecord> builtRecords;
 
     /** @brief Component Image Information in the package */
     ComponentImageInfos componentImageInfos;
@@ -171,7 +222,7 @@ class PackageParserV1 final : public PackageParser
         PackageParser(pkgHeaderSize, pkgVersion, componentBitmapBitLength)
     {}
 
-    virtual void parse(const std::vector<uint8_t>& pkgHdr, uintmax_t pkgSize);
+    virtual void parse(std::span<const uint8_t> pkgHdr, uintmax_t pkgSize);
 };
 
 /** @brief Parse the package header information
@@ -181,7 +232,47 @@ class PackageParserV1 final : public PackageParser
  *  @return On success return the PackageParser for the header format version
  *          on failure return nullptr
  */
-std::unique_ptr<PackageParser> parsePkgHeader(std::vector<uint8_t>& pkgHdrInfo);
+std::unique_ptr<PackageParser>
+    parsePkgHeader(std::span<const uint8_t> pkgHdrInfo);
+
+/** @brief Number of components a firmware device ID record applies
+ *
+ *  @param[in] record - the record
+ */
+size_t countApplicableComponents(const FirmwareDeviceIDRecordView& record);
+
+/** @brief Hash of a descriptor of a firmware device
+ *
+ *  Equal to the hash of the same descriptor in a package record, see
+ *  hashInitialDescriptor(). Vendor-defined descriptors are hashed by their
+ *  data, without the title.
+ *
+ *  @param[in] type - descriptor type
+ *  @param[in] value - descriptor value
+ */
+size_t hashDescriptor(DescriptorType type,
+                      const Descriptors::mapped_type& value);
+
+/** @brief Hash of the initial descriptor of a firmware device ID record
+ *
+ *  @param[in] record - the record
+ *
+ *  @return the hash, std::nullopt if the record has no descriptor
+ */
+std::optional<size_t>
+    hashInitialDescriptor(const FirmwareDeviceIDRecordView& record);
+
+/** @brief Check if the descriptors of a firmware device include all the
+ *         descriptors of a package record
+ *
+ *  Only the first descriptor of each type in the record is compared, as in a
+ *  Descriptors map.
+ *
+ *  @param[in] record - the record
+ *  @param[in] descriptors - descriptors of the firmware device
+ */
+bool matchDescriptors(const FirmwareDeviceIDRecordView& record,
+                      const Descriptors& descriptors);
 
 } // namespace fw_update
 
@@ -0,0 +1,223 @@
+#include "package_stager.hpp"
+
+#include "common/utils.hpp"
+
+#include <libpldm/firmware_update.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <system_error>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+namespace fs = std::filesystem;
+
+PackageStager::PackageStager(sdeventplus::Event& event, size_t depth,
+                             OnReady onReady) :
+    depth(std::max<size_t>(depth, 1)),
+    onReady(std::move(onReady)),
+    notifyFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+    notifySource(event, notifyFd, EPOLLIN,
+                 std::bind_front(&PackageStager::drainStaged, this)),
+    worker(&PackageStager::work, this)
+{}
+
+PackageStager::~PackageStager()
+{
+    {
+        std::lock_guard lock(mutex);
+        stopping = true;
+    }
+    added.notify_one();
+    if (worker.joinable())
+    {
+        worker.join();
+    }
+    close(notifyFd);
+}
+
+void PackageStager::add(const fs::path& path)
+{
+    {
+        std::lock_guard lock(mutex);
+        // A package written again before it was staged is staged once
+        if (std::find(pending.begin(), pending.end(), path) != pending.end())
+        {
+            return;
+        }
+        pending.push_back(path);
+    }
+    added.notify_one();
+}
+
+std::optional<StagedPackage> PackageStager::next()
+{
+    if (ready.empty())
+    {
+        return std::nullopt;
+    }
+    auto staged = std::move(ready.front());
+    ready.pop_front();
+    return staged;
+}
+
+std::optional<StagedPackage> PackageStager::stage(const fs::path& path)
+{
+    auto start = std::chrono::steady_clock::now();
+    StagedPackage staged{path, nullptr, nullptr, 0, 0};
+    try
+    {
+        staged.package = std::make_shared<PackageImage>(path);
+    }
+    catch (const std::system_error& e)
+    {
+        error(
+            "Opening the PLDM FW update package failed, ERR={ERR}, PACKAGEFILE={PKG_FILE}",
+            "ERR", unsigned(e.code().value()), "PKG_FILE", path.c_str());
+        fs::remove(path);
+        return std::nullopt;
+    }
+
+    auto packageSize = staged.package->size();
+    if (packageSize < sizeof(pldm_package_header_information))
+    {
+        error(
+            "PLDM FW update package length less than the length of the package header information, PACKAGESIZE={PKG_SIZE}",
+            "PKG_SIZE", packageSize);
+        fs::remove(path);
+        return std::nullopt;
+    }
+
+    // The header is parsed in place in the mapped package, the parser keeps
+    // views into it
+    auto parser = parsePkgHeader(staged.package->data());
+    if (parser == nullptr)
+    {
+        error("Invalid PLDM package header information");
+        fs::remove(path);
+        return std::nullopt;
+    }
+
+    auto data = staged.package->data();
+    staged.contentHash = utils::crc32Final(
+        utils::crc32Update(utils::crc32Init, data.data(), data.size()));
+    auto packageHeader = staged.package->read(0, parser->pkgHeaderSize);
+    staged.headerHash = utils::crc32Final(utils::crc32Update(
+        utils::crc32Init, packageHeader.data(), packageHeader.size()));
+    try
+    {
+        parser->parse(packageHeader, packageSize);
+        staged.parser = std::move(parser);
+    }
+    catch (const std::exception& e)
+    {
+        error("Invalid PLDM package header: {ERROR}", "ERROR", e);
+    }
+
+    info(
+        "Staged the PLDM FW update package, PACKAGEFILE={PKG_FILE}, PKG_HASH={PKG_HASH}, DURATION={DURATION}ms",
+        "PKG_FILE", path.c_str(), "PKG_HASH", staged.contentHash, "DURATION",
+        std::chrono::duration<double, std::milli>(
+            std::chrono::steady_clock::now() - start)
+            .count());
+    return staged;
+}
+
+void PackageStager::work()
+{
+    while (true)
+    {
+        fs::path path;
+        {
+            std::unique_lock lock(mutex);
+            added.wait(lock, [this] { return stopping || !pending.empty(); });
+            if (stopping)
+            {
+                return;
+            }
+            path = std::move(pending.front());
+            pending.erase(pending.begin());
+        }
+
+        auto result = stage(path);
+        if (!result)
+        {
+            continue;
+        }
+        {
+            std::lock_guard lock(mutex);
+            staged.push_back(std::move(*result));
+        }
+        uint64_t one = 1;
+        if (write(notifyFd, &one, sizeof(one)) < 0)
+        {
+            error("Failed to signal a staged PLDM FW update package");
+        }
+    }
+}
+
+void PackageStager::drainStaged(sdeventplus::source::IO& /*io*/, int fd,
+                                uint32_t /*revents*/)
+{
+    uint64_t count{};
+    if (read(fd, &count, sizeof(count)) < 0)
+    {
+        return;
+    }
+
+    std::vector<StagedPackage> packages;
+    {
+        std::lock_guard lock(mutex);
+        packages.swap(staged);
+    }
+    if (packages.empty())
+    {
+        return;
+    }
+
+    for (auto& package : packages)
+    {
+        // A package written again replaces its previous content in the queue
+        std::erase_if(ready, [&package](const auto& queued) {
+            return queued.path == package.path;
+        });
+        auto duplicate = std::find_if(ready.begin(), ready.end(),
+                                      [&package](const auto& queued) {
+            return queued.contentHash == package.contentHash;
+        });
+        if (duplicate != ready.end())
+        {
+            info(
+                "PLDM FW update package already staged, PACKAGEFILE={PKG_FILE}, STAGED_FILE={STAGED_FILE}",
+                "PKG_FILE", package.path.c_str(), "STAGED_FILE",
+                duplicate->path.c_str());
+            fs::remove(package.path);
+            continue;
+        }
+        ready.push_back(std::move(package));
+        if (ready.size() > depth)
+        {
+            error(
+                "PLDM FW update package staging queue full, dropping PACKAGEFILE={PKG_FILE}",
+                "PKG_FILE", ready.front().path.c_str());
+            fs::remove(ready.front().path);
+            ready.pop_front();
+        }
+    }
+    onReady();
+}
+
+} // namespace fw_update
+
+} // namespace pldm
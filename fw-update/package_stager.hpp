@@ -0,0 +1,132 @@
+#pragma once
+
+#include "package_image.hpp"
+#include "package_parser.hpp"
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @brief A firmware update package mapped and parsed ahead of its
+ *         activation
+ */
+struct StagedPackage
+{
+    std::filesystem::path path;
+    std::shared_ptr<const PackageImage> package;
+    /** @brief Parser of the package header, nullptr if the header is invalid
+     */
+    std::unique_ptr<PackageParser> parser;
+    /** @brief CRC32 of the whole package, identifies its content */
+    uint32_t contentHash = 0;
+    /** @brief CRC32 of the package header, identifies the package in the
+     *         update checkpoints
+     */
+    uint32_t headerHash = 0;
+};
+
+/** @class PackageStager
+ *
+ *  @brief Maps, hashes and parses the firmware update packages dropped in the
+ *         image directory on a background thread
+ *
+ *  The packages are handed back to the event loop through an eventfd and
+ *  queued, ready to be activated. A package with the content of one already
+ *  queued is removed, and the oldest package is dropped when the queue is
+ *  full.
+ */
+class PackageStager
+{
+  public:
+    using OnReady = std::function<void()>;
+
+    PackageStager() = delete;
+    PackageStager(const PackageStager&) = delete;
+    PackageStager(PackageStager&&) = delete;
+    PackageStager& operator=(const PackageStager&) = delete;
+    PackageStager& operator=(PackageStager&&) = delete;
+
+    /** @brief Constructor, starts the staging thread
+     *
+     *  @param[in] event - event loop the staged packages are queued on
+     *  @param[in] depth - maximum number of staged packages queued
+     *  @param[in] onReady - invoked on the event loop when packages are
+     *                       queued
+     */
+    PackageStager(sdeventplus::Event& event, size_t depth, OnReady onReady);
+
+    /** @brief Stops the staging thread */
+    ~PackageStager();
+
+    /** @brief Stage a package on the staging thread
+     *
+     *  @param[in] path - path of the package
+     */
+    void add(const std::filesystem::path& path);
+
+    /** @brief Take the oldest staged package from the queue */
+    std::optional<StagedPackage> next();
+
+    /** @brief Number of staged packages queued */
+    size_t size() const
+    {
+        return ready.size();
+    }
+
+    /** @brief Map, hash and parse a package
+     *
+     *  A package whose header can't be parsed is returned without a parser,
+     *  so it can be reported as invalid.
+     *
+     *  @param[in] path - path of the package
+     *
+     *  @return the staged package, std::nullopt if the file isn't a firmware
+     *          update package, in which case it is removed
+     */
+    static std::optional<StagedPackage> stage(const std::filesystem::path& path);
+
+  private:
+    /** @brief Stage the added packages, on the staging thread */
+    void work();
+
+    /** @brief Queue the packages staged so far, on the event loop */
+    void drainStaged(sdeventplus::source::IO& io, int fd, uint32_t revents);
+
+    size_t depth;
+    OnReady onReady;
+    int notifyFd;
+    sdeventplus::source::IO notifySource;
+
+    /** @brief Packages ready to activate, oldest first */
+    std::deque<StagedPackage> ready;
+
+    std::mutex mutex;
+    std::condition_variable added;
+    /** @brief Paths waiting to be staged */
+    std::vector<std::filesystem::path> pending;
+    /** @brief Packages staged, not yet queued */
+    std::vector<StagedPackage> staged;
+    std::atomic<bool> stopping = false;
+    std::thread worker;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,104 @@
+#include "fw-update/activation_batch.hpp"
+
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::fw_update;
+
+class ActivationBatchTest : public testing::Test
+{
+  protected:
+    ActivationBatch::Activate record()
+    {
+        return [this](mctp_eid_t eid, bool selfContained) {
+            activated.emplace_back(eid, selfContained);
+        };
+    }
+
+    std::vector<std::pair<mctp_eid_t, bool>> activated;
+};
+
+TEST_F(ActivationBatchTest, ActivatedOnceAllApplied)
+{
+    ActivationBatch batch(SelfContainedActivation::Always, record());
+    batch.add(8);
+    batch.add(9);
+    batch.add(10);
+
+    batch.applied(9);
+    batch.applied(8);
+    EXPECT_TRUE(activated.empty());
+    EXPECT_EQ(batch.pending(), 1);
+
+    batch.applied(10);
+    EXPECT_EQ(activated, (std::vector<std::pair<mctp_eid_t, bool>>{
+                             {8, true}, {9, true}, {10, true}}));
+    EXPECT_EQ(batch.pending(), 0);
+
+    // Applying again, or failing after activation, has no effect
+    batch.applied(10);
+    batch.failed(9);
+    EXPECT_EQ(activated.size(), 3);
+}
+
+TEST_F(ActivationBatchTest, FailedDeviceNotActivated)
+{
+    ActivationBatch batch(SelfContainedActivation::AllApplied, record());
+    batch.add(8);
+    batch.add(9);
+
+    batch.applied(8);
+    batch.failed(9);
+    EXPECT_EQ(activated,
+              (std::vector<std::pair<mctp_eid_t, bool>>{{8, false}}));
+}
+
+TEST_F(ActivationBatchTest, SelfContainedPolicy)
+{
+    ActivationBatch never(SelfContainedActivation::Never, record());
+    never.add(8);
+    never.applied(8);
+
+    ActivationBatch allApplied(SelfContainedActivation::AllApplied, record());
+    allApplied.add(9);
+    allApplied.applied(9);
+    EXPECT_EQ(activated, (std::vector<std::pair<mctp_eid_t, bool>>{
+                             {8, false}, {9, true}}));
+}
+
+TEST_F(ActivationBatchTest, Clear)
+{
+    ActivationBatch batch(SelfContainedActivation::Always, record());
+    batch.add(8);
+    batch.add(9);
+    batch.applied(8);
+    batch.clear();
+    EXPECT_EQ(batch.pending(), 0);
+
+    batch.add(10);
+    batch.applied(10);
+    EXPECT_EQ(activated,
+              (std::vector<std::pair<mctp_eid_t, bool>>{{10, true}}));
+}
+
+TEST_F(ActivationBatchTest, Expire)
+{
+    ActivationBatch batch(SelfContainedActivation::AllApplied, record());
+    batch.add(8);
+    batch.add(9);
+    batch.add(10);
+    batch.applied(8);
+
+    // The devices still pending drop out, the applied one is activated
+    EXPECT_EQ(batch.expire(), (std::vector<mctp_eid_t>{9, 10}));
+    EXPECT_EQ(activated,
+              (std::vector<std::pair<mctp_eid_t, bool>>{{8, false}}));
+    EXPECT_EQ(batch.pending(), 0);
+
+    // Their update then fails, without another activation
+    batch.failed(9);
+    EXPECT_TRUE(batch.expire().empty());
+    EXPECT_EQ(activated.size(), 1);
+}
@@ -1,11 +1,16 @@
 #include "common/instance_id.hpp"
 #include "common/utils.hpp"
 #include "fw-update/device_updater.hpp"
+#include "fw-update/package_image.hpp"
 #include "fw-update/package_parser.hpp"
 #include "requester/handler.hpp"
 
 #include <libpldm/firmware_update.h>
 
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+
 #include <gmock/gmock.h>
 #include <gtest/gtest.h>
 
@@ -15,8 +20,7 @@ using namespace pldm::fw_update;
 class DeviceUpdaterTest : public testing::Test
 {
   protected:
-    DeviceUpdaterTest() :
-        package("./test_pkg", std::ios::binary | std::ios::in | std::ios::ate)
+    DeviceUpdaterTest() : package(std::make_shared<PackageImage>("./test_pkg"))
     {
         fwDeviceIDRecord = {
             1,
@@ -33,7 +37,7 @@ class DeviceUpdaterTest : public testing::Test
     }
 
     int fd = -1;
-    std::ifstream package;
+    std::shared_ptr<const PackageImage> package;
     FirmwareDeviceIDRecord fwDeviceIDRecord;
     ComponentImageInfos compImageInfos;
     ComponentInfo compInfo;
@@ -42,32 +46,22 @@ class DeviceUpdaterTest : public testing::Test
 TEST_F(DeviceUpdaterTest, validatePackage)
 {
     constexpr uintmax_t testPkgSize = 1163;
-    uintmax_t packageSize = package.tellg();
+    uintmax_t packageSize = package->size();
     EXPECT_EQ(packageSize, testPkgSize);
 
-    package.seekg(0);
-    std::vector<uint8_t> packageHeader(sizeof(pldm_package_header_information));
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 sizeof(pldm_package_header_information));
-
     auto pkgHeaderInfo =
         reinterpret_cast<const pldm_package_header_information*>(
-            packageHeader.data());
+            package->data().data());
     auto pkgHeaderInfoSize = sizeof(pldm_package_header_information) +
                              pkgHeaderInfo->package_version_string_length;
-    packageHeader.clear();
-    packageHeader.resize(pkgHeaderInfoSize);
-    package.seekg(0);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 pkgHeaderInfoSize);
+    auto bytes = package->read(0, pkgHeaderInfoSize);
+    std::vector<uint8_t> packageHeader(bytes.begin(), bytes.end());
 
     auto parser = parsePkgHeader(packageHeader);
     EXPECT_NE(parser, nullptr);
 
-    package.seekg(0);
-    packageHeader.resize(parser->pkgHeaderSize);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 parser->pkgHeaderSize);
+    bytes = package->read(0, parser->pkgHeaderSize);
+    packageHeader.assign(bytes.begin(), bytes.end());
 
     parser->parse(packageHeader, packageSize);
     const auto& fwDeviceIDRecords = parser->getFwDeviceIDRecords();
@@ -150,3 +144,40 @@ TEST_F(DeviceUpdaterTest, ReadPackage512B)
         0xA2, 0x72, 0x33, 0x00, 0x3C, 0x7E, 0x28, 0x36, 0x10, 0x90, 0x38, 0xFB};
     EXPECT_EQ(response, compFirst512B);
 }
+
+TEST_F(DeviceUpdaterTest, ReadPastEndOfPackage)
+{
+    EXPECT_EQ(package->read(package->size() - 10, 512).size(), 10);
+    EXPECT_TRUE(package->read(package->size(), 1).empty());
+    EXPECT_THROW(PackageImage("./no_such_pkg"), std::system_error);
+}
+
+TEST_F(DeviceUpdaterTest, PackageRewrittenAfterMapping)
+{
+    auto path = std::filesystem::temp_directory_path() /
+                "device_updater_test_pkg";
+    std::filesystem::copy_file("./test_pkg", path,
+                               std::filesystem::copy_options::overwrite_existing);
+    PackageImage image(path);
+    ASSERT_EQ(image.size(), package->size());
+
+    // The package is truncated and rewritten, the image keeps the original
+    std::filesystem::resize_file(path, 0);
+    std::ofstream(path, std::ios::binary | std::ios::trunc) << "rewritten";
+    std::filesystem::remove(path);
+    ASSERT_EQ(image.size(), package->size());
+    EXPECT_TRUE(std::ranges::equal(image.data(), package->data()));
+}
+
+TEST(DeviceUpdater, AlignTransferSize)
+{
+    // 4091 + 5 bytes of overhead fill 64 packets of 64 bytes
+    EXPECT_EQ(DeviceUpdater::alignTransferSize(4096, 64), 4091);
+    EXPECT_EQ(DeviceUpdater::alignTransferSize(4091, 64), 4091);
+    EXPECT_EQ(DeviceUpdater::alignTransferSize(4090, 64), 4027);
+    EXPECT_EQ(DeviceUpdater::alignTransferSize(59, 64), 59);
+    EXPECT_EQ(DeviceUpdater::alignTransferSize(128, 32), 123);
+    EXPECT_EQ(DeviceUpdater::alignTransferSize(4096, 0), 4096);
+    // No aligned size is at least the baseline transfer size
+    EXPECT_EQ(DeviceUpdater::alignTransferSize(40, 64), 40);
+}
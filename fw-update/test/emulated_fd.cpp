@@ -0,0 +1,445 @@
+#include "emulated_fd.hpp"
+
+#include <endian.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <system_error>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+namespace
+{
+
+constexpr std::string_view activeVersion{"EmulatedFD"};
+constexpr std::string_view activeCompVersion{"0.0"};
+
+template <typename T>
+void put(std::vector<uint8_t>& msg, T value)
+{
+    if constexpr (sizeof(T) == 2)
+    {
+        value = htole16(value);
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        value = htole32(value);
+    }
+    else if constexpr (sizeof(T) == 8)
+    {
+        value = htole64(value);
+    }
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&value);
+    msg.insert(msg.end(), bytes, bytes + sizeof(T));
+}
+
+void put(std::vector<uint8_t>& msg, std::string_view str)
+{
+    msg.insert(msg.end(), str.begin(), str.end());
+}
+
+template <typename T>
+T get(const uint8_t* payload, size_t offset)
+{
+    T value;
+    std::memcpy(&value, payload + offset, sizeof(T));
+    if constexpr (sizeof(T) == 2)
+    {
+        return le16toh(value);
+    }
+    else if constexpr (sizeof(T) == 4)
+    {
+        return le32toh(value);
+    }
+    return value;
+}
+
+} // namespace
+
+std::vector<uint8_t> EmulatedFd::message(MessageType type, uint8_t instanceId,
+                                         uint8_t command, size_t payloadLength)
+{
+    std::vector<uint8_t> msg(sizeof(pldm_msg_hdr));
+    msg.reserve(sizeof(pldm_msg_hdr) + payloadLength);
+    pldm_header_info header{};
+    header.msg_type = type;
+    header.instance = instanceId;
+    header.pldm_type = PLDM_FWUP;
+    header.command = command;
+    pack_pldm_header(&header, reinterpret_cast<pldm_msg_hdr*>(msg.data()));
+    return msg;
+}
+
+void EmulatedFd::receive(const pldm_msg* msg, size_t msgLen)
+{
+    if (msg->hdr.type != PLDM_FWUP)
+    {
+        return;
+    }
+
+    if (msg->hdr.request)
+    {
+        handleRequest(msg, msgLen);
+    }
+    else
+    {
+        handleResponse(msg, msgLen);
+    }
+}
+
+std::vector<uint8_t> EmulatedFd::queryDeviceIdentifiers() const
+{
+    std::vector<uint8_t> descriptors;
+    for (const auto& [type, value] : config.descriptors)
+    {
+        put<uint16_t>(descriptors, type);
+        if (const auto* data = std::get_if<DescriptorData>(&value))
+        {
+            put<uint16_t>(descriptors, data->size());
+            descriptors.insert(descriptors.end(), data->begin(), data->end());
+        }
+        else
+        {
+            const auto& [title, vendorData] =
+                std::get<VendorDefinedDescriptorInfo>(value);
+            put<uint16_t>(descriptors, 2 + title.size() + vendorData.size());
+            put<uint8_t>(descriptors, PLDM_STR_TYPE_ASCII);
+            put<uint8_t>(descriptors, title.size());
+            put(descriptors, title);
+            descriptors.insert(descriptors.end(), vendorData.begin(),
+                               vendorData.end());
+        }
+    }
+
+    auto response = message(PLDM_RESPONSE, 0, PLDM_QUERY_DEVICE_IDENTIFIERS,
+                            6 + descriptors.size());
+    put<uint8_t>(response, PLDM_SUCCESS);
+    put<uint32_t>(response, descriptors.size());
+    put<uint8_t>(response, config.descriptors.size());
+    response.insert(response.end(), descriptors.begin(), descriptors.end());
+    return response;
+}
+
+std::vector<uint8_t> EmulatedFd::getFirmwareParameters() const
+{
+    auto response = message(PLDM_RESPONSE, 0, PLDM_GET_FIRMWARE_PARAMETERS,
+                            sizeof(pldm_get_firmware_parameters_resp) +
+                                activeVersion.size());
+    put<uint8_t>(response, PLDM_SUCCESS);
+    put<uint32_t>(response, 0); // CapabilitiesDuringUpdate
+    put<uint16_t>(response, config.components.size());
+    put<uint8_t>(response, PLDM_STR_TYPE_ASCII);
+    put<uint8_t>(response, activeVersion.size());
+    // No pending component image set
+    put<uint8_t>(response, PLDM_STR_TYPE_UNKNOWN);
+    put<uint8_t>(response, 0);
+    put(response, activeVersion);
+
+    for (const auto& component : config.components)
+    {
+        put<uint16_t>(response, component.classification);
+        put<uint16_t>(response, component.identifier);
+        put<uint8_t>(response, component.classificationIndex);
+        put<uint32_t>(response, 0); // ActiveComponentComparisonStamp
+        put<uint8_t>(response, PLDM_STR_TYPE_ASCII);
+        put<uint8_t>(response, activeCompVersion.size());
+        response.insert(response.end(), 8, 0); // ActiveComponentReleaseDate
+        put<uint32_t>(response, 0);            // PendingComponentComparisonStamp
+        put<uint8_t>(response, PLDM_STR_TYPE_UNKNOWN);
+        put<uint8_t>(response, 0);
+        response.insert(response.end(), 8, 0); // PendingComponentReleaseDate
+        put<uint16_t>(response, 0);            // ComponentActivationMethods
+        put<uint32_t>(response, 0);            // CapabilitiesDuringUpdate
+        put(response, activeCompVersion);
+    }
+    return response;
+}
+
+void EmulatedFd::handleRequest(const pldm_msg* request, size_t reqLen)
+{
+    if (chance(config.dropRate))
+    {
+        stats.dropped++;
+        return;
+    }
+
+    const auto command = request->hdr.command;
+    const auto* payload = request->payload;
+    std::vector<uint8_t> response;
+
+    switch (command)
+    {
+        case PLDM_QUERY_DEVICE_IDENTIFIERS:
+            stats.inventoryQueries++;
+            response = queryDeviceIdentifiers();
+            break;
+        case PLDM_GET_FIRMWARE_PARAMETERS:
+            response = getFirmwareParameters();
+            break;
+        case PLDM_REQUEST_UPDATE:
+            if (reqLen < sizeof(pldm_request_update_req))
+            {
+                response = message(PLDM_RESPONSE, 0, command, 1);
+                put<uint8_t>(response, PLDM_ERROR_INVALID_LENGTH);
+                break;
+            }
+            maxTransferSize = get<uint32_t>(payload, 0);
+            stats.aborted = false;
+            response = message(PLDM_RESPONSE, 0, command,
+                               sizeof(pldm_request_update_resp));
+            put<uint8_t>(response, PLDM_SUCCESS);
+            put<uint16_t>(response, 0); // FirmwareDeviceMetaDataLength
+            put<uint8_t>(response, 0);  // FDWillSendGetPackageDataCommand
+            break;
+        case PLDM_PASS_COMPONENT_TABLE:
+            response = message(PLDM_RESPONSE, 0, command,
+                               sizeof(pldm_pass_component_table_resp));
+            put<uint8_t>(response, PLDM_SUCCESS);
+            put<uint8_t>(response, PLDM_CR_COMP_CAN_BE_UPDATED);
+            put<uint8_t>(response, PLDM_CRC_COMP_CAN_BE_UPDATED);
+            break;
+        case PLDM_UPDATE_COMPONENT:
+            if (reqLen < sizeof(pldm_update_component_req))
+            {
+                response = message(PLDM_RESPONSE, 0, command, 1);
+                put<uint8_t>(response, PLDM_ERROR_INVALID_LENGTH);
+                break;
+            }
+            compSize = get<uint32_t>(
+                payload, offsetof(pldm_update_component_req, comp_image_size));
+            offset = 0;
+            response = message(PLDM_RESPONSE, 0, command,
+                               sizeof(pldm_update_component_resp));
+            put<uint8_t>(response, PLDM_SUCCESS);
+            put<uint8_t>(response, PLDM_CCR_COMP_CAN_BE_UPDATED);
+            put<uint8_t>(response, PLDM_CCRC_NO_RESPONSE_CODE);
+            put<uint32_t>(response, 0); // UpdateOptionFlagsEnabled
+            put<uint16_t>(response, 0); // TimeBeforeRequestFWData
+            break;
+        case PLDM_ACTIVATE_FIRMWARE:
+            stats.activated = true;
+            stats.finishTime = std::chrono::steady_clock::now();
+            response = message(PLDM_RESPONSE, 0, command,
+                               sizeof(pldm_activate_firmware_resp));
+            put<uint8_t>(response, PLDM_SUCCESS);
+            put<uint16_t>(response, 0); // EstimatedTimeForSelfContainedActivation
+            break;
+        case PLDM_CANCEL_UPDATE:
+            compSize = 0;
+            length = 0;
+            stats.aborted = true;
+            stats.finishTime = std::chrono::steady_clock::now();
+            response = message(PLDM_RESPONSE, 0, command,
+                               sizeof(pldm_cancel_update_resp));
+            put<uint8_t>(response, PLDM_SUCCESS);
+            put<uint8_t>(response, 0);  // NonFunctioningComponentIndication
+            put<uint64_t>(response, 0); // NonFunctioningComponentBitmap
+            break;
+        default:
+            response = message(PLDM_RESPONSE, 0, command, 1);
+            put<uint8_t>(response, PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+            break;
+    }
+
+    reinterpret_cast<pldm_msg*>(response.data())->hdr.instance_id =
+        request->hdr.instance_id;
+    send(std::move(response), std::chrono::microseconds(0));
+
+    if (command == PLDM_UPDATE_COMPONENT && compSize)
+    {
+        requestNext(std::chrono::microseconds(0));
+    }
+}
+
+void EmulatedFd::handleResponse(const pldm_msg* response, size_t respLen)
+{
+    if (respLen < 1 || response->hdr.instance_id != instanceId)
+    {
+        return;
+    }
+
+    const auto completionCode = response->payload[0];
+    switch (response->hdr.command)
+    {
+        case PLDM_REQUEST_FIRMWARE_DATA:
+            if (!length)
+            {
+                return;
+            }
+            if (completionCode != PLDM_SUCCESS)
+            {
+                // The UA cancelled the update, wait for CancelUpdate
+                length = 0;
+                return;
+            }
+            stats.bytesReceived += length;
+            stats.chunks++;
+            if (chance(config.repeatRate))
+            {
+                stats.repeated++;
+            }
+            else
+            {
+                offset += length;
+            }
+            length = 0;
+            requestNext(config.thinkTime);
+            break;
+        case PLDM_TRANSFER_COMPLETE:
+            if (!stats.aborted)
+            {
+                sendResult(PLDM_VERIFY_COMPLETE, PLDM_FWUP_VERIFY_SUCCESS);
+            }
+            break;
+        case PLDM_VERIFY_COMPLETE:
+            sendResult(PLDM_APPLY_COMPLETE, PLDM_FWUP_APPLY_SUCCESS);
+            break;
+        default:
+            break;
+    }
+}
+
+void EmulatedFd::requestNext(std::chrono::microseconds delay)
+{
+    if (config.abortAfter && stats.bytesReceived >= config.abortAfter)
+    {
+        compSize = 0;
+        stats.aborted = true;
+        stats.finishTime = std::chrono::steady_clock::now();
+        sendResult(PLDM_TRANSFER_COMPLETE, PLDM_FWUP_FD_ABORTED_TRANSFER);
+        return;
+    }
+    if (config.stallAfter && stats.bytesReceived >= config.stallAfter)
+    {
+        return;
+    }
+
+    if (offset >= compSize)
+    {
+        compSize = 0;
+        sendResult(PLDM_TRANSFER_COMPLETE, PLDM_FWUP_TRANSFER_SUCCESS);
+        return;
+    }
+
+    length = std::min(config.chunkSize, maxTransferSize);
+    // The last chunk is padded up to the baseline transfer size
+    length = std::max<uint32_t>(std::min(length, compSize - offset),
+                                PLDM_FWUP_BASELINE_TRANSFER_SIZE);
+
+    instanceId = (instanceId + 1) % 32;
+    auto request = message(PLDM_REQUEST, instanceId,
+                           PLDM_REQUEST_FIRMWARE_DATA,
+                           sizeof(pldm_request_firmware_data_req));
+    put<uint32_t>(request, offset);
+    put<uint32_t>(request, length);
+    send(std::move(request), delay);
+}
+
+void EmulatedFd::sendResult(uint8_t command, uint8_t result)
+{
+    instanceId = (instanceId + 1) % 32;
+    auto request = message(PLDM_REQUEST, instanceId, command,
+                           command == PLDM_APPLY_COMPLETE ? 3 : 1);
+    put<uint8_t>(request, result);
+    if (command == PLDM_APPLY_COMPLETE)
+    {
+        put<uint16_t>(request, 0); // ComponentActivationMethodsModification
+    }
+    send(std::move(request), std::chrono::microseconds(0));
+}
+
+EmulatedNetwork::EmulatedNetwork() :
+    timerFd(timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC))
+{
+    if (timerFd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(),
+                                "timerfd_create");
+    }
+}
+
+EmulatedNetwork::~EmulatedNetwork()
+{
+    ::close(timerFd);
+}
+
+EmulatedNetwork& EmulatedNetwork::get()
+{
+    static EmulatedNetwork network;
+    return network;
+}
+
+EmulatedFd& EmulatedNetwork::add(mctp_eid_t eid, const EmulatedFdConfig& config)
+{
+    auto send = [this, eid](std::vector<uint8_t>&& msg,
+                            std::chrono::microseconds delay) {
+        queue.emplace(std::chrono::steady_clock::now() + delay,
+                      Message{eid, std::move(msg)});
+        arm();
+    };
+    auto& fd = fds[eid];
+    fd = std::make_unique<EmulatedFd>(config, std::move(send), eid);
+    return *fd;
+}
+
+void EmulatedNetwork::toDevice(mctp_eid_t eid, const void* msg, size_t len)
+{
+    auto it = fds.find(eid);
+    if (it == fds.end() || len < sizeof(pldm_msg_hdr))
+    {
+        return;
+    }
+    it->second->receive(static_cast<const pldm_msg*>(msg),
+                        len - sizeof(pldm_msg_hdr));
+}
+
+bool EmulatedNetwork::fromDevice(mctp_eid_t& eid, void*& msg, size_t& len)
+{
+    uint64_t expirations;
+    [[maybe_unused]] auto rc = ::read(timerFd, &expirations,
+                                      sizeof(expirations));
+
+    if (queue.empty() ||
+        queue.begin()->first > std::chrono::steady_clock::now())
+    {
+        arm();
+        return false;
+    }
+
+    auto node = queue.extract(queue.begin());
+    auto& data = node.mapped().data;
+    eid = node.mapped().eid;
+    len = data.size();
+    msg = std::malloc(len);
+    std::memcpy(msg, data.data(), len);
+    arm();
+    return true;
+}
+
+void EmulatedNetwork::arm()
+{
+    itimerspec spec{};
+    if (!queue.empty())
+    {
+        auto due = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            queue.begin()->first - std::chrono::steady_clock::now());
+        // A zero it_value disarms the timer, so due messages fire after 1ns
+        due = std::max(due, std::chrono::nanoseconds(1));
+        spec.it_value.tv_sec = due.count() / 1000000000;
+        spec.it_value.tv_nsec = due.count() % 1000000000;
+    }
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+}
+
+} // namespace fw_update
+
+} // namespace pldm
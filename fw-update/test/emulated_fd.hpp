@@ -0,0 +1,230 @@
+#pragma once
+
+#include "common/types.hpp"
+
+#include <libpldm/base.h>
+#include <libpldm/firmware_update.h>
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @brief Component of an emulated firmware device */
+struct EmulatedComponent
+{
+    CompClassification classification;
+    CompIdentifier identifier;
+    CompClassificationIndex classificationIndex;
+};
+
+/** @brief Behaviour of an emulated firmware device */
+struct EmulatedFdConfig
+{
+    /** @brief Descriptors returned by QueryDeviceIdentifiers */
+    Descriptors descriptors;
+    /** @brief Components returned by GetFirmwareParameters */
+    std::vector<EmulatedComponent> components;
+    /** @brief Bytes requested per RequestFirmwareData, capped by the
+     *         MaximumTransferSize the UA passes in RequestUpdate
+     */
+    uint32_t chunkSize = PLDM_FWUP_BASELINE_TRANSFER_SIZE;
+    /** @brief Delay between a RequestFirmwareData response and the next
+     *         request, the time the FD takes to consume a chunk
+     */
+    std::chrono::microseconds thinkTime{0};
+    /** @brief Probability that a request from the UA is dropped unanswered */
+    double dropRate = 0;
+    /** @brief Probability that a chunk is requested a second time */
+    double repeatRate = 0;
+    /** @brief Abort the transfer with TransferComplete after this many bytes,
+     *         0 never aborts
+     */
+    uint64_t abortAfter = 0;
+    /** @brief Stop requesting firmware data after this many bytes, without
+     *         reporting the end of the transfer, 0 never stalls
+     */
+    uint64_t stallAfter = 0;
+};
+
+/** @brief What an emulated firmware device went through */
+struct EmulatedFdStats
+{
+    uint64_t inventoryQueries = 0;
+    uint64_t bytesReceived = 0;
+    uint64_t chunks = 0;
+    uint64_t dropped = 0;
+    uint64_t repeated = 0;
+    bool activated = false;
+    bool aborted = false;
+    std::chrono::steady_clock::time_point finishTime;
+};
+
+/** @class EmulatedFd
+ *
+ *  @brief A PLDM for firmware update (type 5) firmware device in software
+ *
+ *  Answers the inventory and update commands of the UA, then pulls each
+ *  component with RequestFirmwareData and reports TransferComplete,
+ *  VerifyComplete and ApplyComplete. Messages are exchanged through the
+ *  Send callback, so the FD can sit behind any transport.
+ */
+class EmulatedFd
+{
+  public:
+    /** @brief Sends a message from the FD after the given delay */
+    using Send = std::function<void(std::vector<uint8_t>&& msg,
+                                    std::chrono::microseconds delay)>;
+
+    EmulatedFd() = delete;
+    EmulatedFd(const EmulatedFd&) = delete;
+    EmulatedFd(EmulatedFd&&) = delete;
+    EmulatedFd& operator=(const EmulatedFd&) = delete;
+    EmulatedFd& operator=(EmulatedFd&&) = delete;
+    ~EmulatedFd() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] config - behaviour of the FD
+     *  @param[in] send - sends the messages of the FD to the UA
+     *  @param[in] seed - seed of the failure injection
+     */
+    EmulatedFd(const EmulatedFdConfig& config, Send send, unsigned seed) :
+        config(config), send(std::move(send)), rng(seed)
+    {}
+
+    /** @brief Handle a message from the UA
+     *
+     *  @param[in] msg - PLDM message
+     *  @param[in] msgLen - length of the message payload
+     */
+    void receive(const pldm_msg* msg, size_t msgLen);
+
+    const EmulatedFdStats& getStats() const
+    {
+        return stats;
+    }
+
+    /** @brief The FD activated its firmware or aborted the update */
+    bool finished() const
+    {
+        return stats.activated || stats.aborted;
+    }
+
+  private:
+    void handleRequest(const pldm_msg* request, size_t reqLen);
+    void handleResponse(const pldm_msg* response, size_t respLen);
+
+    std::vector<uint8_t> queryDeviceIdentifiers() const;
+    std::vector<uint8_t> getFirmwareParameters() const;
+
+    /** @brief Request the next chunk of the component in transfer, or report
+     *         the end of the transfer
+     */
+    void requestNext(std::chrono::microseconds delay);
+
+    /** @brief Send a request carrying a single result byte */
+    void sendResult(uint8_t command, uint8_t result);
+
+    /** @brief Build a PLDM message with its header filled in */
+    static std::vector<uint8_t> message(MessageType type, uint8_t instanceId,
+                                        uint8_t command, size_t payloadLength);
+
+    bool chance(double probability)
+    {
+        return probability > 0 &&
+               std::uniform_real_distribution<>(0, 1)(rng) < probability;
+    }
+
+    EmulatedFdConfig config;
+    Send send;
+    std::mt19937 rng;
+    EmulatedFdStats stats;
+
+    uint32_t maxTransferSize = PLDM_FWUP_BASELINE_TRANSFER_SIZE;
+    uint32_t compSize = 0;
+    uint32_t offset = 0;
+    /** @brief length of the outstanding RequestFirmwareData */
+    uint32_t length = 0;
+    uint8_t instanceId = 0;
+};
+
+/** @class EmulatedNetwork
+ *
+ *  @brief Connects emulated firmware devices to the local PLDM transport
+ *
+ *  Messages for the UA are queued with the time they become due. The
+ *  transport's event source is a timerfd armed for the earliest of them.
+ */
+class EmulatedNetwork
+{
+  public:
+    EmulatedNetwork(const EmulatedNetwork&) = delete;
+    EmulatedNetwork(EmulatedNetwork&&) = delete;
+    EmulatedNetwork& operator=(const EmulatedNetwork&) = delete;
+    EmulatedNetwork& operator=(EmulatedNetwork&&) = delete;
+    ~EmulatedNetwork();
+
+    /** @brief The network the local transport is attached to */
+    static EmulatedNetwork& get();
+
+    /** @brief Attach an emulated FD
+     *
+     *  @param[in] eid - MCTP endpoint ID of the FD
+     *  @param[in] config - behaviour of the FD
+     */
+    EmulatedFd& add(mctp_eid_t eid, const EmulatedFdConfig& config);
+
+    const std::map<mctp_eid_t, std::unique_ptr<EmulatedFd>>& devices() const
+    {
+        return fds;
+    }
+
+    /** @brief File descriptor readable when a message for the UA is due */
+    int eventSource() const
+    {
+        return timerFd;
+    }
+
+    /** @brief Deliver a message from the UA to an FD */
+    void toDevice(mctp_eid_t eid, const void* msg, size_t len);
+
+    /** @brief Take the next due message for the UA
+     *
+     *  @param[out] eid - MCTP endpoint ID of the sending FD
+     *  @param[out] msg - the message, to be released with free()
+     *  @param[out] len - length of the message
+     *
+     *  @return false if no message is due
+     */
+    bool fromDevice(mctp_eid_t& eid, void*& msg, size_t& len);
+
+  private:
+    EmulatedNetwork();
+
+    struct Message
+    {
+        mctp_eid_t eid;
+        std::vector<uint8_t> data;
+    };
+
+    /** @brief Arm the timerfd for the earliest queued message */
+    void arm();
+
+    int timerFd;
+    std::map<mctp_eid_t, std::unique_ptr<EmulatedFd>> fds;
+    std::multimap<std::chrono::steady_clock::time_point, Message> queue;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,37 @@
+#include "emulated_transport.hpp"
+
+#include "emulated_fd.hpp"
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+int EmulatedTransport::getEventSource() const
+{
+    return EmulatedNetwork::get().eventSource();
+}
+
+pldm_requester_rc_t EmulatedTransport::sendMsg(pldm_tid_t tid, const void* tx,
+                                               size_t len)
+{
+    EmulatedNetwork::get().toDevice(tid, tx, len);
+    return PLDM_REQUESTER_SUCCESS;
+}
+
+pldm_requester_rc_t EmulatedTransport::recvMsg(pldm_tid_t& tid, void*& rx,
+                                               size_t& len)
+{
+    mctp_eid_t eid;
+    if (!EmulatedNetwork::get().fromDevice(eid, rx, len))
+    {
+        return PLDM_REQUESTER_RECV_FAIL;
+    }
+    tid = eid;
+    return PLDM_REQUESTER_SUCCESS;
+}
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "common/transport.hpp"
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @class EmulatedTransport
+ *
+ *  @brief PldmTransport attached to the EmulatedNetwork instead of MCTP
+ */
+class EmulatedTransport : public PldmTransport
+{
+  public:
+    EmulatedTransport(const EmulatedTransport&) = delete;
+    EmulatedTransport(EmulatedTransport&&) = delete;
+    EmulatedTransport& operator=(const EmulatedTransport&) = delete;
+    EmulatedTransport& operator=(EmulatedTransport&&) = delete;
+    ~EmulatedTransport() override = default;
+
+    EmulatedTransport() : PldmTransport(nullptr) {}
+
+    int getEventSource() const override;
+
+    pldm_requester_rc_t sendMsg(pldm_tid_t tid, const void* tx,
+                                size_t len) override;
+
+    pldm_requester_rc_t recvMsg(pldm_tid_t& tid, void*& rx,
+                                size_t& len) override;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,295 @@
+/* Firmware update throughput against emulated firmware devices
+ *
+ * The update manager runs unmodified on the event loop. The transport is
+ * an EmulatedTransport, attached to the EmulatedNetwork which delivers the
+ * messages of N EmulatedFd instances. The package is served as in pldmd,
+ * only the MCTP link is emulated, so the result measures the UA side of the
+ * update: bytes/s, CPU time per MB and time to activation.
+ */
+
+#include "common/utils.hpp"
+#include "emulated_fd.hpp"
+#include "emulated_transport.hpp"
+#include "fw-update/inventory_manager.hpp"
+#include "fw-update/package_image.hpp"
+#include "fw-update/package_parser.hpp"
+#include "fw-update/update_manager.hpp"
+#include "requester/handler.hpp"
+#include "requester/request.hpp"
+#include "test/test_instance_id.hpp"
+
+#include <libpldm/base.h>
+#include <sys/resource.h>
+
+#include <CLI/CLI.hpp>
+#include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+using namespace pldm;
+using namespace pldm::fw_update;
+
+namespace
+{
+
+constexpr mctp_eid_t firstEid = 8;
+
+std::chrono::duration<double> cpuTime()
+{
+    rusage usage{};
+    getrusage(RUSAGE_SELF, &usage);
+    return std::chrono::seconds(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) +
+           std::chrono::microseconds(usage.ru_utime.tv_usec +
+                                     usage.ru_stime.tv_usec);
+}
+
+/** @brief Run the event loop until done() holds or the deadline passes
+ *
+ *  @return false on timeout
+ */
+template <typename Done>
+bool runUntil(sdeventplus::Event& event, Done done,
+              std::chrono::steady_clock::time_point deadline)
+{
+    while (!done())
+    {
+        auto now = std::chrono::steady_clock::now();
+        if (now >= deadline)
+        {
+            return false;
+        }
+        event.run(std::chrono::duration_cast<sdeventplus::SdEventDuration>(
+            std::min<std::chrono::steady_clock::duration>(
+                deadline - now, std::chrono::milliseconds(100))));
+    }
+    return true;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Benchmark PLDM firmware update against emulated devices"};
+    size_t fdCount = 1;
+    app.add_option("-n,--fds", fdCount, "Number of emulated firmware devices")
+        ->check(CLI::Range(1, 247));
+    std::string packagePath{"./test_pkg"};
+    app.add_option("-p,--package", packagePath, "PLDM firmware update package")
+        ->check(CLI::ExistingFile);
+    EmulatedFdConfig config;
+    app.add_option("-c,--chunk-size", config.chunkSize,
+                   "Bytes requested per RequestFirmwareData")
+        ->check(CLI::Range(uint32_t(PLDM_FWUP_BASELINE_TRANSFER_SIZE),
+                           std::numeric_limits<uint32_t>::max()));
+    uint64_t thinkTime = 0;
+    app.add_option("--think-time", thinkTime,
+                   "Microseconds an FD takes to consume a chunk");
+    app.add_option("--drop-rate", config.dropRate,
+                   "Probability that an FD drops a request of the UA")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--repeat-rate", config.repeatRate,
+                   "Probability that an FD requests a chunk again")
+        ->check(CLI::Range(0.0, 1.0));
+    app.add_option("--abort-after", config.abortAfter,
+                   "Bytes after which an FD aborts the transfer, 0 never");
+    uint64_t timeout = 600;
+    app.add_option("-t,--timeout", timeout, "Seconds before giving up");
+    CLI11_PARSE(app, argc, argv);
+    config.thinkTime = std::chrono::microseconds(thinkTime);
+
+    // The emulated devices identify as the first record of the package
+    try
+    {
+        PackageImage package(packagePath);
+        auto parser = parsePkgHeader(package.data());
+        if (!parser)
+        {
+            throw std::runtime_error("invalid package header information");
+        }
+        parser->parse(package.read(0, parser->pkgHeaderSize), package.size());
+
+        const auto& record = parser->getFwDeviceIDRecords().front();
+        const auto& compImageInfos = parser->getComponentImageInfos();
+        config.descriptors = std::get<Descriptors>(record);
+        for (auto index : std::get<ApplicableComponents>(record))
+        {
+            const auto& comp = compImageInfos[index];
+            config.components.push_back(
+                {std::get<static_cast<size_t>(
+                     ComponentImageInfoPos::CompClassificationPos)>(comp),
+                 std::get<static_cast<size_t>(
+                     ComponentImageInfoPos::CompIdentifierPos)>(comp),
+                 0});
+        }
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to parse the package {PATH}: {ERROR}", "PATH",
+              packagePath, "ERROR", e);
+        return EXIT_FAILURE;
+    }
+
+    auto& network = EmulatedNetwork::get();
+    std::vector<mctp_eid_t> eids;
+    for (size_t i = 0; i < fdCount; i++)
+    {
+        eids.push_back(firstEid + i);
+        network.add(eids.back(), config);
+    }
+
+    auto event = sdeventplus::Event::get_default();
+    TestInstanceIdDb instanceIdDb;
+    EmulatedTransport transport;
+    requester::Handler<requester::Request> handler(&transport, event,
+                                                   instanceIdDb, false);
+
+    DescriptorMap descriptorMap;
+    ComponentInfoMap componentInfoMap;
+    EndpointRoutes endpointRoutes;
+    PendingCompVersionMap pendingCompVersionMap;
+    InventoryManager inventoryManager(handler, instanceIdDb, descriptorMap,
+                                      componentInfoMap, pendingCompVersionMap);
+    std::filesystem::create_directories("/tmp/images");
+    UpdateManager updateManager(event, handler, instanceIdDb, descriptorMap,
+                                componentInfoMap, endpointRoutes,
+                                pendingCompVersionMap);
+    for (auto eid : eids)
+    {
+        updateManager.checkpoints.remove(eid);
+    }
+
+    // The receive path of pldmd, for the firmware update type only
+    auto callback = [&](sdeventplus::source::IO& /*io*/, int /*fd*/,
+                        uint32_t revents) {
+        if (!(revents & EPOLLIN))
+        {
+            return;
+        }
+        pldm_tid_t tid;
+        void* msg;
+        size_t len;
+        if (transport.recvMsg(tid, msg, len) != PLDM_REQUESTER_SUCCESS)
+        {
+            return;
+        }
+        std::unique_ptr<void, decltype(&free)> msgPtr(msg, free);
+        auto pldmMsg = static_cast<const pldm_msg*>(msg);
+        pldm_header_info hdrFields{};
+        if (PLDM_SUCCESS != unpack_pldm_header(&pldmMsg->hdr, &hdrFields) ||
+            hdrFields.pldm_type != PLDM_FWUP)
+        {
+            return;
+        }
+        auto payloadLength = len - sizeof(pldm_msg_hdr);
+        if (hdrFields.msg_type == PLDM_RESPONSE)
+        {
+            handler.handleResponse(tid, hdrFields.instance,
+                                   hdrFields.pldm_type, hdrFields.command,
+                                   pldmMsg, payloadLength);
+            return;
+        }
+        auto response = updateManager.handleRequest(tid, hdrFields.command,
+                                                    pldmMsg, payloadLength);
+        transport.sendMsg(tid, response.data(), response.size());
+    };
+    sdeventplus::source::IO io(event, transport.getEventSource(), EPOLLIN,
+                               std::move(callback));
+
+    auto deadline = std::chrono::steady_clock::now() +
+                    std::chrono::seconds(timeout);
+    auto inventoried = [&] { return componentInfoMap.size() == eids.size(); };
+    inventoryManager.discoverFDs(eids);
+    if (!runUntil(event, inventoried, deadline))
+    {
+        error("Inventory of the emulated devices failed, DISCOVERED={COUNT}",
+              "COUNT", componentInfoMap.size());
+        return EXIT_FAILURE;
+    }
+
+    // processPackage() removes packages it rejects, so hand it a copy
+    auto stagedPath = std::filesystem::temp_directory_path() /
+                      "fw_update_benchmark_pkg";
+    std::filesystem::copy_file(packagePath, stagedPath,
+                               std::filesystem::copy_options::overwrite_existing);
+    if (updateManager.processPackage(stagedPath))
+    {
+        error("The package was rejected");
+        std::filesystem::remove(stagedPath);
+        return EXIT_FAILURE;
+    }
+
+    auto startCpu = cpuTime();
+    auto start = std::chrono::steady_clock::now();
+    updateManager.activatePackage();
+    auto allFinished = [&] {
+        return std::ranges::all_of(network.devices(), [](const auto& fd) {
+            return fd.second->finished();
+        });
+    };
+    auto finished = runUntil(event, allFinished, deadline);
+    auto elapsed = std::chrono::duration<double>(
+        std::chrono::steady_clock::now() - start);
+    auto cpu = cpuTime() - startCpu;
+    std::filesystem::remove(stagedPath);
+    for (auto eid : eids)
+    {
+        updateManager.checkpoints.remove(eid);
+    }
+
+    uint64_t bytes = 0;
+    uint64_t chunks = 0;
+    uint64_t dropped = 0;
+    uint64_t repeated = 0;
+    size_t activated = 0;
+    std::chrono::duration<double> lastActivation{0};
+    for (const auto& [eid, fd] : network.devices())
+    {
+        const auto& stats = fd->getStats();
+        bytes += stats.bytesReceived;
+        chunks += stats.chunks;
+        dropped += stats.dropped;
+        repeated += stats.repeated;
+        if (stats.activated)
+        {
+            activated++;
+            lastActivation = std::max<std::chrono::duration<double>>(
+                lastActivation, stats.finishTime - start);
+        }
+    }
+
+    auto mb = bytes / (1024.0 * 1024.0);
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "devices            " << fdCount << "\n";
+    std::cout << "activated          " << activated << "\n";
+    std::cout << "bytes              " << bytes << "\n";
+    std::cout << "chunks             " << chunks << "\n";
+    std::cout << "dropped requests   " << dropped << "\n";
+    std::cout << "repeated chunks    " << repeated << "\n";
+    std::cout << "elapsed s          " << elapsed.count() << "\n";
+    std::cout << "throughput MB/s    "
+              << (elapsed.count() > 0 ? mb / elapsed.count() : 0) << "\n";
+    // The emulated devices run in this process, their CPU time is included
+    std::cout << "cpu ms per MB      "
+              << (mb > 0 ? cpu.count() * 1000 / mb : 0) << "\n";
+    std::cout << "time to activate s " << lastActivation.count() << std::endl;
+
+    if (!finished)
+    {
+        error("Timed out waiting for the emulated devices");
+        return EXIT_FAILURE;
+    }
+    return config.abortAfter || activated == fdCount ? EXIT_SUCCESS
+                                                      : EXIT_FAILURE;
+}
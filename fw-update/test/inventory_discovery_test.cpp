@@ -0,0 +1,147 @@
+#include "emulated_fd.hpp"
+#include "emulated_transport.hpp"
+#include "fw-update/inventory_manager.hpp"
+#include "requester/handler.hpp"
+#include "requester/request.hpp"
+#include "test/test_instance_id.hpp"
+
+#include <libpldm/firmware_update.h>
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::fw_update;
+using namespace std::chrono;
+
+class InventoryDiscoveryTest : public testing::Test
+{
+  protected:
+    InventoryDiscoveryTest() :
+        event(sdeventplus::Event::get_default()),
+        handler(&transport, event, instanceIdDb, false, seconds(1), 2,
+                milliseconds(100)),
+        inventoryManager(handler, instanceIdDb, descriptorMap,
+                         componentInfoMap, pendingCompVersionMap, 2),
+        io(event, transport.getEventSource(), EPOLLIN,
+           std::bind_front(&InventoryDiscoveryTest::receive, this))
+    {
+        config.descriptors = {
+            {PLDM_FWUP_UUID,
+             std::vector<uint8_t>{0x16, 0x20, 0x23, 0xC9, 0x3E, 0xC5, 0x41,
+                                  0x15, 0x95, 0xF4, 0x48, 0x70, 0x1D, 0x49,
+                                  0xD6, 0x75}}};
+        config.components = {{10, 100, 1}};
+        for (auto eid : eids)
+        {
+            EmulatedNetwork::get().add(eid, config);
+            uuids.emplace(eid, "uuid-" + std::to_string(eid));
+        }
+    }
+
+    void receive(sdeventplus::source::IO& /*io*/, int /*fd*/,
+                 uint32_t /*revents*/)
+    {
+        pldm_tid_t tid;
+        void* msg;
+        size_t len;
+        if (transport.recvMsg(tid, msg, len) != PLDM_REQUESTER_SUCCESS)
+        {
+            return;
+        }
+        std::unique_ptr<void, decltype(&free)> msgPtr(msg, free);
+        auto response = static_cast<const pldm_msg*>(msg);
+        handler.handleResponse(tid, response->hdr.instance_id,
+                               response->hdr.type, response->hdr.command,
+                               response, len - sizeof(pldm_msg_hdr));
+    }
+
+    /** @brief Run the event loop until every FD is inventoried and the
+     *         exchanges in flight are over
+     */
+    bool runDiscovery()
+    {
+        auto deadline = steady_clock::now() + seconds(5);
+        while (componentInfoMap.size() < eids.size())
+        {
+            if (steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            event.run(milliseconds(10));
+        }
+        for (int i = 0; i < 100; i++)
+        {
+            event.run(milliseconds(1));
+        }
+        return true;
+    }
+
+    uint64_t queries(mctp_eid_t eid)
+    {
+        return EmulatedNetwork::get()
+            .devices()
+            .at(eid)
+            ->getStats()
+            .inventoryQueries;
+    }
+
+    const std::vector<mctp_eid_t> eids{8, 9, 10, 11, 12};
+    EndpointUUIDs uuids;
+    EmulatedFdConfig config;
+    sdeventplus::Event event;
+    TestInstanceIdDb instanceIdDb;
+    EmulatedTransport transport;
+    requester::Handler<requester::Request> handler;
+    DescriptorMap descriptorMap;
+    ComponentInfoMap componentInfoMap;
+    PendingCompVersionMap pendingCompVersionMap;
+    InventoryManager inventoryManager;
+    sdeventplus::source::IO io;
+};
+
+TEST_F(InventoryDiscoveryTest, BoundedFanOut)
+{
+    inventoryManager.discoverFDs(eids, uuids);
+    ASSERT_TRUE(runDiscovery());
+
+    for (auto eid : eids)
+    {
+        EXPECT_EQ(descriptorMap.at(eid), config.descriptors);
+        EXPECT_EQ(componentInfoMap.at(eid),
+                  (ComponentInfo{{std::make_pair(10, 100), 1}}));
+        EXPECT_EQ(queries(eid), 1);
+    }
+}
+
+TEST_F(InventoryDiscoveryTest, CachedByUUID)
+{
+    inventoryManager.discoverFDs(eids, uuids);
+    ASSERT_TRUE(runDiscovery());
+
+    // Same EIDs and UUIDs, nothing is queried
+    inventoryManager.discoverFDs(eids, uuids);
+    ASSERT_TRUE(runDiscovery());
+    for (auto eid : eids)
+    {
+        EXPECT_EQ(queries(eid), 1);
+    }
+
+    // Another device behind EID 8, EID 9 invalidated, EID 10 without UUID
+    uuids[8] = "uuid-replaced";
+    inventoryManager.invalidate(9);
+    uuids.erase(10);
+    inventoryManager.discoverFDs(eids, uuids);
+    ASSERT_TRUE(runDiscovery());
+    EXPECT_EQ(queries(8), 2);
+    EXPECT_EQ(queries(9), 2);
+    EXPECT_EQ(queries(10), 2);
+    EXPECT_EQ(queries(11), 1);
+    EXPECT_EQ(queries(12), 1);
+}
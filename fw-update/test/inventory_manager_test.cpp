@@ -19,7 +19,7 @@ class InventoryManagerTest : public testing::Test
         reqHandler(nullptr, event, instanceIdDb, false, seconds(1), 2,
                    milliseconds(100)),
         inventoryManager(reqHandler, instanceIdDb, outDescriptorMap,
-                         outComponentInfoMap)
+                         outComponentInfoMap, outPendingCompVersionMap)
     {}
 
     int fd = -1;
@@ -29,6 +29,7 @@ class InventoryManagerTest : public testing::Test
     InventoryManager inventoryManager;
     DescriptorMap outDescriptorMap{};
     ComponentInfoMap outComponentInfoMap{};
+    PendingCompVersionMap outPendingCompVersionMap{};
 };
 
 TEST_F(InventoryManagerTest, handleQueryDeviceIdentifiersResponse)
@@ -140,6 +141,7 @@ TEST_F(InventoryManagerTest, getFirmwareParametersResponse)
            compClassificationIndex2}}}};
     EXPECT_EQ(outComponentInfoMap.size(), componentInfoMap1.size());
     EXPECT_EQ(outComponentInfoMap, componentInfoMap1);
+    EXPECT_TRUE(outPendingCompVersionMap.at(1).empty());
 
     // constexpr uint16_t compCount = 1;
     // constexpr std::string_view activeCompImageSetVersion{"DeviceVer2.0"};
@@ -131,6 +131,34 @@ TEST(PackageParser, ValidPkgMultipleDescriptorsMultipleComponents)
         {10, 200, 0xFFFFFFFF, 0, 1, 353, 27, "VersionString6"},
         {16, 300, 0xFFFFFFFF, 1, 12, 380, 27, "VersionString7"}};
     EXPECT_EQ(outCompImageInfos, compImageInfos);
+
+    EXPECT_EQ(parser->getFwDeviceIDRecord(1), fwDeviceIDRecords[1]);
+
+    // The records are matched with the FD descriptors from their views
+    const auto& views = parser->getFwDeviceIDRecordViews();
+    ASSERT_EQ(views.size(), fwDeviceIDRecords.size());
+    for (size_t index = 0; index < views.size(); index++)
+    {
+        const auto& record = fwDeviceIDRecords[index];
+        const auto& descriptors = std::get<Descriptors>(record);
+        EXPECT_EQ(countApplicableComponents(views[index]),
+                  std::get<ApplicableComponents>(record).size());
+        EXPECT_EQ(hashInitialDescriptor(views[index]),
+                  hashDescriptor(PLDM_FWUP_UUID,
+                                 descriptors.at(PLDM_FWUP_UUID)));
+        EXPECT_TRUE(matchDescriptors(views[index], descriptors));
+    }
+
+    auto fdDescriptors = std::get<Descriptors>(fwDeviceIDRecords[0]);
+    fdDescriptors.emplace(PLDM_FWUP_IANA_ENTERPRISE_ID + 1,
+                          std::vector<uint8_t>{0x01});
+    EXPECT_TRUE(matchDescriptors(views[0], fdDescriptors));
+    EXPECT_FALSE(matchDescriptors(views[1], fdDescriptors));
+    fdDescriptors[PLDM_FWUP_VENDOR_DEFINED] =
+        std::make_tuple("OpenBMX", std::vector<uint8_t>{0x12, 0x34});
+    EXPECT_FALSE(matchDescriptors(views[0], fdDescriptors));
+    fdDescriptors.erase(PLDM_FWUP_VENDOR_DEFINED);
+    EXPECT_FALSE(matchDescriptors(views[0], fdDescriptors));
 }
 
 TEST(PackageParser, InvalidPkgHeaderInfoIncomplete)
@@ -0,0 +1,147 @@
+#include "common/utils.hpp"
+#include "fw-update/package_stager.hpp"
+
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::fw_update;
+
+class PackageStagerTest : public testing::Test
+{
+  protected:
+    PackageStagerTest() : event(sdeventplus::Event::get_default())
+    {
+        std::ifstream file("./test_pkg", std::ios::binary);
+        package.assign(std::istreambuf_iterator<char>(file),
+                       std::istreambuf_iterator<char>());
+        std::filesystem::create_directories(dir);
+    }
+
+    ~PackageStagerTest() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    /** @brief Write a package, with trailing bytes to change its content */
+    std::filesystem::path write(const std::string& name, size_t trailing = 0)
+    {
+        auto path = dir / name;
+        auto data = package;
+        data.resize(data.size() + trailing, 0xFF);
+        std::ofstream(path, std::ios::binary)
+            .write(reinterpret_cast<const char*>(data.data()), data.size());
+        return path;
+    }
+
+    /** @brief Run the event loop until the stager queued count times */
+    void waitForReady(size_t count)
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::seconds(5);
+        while (readyCount < count && std::chrono::steady_clock::now() < deadline)
+        {
+            event.run(std::chrono::milliseconds(100));
+        }
+    }
+
+    const std::filesystem::path dir{"./package_stager_test"};
+    sdeventplus::Event event;
+    std::vector<uint8_t> package;
+    size_t readyCount = 0;
+};
+
+TEST_F(PackageStagerTest, Stage)
+{
+    auto staged = PackageStager::stage(write("pkg"));
+    ASSERT_TRUE(staged.has_value());
+    ASSERT_NE(staged->parser, nullptr);
+    EXPECT_EQ(staged->package->size(), package.size());
+    EXPECT_EQ(staged->contentHash,
+              utils::crc32Final(utils::crc32Update(
+                  utils::crc32Init, package.data(), package.size())));
+    auto header = staged->package->read(0, staged->parser->pkgHeaderSize);
+    EXPECT_EQ(staged->headerHash,
+              utils::crc32Final(utils::crc32Update(
+                  utils::crc32Init, header.data(), header.size())));
+
+    // Not a firmware update package, removed
+    auto path = dir / "garbage";
+    std::ofstream(path) << "not a package";
+    EXPECT_FALSE(PackageStager::stage(path).has_value());
+    EXPECT_FALSE(std::filesystem::exists(path));
+}
+
+TEST_F(PackageStagerTest, Duplicate)
+{
+    PackageStager stager(event, 2, [this] { readyCount++; });
+
+    // Same content under another name, the copy is removed
+    auto first = write("first");
+    stager.add(first);
+    waitForReady(1);
+    auto copy = write("copy");
+    stager.add(copy);
+    waitForReady(2);
+    ASSERT_EQ(stager.size(), 1u);
+    EXPECT_TRUE(std::filesystem::exists(first));
+    EXPECT_FALSE(std::filesystem::exists(copy));
+
+    auto staged = stager.next();
+    ASSERT_TRUE(staged.has_value());
+    EXPECT_EQ(staged->path, first);
+    EXPECT_FALSE(stager.next().has_value());
+}
+
+TEST_F(PackageStagerTest, RewrittenAtSamePath)
+{
+    PackageStager stager(event, 2, [this] { readyCount++; });
+
+    auto path = write("pkg");
+    stager.add(path);
+    waitForReady(1);
+
+    // The new content replaces the queued package, the file is kept
+    write("pkg", 1);
+    stager.add(path);
+    waitForReady(2);
+    ASSERT_EQ(stager.size(), 1u);
+    EXPECT_TRUE(std::filesystem::exists(path));
+
+    auto staged = stager.next();
+    ASSERT_TRUE(staged.has_value());
+    EXPECT_EQ(staged->path, path);
+    EXPECT_EQ(staged->package->size(), package.size() + 1);
+    EXPECT_FALSE(stager.next().has_value());
+}
+
+TEST_F(PackageStagerTest, QueueFull)
+{
+    PackageStager stager(event, 2, [this] { readyCount++; });
+
+    // The queue holds two packages, the oldest is dropped
+    auto first = write("first");
+    stager.add(first);
+    waitForReady(1);
+    stager.add(write("second", 1));
+    waitForReady(2);
+    stager.add(write("third", 2));
+    waitForReady(3);
+    ASSERT_EQ(stager.size(), 2u);
+    EXPECT_FALSE(std::filesystem::exists(first));
+
+    auto staged = stager.next();
+    ASSERT_TRUE(staged.has_value());
+    EXPECT_EQ(staged->path, dir / "second");
+    staged = stager.next();
+    ASSERT_TRUE(staged.has_value());
+    EXPECT_EQ(staged->path, dir / "third");
+    EXPECT_FALSE(stager.next().has_value());
+}
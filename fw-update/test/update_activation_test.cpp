@@ -0,0 +1,188 @@
+#include "emulated_fd.hpp"
+#include "emulated_transport.hpp"
+#include "fw-update/update_manager.hpp"
+#include "requester/handler.hpp"
+#include "requester/request.hpp"
+#include "test/test_instance_id.hpp"
+
+#include <libpldm/firmware_update.h>
+
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <memory>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::fw_update;
+using namespace std::chrono;
+
+/** @brief Updates two emulated FDs with the test package */
+class UpdateActivationTest : public testing::Test
+{
+  protected:
+    UpdateActivationTest() :
+        event(sdeventplus::Event::get_default()),
+        handler(&transport, event, instanceIdDb, false, seconds(1), 2,
+                milliseconds(100)),
+        io(event, transport.getEventSource(), EPOLLIN,
+           std::bind_front(&UpdateActivationTest::receive, this))
+    {
+        // The FDs identify as the record of the test package
+        config.descriptors = {
+            {PLDM_FWUP_UUID,
+             std::vector<uint8_t>{0x16, 0x20, 0x23, 0xC9, 0x3E, 0xC5, 0x41,
+                                  0x15, 0x95, 0xF4, 0x48, 0x70, 0x1D, 0x49,
+                                  0xD6, 0x75}}};
+        config.components = {{10, 100, 1}};
+        for (auto eid : eids)
+        {
+            descriptorMap.emplace(eid, config.descriptors);
+            componentInfoMap.emplace(
+                eid, ComponentInfo{{std::make_pair(10, 100), 1}});
+        }
+    }
+
+    ~UpdateActivationTest() override
+    {
+        if (updateManager)
+        {
+            for (auto eid : eids)
+            {
+                updateManager->checkpoints.remove(eid);
+            }
+        }
+        std::filesystem::remove(stagedPath);
+    }
+
+    /** @brief The receive path of pldmd, for the firmware update type */
+    void receive(sdeventplus::source::IO& /*io*/, int /*fd*/,
+                 uint32_t /*revents*/)
+    {
+        pldm_tid_t tid;
+        void* msg;
+        size_t len;
+        if (transport.recvMsg(tid, msg, len) != PLDM_REQUESTER_SUCCESS)
+        {
+            return;
+        }
+        std::unique_ptr<void, decltype(&free)> msgPtr(msg, free);
+        auto pldmMsg = static_cast<const pldm_msg*>(msg);
+        auto payloadLength = len - sizeof(pldm_msg_hdr);
+        if (!pldmMsg->hdr.request)
+        {
+            handler.handleResponse(tid, pldmMsg->hdr.instance_id,
+                                   pldmMsg->hdr.type, pldmMsg->hdr.command,
+                                   pldmMsg, payloadLength);
+            return;
+        }
+        auto response = updateManager->handleRequest(
+            tid, pldmMsg->hdr.command, pldmMsg, payloadLength);
+        transport.sendMsg(tid, response.data(), response.size());
+    }
+
+    /** @brief Attach the FDs, the second one with its own behaviour, and
+     *         start the update manager
+     *
+     *  @param[in] secondConfig - behaviour of the second FD
+     *  @param[in] activationTimeout - time the activation waits without
+     *                                 progress from the FDs
+     */
+    void start(const EmulatedFdConfig& secondConfig,
+               seconds activationTimeout)
+    {
+        EmulatedNetwork::get().add(eids[0], config);
+        EmulatedNetwork::get().add(eids[1], secondConfig);
+        updateManager = std::make_unique<UpdateManager>(
+            event, handler, instanceIdDb, descriptorMap, componentInfoMap,
+            endpointRoutes, pendingCompVersionMap, nullptr,
+            activationTimeout);
+        for (auto eid : eids)
+        {
+            updateManager->checkpoints.remove(eid);
+        }
+    }
+
+    /** @brief Activate the test package and run the event loop until every
+     *         FD activated its firmware or aborted the update
+     */
+    bool runUpdate()
+    {
+        // processPackage() removes packages it rejects, so hand it a copy
+        std::filesystem::copy_file(
+            "./test_pkg", stagedPath,
+            std::filesystem::copy_options::overwrite_existing);
+        if (updateManager->processPackage(stagedPath))
+        {
+            return false;
+        }
+        updateManager->activatePackage();
+
+        auto deadline = steady_clock::now() + seconds(10);
+        while (!finished(eids[0]) || !finished(eids[1]))
+        {
+            if (steady_clock::now() >= deadline)
+            {
+                return false;
+            }
+            event.run(milliseconds(10));
+        }
+        return true;
+    }
+
+    const EmulatedFdStats& stats(mctp_eid_t eid)
+    {
+        return EmulatedNetwork::get().devices().at(eid)->getStats();
+    }
+
+    bool finished(mctp_eid_t eid)
+    {
+        return EmulatedNetwork::get().devices().at(eid)->finished();
+    }
+
+    const std::vector<mctp_eid_t> eids{8, 9};
+    const std::filesystem::path stagedPath =
+        std::filesystem::temp_directory_path() / "update_activation_test_pkg";
+    EmulatedFdConfig config;
+    sdeventplus::Event event;
+    TestInstanceIdDb instanceIdDb;
+    EmulatedTransport transport;
+    requester::Handler<requester::Request> handler;
+    DescriptorMap descriptorMap;
+    ComponentInfoMap componentInfoMap;
+    EndpointRoutes endpointRoutes;
+    PendingCompVersionMap pendingCompVersionMap;
+    sdeventplus::source::IO io;
+    std::unique_ptr<UpdateManager> updateManager;
+};
+
+TEST_F(UpdateActivationTest, FailedTransferDoesNotHoldBackActivation)
+{
+    // Well within the activation timeout, the FD that failed its transfer
+    // drops out and the other one is activated
+    auto failing = config;
+    failing.abortAfter = 256;
+    start(failing, seconds(60));
+    ASSERT_TRUE(runUpdate());
+
+    EXPECT_TRUE(stats(eids[0]).activated);
+    EXPECT_FALSE(stats(eids[1]).activated);
+    EXPECT_TRUE(stats(eids[1]).aborted);
+}
+
+TEST_F(UpdateActivationTest, StalledDeviceTimesOut)
+{
+    auto stalling = config;
+    stalling.stallAfter = 256;
+    start(stalling, seconds(1));
+    ASSERT_TRUE(runUpdate());
+
+    // The stalled FD is cancelled once the activation times out
+    EXPECT_TRUE(stats(eids[0]).activated);
+    EXPECT_FALSE(stats(eids[1]).activated);
+    EXPECT_TRUE(stats(eids[1]).aborted);
+}
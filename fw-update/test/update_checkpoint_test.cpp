@@ -0,0 +1,49 @@
+#include "fw-update/update_checkpoint.hpp"
+
+#include <filesystem>
+#include <fstream>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::fw_update;
+
+class UpdateCheckpointTest : public testing::Test
+{
+  protected:
+    UpdateCheckpointTest() : store(dir) {}
+
+    ~UpdateCheckpointTest() override
+    {
+        std::filesystem::remove_all(dir);
+    }
+
+    const std::filesystem::path dir{"./update_checkpoint_test"};
+    CheckpointStore store;
+};
+
+TEST_F(UpdateCheckpointTest, StoreAndLoad)
+{
+    EXPECT_FALSE(store.load(8).has_value());
+
+    UpdateCheckpoint checkpoint{0xDEADBEEF, 1 << 20, 2, 4096, {0, 1}};
+    store.store(8, checkpoint);
+    EXPECT_EQ(store.load(8), checkpoint);
+    EXPECT_FALSE(store.load(9).has_value());
+
+    checkpoint.offset = 8192;
+    store.store(8, checkpoint);
+    EXPECT_EQ(store.load(8), checkpoint);
+
+    store.remove(8);
+    EXPECT_FALSE(store.load(8).has_value());
+}
+
+TEST_F(UpdateCheckpointTest, CorruptCheckpoint)
+{
+    std::filesystem::create_directories(dir);
+    std::ofstream(dir / "8.json") << "{\"packageHash\": 1";
+    EXPECT_FALSE(store.load(8).has_value());
+
+    std::ofstream(dir / "8.json") << "{\"packageHash\": 1}";
+    EXPECT_FALSE(store.load(8).has_value());
+}
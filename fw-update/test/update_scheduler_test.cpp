@@ -0,0 +1,109 @@
+#include "fw-update/update_scheduler.hpp"
+
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::fw_update;
+
+class UpdateSchedulerTest : public testing::Test
+{
+  protected:
+    UpdateScheduler::StartUpdate record()
+    {
+        return [this](mctp_eid_t eid) { started.push_back(eid); };
+    }
+
+    std::vector<mctp_eid_t> started;
+};
+
+TEST_F(UpdateSchedulerTest, NoLimitStartsAll)
+{
+    UpdateScheduler scheduler(0, SchedulePolicy::LargestFirst, record());
+    scheduler.add(8, "/xyz/openbmc_project/mctp/1", 100);
+    scheduler.add(9, "/xyz/openbmc_project/mctp/1", 200);
+    scheduler.add(10, "/xyz/openbmc_project/mctp/1", 300);
+    EXPECT_TRUE(started.empty());
+
+    scheduler.start();
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{10, 9, 8}));
+    EXPECT_EQ(scheduler.active(), 3);
+    EXPECT_EQ(scheduler.waiting(), 0);
+}
+
+TEST_F(UpdateSchedulerTest, LimitPerRoute)
+{
+    UpdateScheduler scheduler(1, SchedulePolicy::LargestFirst, record());
+    scheduler.add(8, "/xyz/openbmc_project/mctp/1", 100);
+    scheduler.add(9, "/xyz/openbmc_project/mctp/1", 300);
+    scheduler.add(10, "/xyz/openbmc_project/mctp/2", 200);
+    scheduler.add(11, "/xyz/openbmc_project/mctp/2", 50);
+    scheduler.start();
+
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{9, 10}));
+    EXPECT_EQ(scheduler.active(), 2);
+    EXPECT_EQ(scheduler.waiting(), 2);
+
+    scheduler.complete(9);
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{9, 10, 8}));
+
+    // Completing a device twice doesn't free another slot
+    scheduler.complete(9);
+    EXPECT_EQ(started.size(), 3);
+
+    scheduler.complete(10);
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{9, 10, 8, 11}));
+    EXPECT_EQ(scheduler.waiting(), 0);
+}
+
+TEST_F(UpdateSchedulerTest, SmallestFirst)
+{
+    UpdateScheduler scheduler(1, SchedulePolicy::SmallestFirst, record());
+    scheduler.add(8, "/xyz/openbmc_project/mctp/1", 300);
+    scheduler.add(9, "/xyz/openbmc_project/mctp/1", 100);
+    scheduler.add(10, "/xyz/openbmc_project/mctp/1", 200);
+    scheduler.start();
+    scheduler.complete(9);
+    scheduler.complete(10);
+
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{9, 10, 8}));
+}
+
+TEST_F(UpdateSchedulerTest, UnknownRouteNotHeldBack)
+{
+    UpdateScheduler scheduler(1, SchedulePolicy::LargestFirst, record());
+    scheduler.add(8, "", 100);
+    scheduler.add(9, "", 200);
+    scheduler.start();
+
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{8, 9}));
+}
+
+TEST_F(UpdateSchedulerTest, Clear)
+{
+    UpdateScheduler scheduler(1, SchedulePolicy::LargestFirst, record());
+    scheduler.add(8, "/xyz/openbmc_project/mctp/1", 100);
+    scheduler.add(9, "/xyz/openbmc_project/mctp/1", 200);
+    scheduler.start();
+    scheduler.clear();
+
+    EXPECT_EQ(scheduler.active(), 0);
+    EXPECT_EQ(scheduler.waiting(), 0);
+    scheduler.complete(9);
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{9}));
+}
+
+TEST_F(UpdateSchedulerTest, CompleteWaitingDevice)
+{
+    UpdateScheduler scheduler(1, SchedulePolicy::LargestFirst, record());
+    scheduler.add(8, "/xyz/openbmc_project/mctp/1", 300);
+    scheduler.add(9, "/xyz/openbmc_project/mctp/1", 200);
+    scheduler.add(10, "/xyz/openbmc_project/mctp/1", 100);
+    scheduler.start();
+
+    // An aborted device that never started is not started later
+    scheduler.complete(9);
+    EXPECT_EQ(scheduler.waiting(), 1);
+    scheduler.complete(8);
+    EXPECT_EQ(started, (std::vector<mctp_eid_t>{8, 10}));
+}
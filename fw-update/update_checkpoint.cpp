@@ -0,0 +1,104 @@
+#include "update_checkpoint.hpp"
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <nlohmann/json.hpp>
+#include <phosphor-logging/lg2.hpp>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+PHOSPHOR_LOG2_USING;
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+namespace fs = std::filesystem;
+using Json = nlohmann::json;
+
+std::optional<UpdateCheckpoint> CheckpointStore::load(mctp_eid_t eid) const
+{
+    std::ifstream file(path(eid));
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    try
+    {
+        auto data = Json::parse(file);
+        UpdateCheckpoint checkpoint;
+        checkpoint.packageHash = data.at("packageHash").get<uint32_t>();
+        checkpoint.packageSize = data.at("packageSize").get<uint64_t>();
+        checkpoint.componentIndex = data.at("componentIndex").get<size_t>();
+        checkpoint.offset = data.at("offset").get<uint32_t>();
+        checkpoint.appliedComponents =
+            data.at("appliedComponents").get<std::vector<size_t>>();
+        return checkpoint;
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to load the update checkpoint, EID={EID}, ERROR={ERROR}",
+              "EID", unsigned(eid), "ERROR", e);
+        return std::nullopt;
+    }
+}
+
+void CheckpointStore::store(mctp_eid_t eid,
+                            const UpdateCheckpoint& checkpoint) const
+{
+    Json data{{"packageHash", checkpoint.packageHash},
+              {"packageSize", checkpoint.packageSize},
+              {"componentIndex", checkpoint.componentIndex},
+              {"offset", checkpoint.offset},
+              {"appliedComponents", checkpoint.appliedComponents}};
+    auto contents = data.dump();
+
+    std::error_code ec;
+    fs::create_directories(dir, ec);
+    auto filePath = path(eid);
+    auto tmpPath = filePath;
+    tmpPath += ".tmp";
+
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0)
+    {
+        error(
+            "Failed to store the update checkpoint, EID={EID}, ERROR={ERROR}",
+            "EID", unsigned(eid), "ERROR", std::strerror(errno));
+        return;
+    }
+
+    bool ok = ::write(fd, contents.data(), contents.size()) ==
+                  static_cast<ssize_t>(contents.size()) &&
+              ::fsync(fd) == 0;
+    int savedErrno = errno;
+    ::close(fd);
+    if (!ok || ::rename(tmpPath.c_str(), filePath.c_str()) < 0)
+    {
+        if (ok)
+        {
+            savedErrno = errno;
+        }
+        fs::remove(tmpPath, ec);
+        error(
+            "Failed to store the update checkpoint, EID={EID}, ERROR={ERROR}",
+            "EID", unsigned(eid), "ERROR", std::strerror(savedErrno));
+    }
+}
+
+void CheckpointStore::remove(mctp_eid_t eid) const
+{
+    std::error_code ec;
+    fs::remove(path(eid), ec);
+}
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "common/types.hpp"
+
+#include <libpldm/base.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @brief Progress of the update of a firmware device, persisted so that an
+ *         interrupted update can be resumed
+ */
+struct UpdateCheckpoint
+{
+    /** @brief CRC32 of the package header, identifying the package */
+    uint32_t packageHash = 0;
+    /** @brief Size of the package */
+    uint64_t packageSize = 0;
+    /** @brief Index in ApplicableComponents of the component in transfer */
+    size_t componentIndex = 0;
+    /** @brief Bytes of the component served contiguously from its start */
+    uint32_t offset = 0;
+    /** @brief Indexes in ApplicableComponents of the applied components */
+    std::vector<size_t> appliedComponents;
+
+    bool operator==(const UpdateCheckpoint&) const = default;
+};
+
+/** @class CheckpointStore
+ *
+ *  @brief Stores an UpdateCheckpoint per firmware device in a directory
+ *
+ *  Checkpoints are written to a temporary file and renamed over the previous
+ *  one, so a power loss leaves either the old or the new checkpoint.
+ */
+class CheckpointStore
+{
+  public:
+    /** @brief Bytes served between two checkpoints of a component transfer */
+    static constexpr uint32_t interval = 1024 * 1024;
+
+    CheckpointStore() = delete;
+    CheckpointStore(const CheckpointStore&) = delete;
+    CheckpointStore(CheckpointStore&&) = delete;
+    CheckpointStore& operator=(const CheckpointStore&) = delete;
+    CheckpointStore& operator=(CheckpointStore&&) = delete;
+    ~CheckpointStore() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] dir - directory the checkpoints are stored in
+     */
+    explicit CheckpointStore(const std::filesystem::path& dir) : dir(dir) {}
+
+    /** @brief Load the checkpoint of a firmware device
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     *
+     *  @return the checkpoint, std::nullopt if there is none or it can't be
+     *          read
+     */
+    std::optional<UpdateCheckpoint> load(mctp_eid_t eid) const;
+
+    /** @brief Store the checkpoint of a firmware device, failures are logged
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     *  @param[in] checkpoint - progress of the update of the device
+     */
+    void store(mctp_eid_t eid, const UpdateCheckpoint& checkpoint) const;
+
+    /** @brief Remove the checkpoint of a firmware device
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     */
+    void remove(mctp_eid_t eid) const;
+
+  private:
+    std::filesystem::path path(mctp_eid_t eid) const
+    {
+        return dir / (std::to_string(eid) + ".json");
+    }
+
+    std::filesystem::path dir;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
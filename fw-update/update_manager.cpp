@@ -6,10 +6,11 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <filesystem>
-#include <fstream>
+#include <format>
 #include <string>
 
 PHOSPHOR_LOG2_USING;
@@ -31,100 +32,102 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
         return 0;
     }
 
-    namespace software = sdbusplus::xyz::openbmc_project::Software::server;
-    // If a firmware activation of a package is in progress, don't proceed with
-    // package processing
-    if (activation)
+    auto staged = PackageStager::stage(packageFilePath);
+    if (!staged)
     {
-        if (activation->activation() ==
-            software::Activation::Activations::Activating)
-        {
-            error(
-                "Activation of PLDM FW update package already in progress, PACKAGE_VERSION={PKG_VERS}",
-                "PKG_VERS", parser->pkgVersion);
-            std::filesystem::remove(packageFilePath);
-            return -1;
-        }
-        else
-        {
-            clearActivationInfo();
-        }
+        return -1;
     }
+    return processPackage(std::move(*staged));
+}
 
-    package.open(packageFilePath,
-                 std::ios::binary | std::ios::in | std::ios::ate);
-    if (!package.good())
+void UpdateManager::processStagedPackages()
+{
+    if (activation && activation->activation() ==
+                          software::Activation::Activations::Activating)
     {
-        error(
-            "Opening the PLDM FW update package failed, ERR={ERR}, PACKAGEFILE={PKG_FILE}",
-            "ERR", unsigned(errno), "PKG_FILE", packageFilePath.c_str());
-        package.close();
-        std::filesystem::remove(packageFilePath);
-        return -1;
+        info(
+            "PLDM FW update package staged during an activation, STAGED={STAGED}",
+            "STAGED", stager.size());
+        return;
     }
 
-    uintmax_t packageSize = package.tellg();
-    if (packageSize < sizeof(pldm_package_header_information))
+    auto staged = stager.next();
+    while (staged && stager.size())
     {
-        error(
-            "PLDM FW update package length less than the length of the package header information, PACKAGESIZE={PKG_SIZE}",
-            "PKG_SIZE", packageSize);
-        package.close();
-        std::filesystem::remove(packageFilePath);
-        return -1;
+        info("PLDM FW update package superseded, PACKAGEFILE={PKG_FILE}",
+             "PKG_FILE", staged->path.c_str());
+        std::filesystem::remove(staged->path);
+        staged = stager.next();
     }
-
-    package.seekg(0);
-    std::vector<uint8_t> packageHeader(sizeof(pldm_package_header_information));
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 sizeof(pldm_package_header_information));
-
-    auto pkgHeaderInfo =
-        reinterpret_cast<const pldm_package_header_information*>(
-            packageHeader.data());
-    auto pkgHeaderInfoSize = sizeof(pldm_package_header_information) +
-                             pkgHeaderInfo->package_version_string_length;
-    packageHeader.clear();
-    packageHeader.resize(pkgHeaderInfoSize);
-    package.seekg(0);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 pkgHeaderInfoSize);
-
-    parser = parsePkgHeader(packageHeader);
-    if (parser == nullptr)
+    if (staged)
     {
-        error("Invalid PLDM package header information");
-        package.close();
-        std::filesystem::remove(packageFilePath);
-        return -1;
+        processPackage(std::move(*staged));
     }
+}
 
-    // Populate object path with the hash of the package version
-    size_t versionHash = std::hash<std::string>{}(parser->pkgVersion);
-    objPath = swRootPath + std::to_string(versionHash);
+int UpdateManager::processPackage(StagedPackage&& staged)
+{
+    // If no devices discovered, take no action on the package.
+    if (!descriptorMap.size())
+    {
+        return 0;
+    }
 
-    package.seekg(0);
-    packageHeader.resize(parser->pkgHeaderSize);
-    package.read(reinterpret_cast<char*>(packageHeader.data()),
-                 parser->pkgHeaderSize);
-    try
+    // If a firmware activation of a package is in progress, don't proceed with
+    // package processing
+    if (activation)
     {
-        parser->parse(packageHeader, packageSize);
+        auto state = activation->activation();
+        if ((state == software::Activation::Activations::Ready ||
+             state == software::Activation::Activations::Activating) &&
+            staged.contentHash == packageContentHash)
+        {
+            info(
+                "PLDM FW update package already processed, PACKAGEFILE={PKG_FILE}",
+                "PKG_FILE", staged.path.c_str());
+            if (staged.path != fwPackageFilePath)
+            {
+                std::filesystem::remove(staged.path);
+            }
+            return 0;
+        }
+        if (state == software::Activation::Activations::Activating)
+        {
+            error(
+                "Activation of PLDM FW update package already in progress, PACKAGE_VERSION={PKG_VERS}",
+                "PKG_VERS", parser->pkgVersion);
+            std::filesystem::remove(staged.path);
+            return -1;
+        }
+        // The package replacing the current one may have been written to the
+        // same path
+        if (staged.path == fwPackageFilePath)
+        {
+            fwPackageFilePath.clear();
+        }
+        clearActivationInfo();
     }
-    catch (const std::exception& e)
+
+    // Populate object path with the hash of the package content
+    objPath = swRootPath + std::format("{:08x}", staged.contentHash);
+    // The package file goes with its activation, even an invalid one, and is
+    // removed when the next package replaces it
+    fwPackageFilePath = staged.path;
+    packageContentHash = staged.contentHash;
+    if (!staged.parser)
     {
-        error("Invalid PLDM package header: {ERROR}", "ERROR", e);
         activation = std::make_unique<Activation>(
             pldm::utils::DBusHandler::getBus(), objPath,
             software::Activation::Activations::Invalid, this);
-        package.close();
-        parser.reset();
         return -1;
     }
+    package = std::move(staged.package);
+    parser = std::move(staged.parser);
+    uintmax_t packageSize = package->size();
 
     auto deviceUpdaterInfos =
-        associatePkgToDevices(parser->getFwDeviceIDRecords(), descriptorMap,
-                              totalNumComponentUpdates);
+        associatePkgToDevices(parser->getFwDeviceIDRecordViews(),
+                              descriptorMap, totalNumComponentUpdates);
     if (!deviceUpdaterInfos.size())
     {
         error(
@@ -132,64 +135,153 @@ int UpdateManager::processPackage(const std::filesystem::path& packageFilePath)
         activation = std::make_unique<Activation>(
             pldm::utils::DBusHandler::getBus(), objPath,
             software::Activation::Activations::Invalid, this);
-        package.close();
+        package.reset();
         parser.reset();
         return 0;
     }
 
-    const auto& fwDeviceIDRecords = parser->getFwDeviceIDRecords();
     const auto& compImageInfos = parser->getComponentImageInfos();
 
+    // Only the records matching an FD are built from their views
     for (const auto& deviceUpdaterInfo : deviceUpdaterInfos)
     {
         const auto& fwDeviceIDRecord =
-            fwDeviceIDRecords[deviceUpdaterInfo.second];
+            parser->getFwDeviceIDRecord(deviceUpdaterInfo.second);
         auto search = componentInfoMap.find(deviceUpdaterInfo.first);
-        deviceUpdaterMap.emplace(
+        auto [it, inserted] = deviceUpdaterMap.emplace(
             deviceUpdaterInfo.first,
             std::make_unique<DeviceUpdater>(
                 deviceUpdaterInfo.first, package, fwDeviceIDRecord,
-                compImageInfos, search->second, MAXIMUM_TRANSFER_SIZE, this));
+                compImageInfos, search->second,
+                DeviceUpdater::alignTransferSize(MAXIMUM_TRANSFER_SIZE,
+                                                 FW_UPDATE_TRANSPORT_MTU),
+                this));
+        it->second->resumeFrom(
+            resumeCheckpoint(deviceUpdaterInfo.first, fwDeviceIDRecord,
+                             staged.headerHash, packageSize));
     }
 
-    fwPackageFilePath = packageFilePath;
     activation = std::make_unique<Activation>(
         pldm::utils::DBusHandler::getBus(), objPath,
         software::Activation::Activations::Ready, this);
     activationProgress = std::make_unique<ActivationProgress>(
         pldm::utils::DBusHandler::getBus(), objPath);
+    for (const auto& [eid, deviceUpdater] : deviceUpdaterMap)
+    {
+        deviceProgressMap.emplace(
+            eid, std::make_unique<ActivationProgress>(
+                     pldm::utils::DBusHandler::getBus(),
+                     objPath + "/device_" + std::to_string(eid)));
+    }
 
     return 0;
 }
 
 DeviceUpdaterInfos UpdateManager::associatePkgToDevices(
-    const FirmwareDeviceIDRecords& fwDeviceIDRecords,
+    const FirmwareDeviceIDRecordViews& fwDeviceIDRecords,
     const DescriptorMap& descriptorMap,
     TotalComponentUpdates& totalNumComponentUpdates)
 {
+    // Index the FDs by each of their descriptors, a record is only compared
+    // with the FDs sharing its initial descriptor
+    std::unordered_multimap<size_t, mctp_eid_t> descriptorIndex;
+    std::vector<size_t> hashes;
+    for (const auto& [eid, descriptors] : descriptorMap)
+    {
+        hashes.clear();
+        for (const auto& [type, value] : descriptors)
+        {
+            auto hash = hashDescriptor(type, value);
+            if (std::ranges::find(hashes, hash) == hashes.end())
+            {
+                hashes.push_back(hash);
+                descriptorIndex.emplace(hash, eid);
+            }
+        }
+    }
+
     DeviceUpdaterInfos deviceUpdaterInfos;
     for (size_t index = 0; index < fwDeviceIDRecords.size(); ++index)
     {
-        const auto& deviceIDDescriptors =
-            std::get<Descriptors>(fwDeviceIDRecords[index]);
-        for (const auto& [eid, descriptors] : descriptorMap)
+        const auto& record = fwDeviceIDRecords[index];
+        auto hash = hashInitialDescriptor(record);
+        if (!hash)
         {
-            if (std::includes(descriptors.begin(), descriptors.end(),
-                              deviceIDDescriptors.begin(),
-                              deviceIDDescriptors.end()))
+            continue;
+        }
+        auto [begin, end] = descriptorIndex.equal_range(*hash);
+        for (auto it = begin; it != end; ++it)
+        {
+            if (matchDescriptors(record, descriptorMap.at(it->second)))
             {
-                deviceUpdaterInfos.emplace_back(std::make_pair(eid, index));
-                const auto& applicableComponents =
-                    std::get<ApplicableComponents>(fwDeviceIDRecords[index]);
-                totalNumComponentUpdates += applicableComponents.size();
+                deviceUpdaterInfos.emplace_back(std::make_pair(it->second,
+                                                               index));
+                totalNumComponentUpdates += countApplicableComponents(record);
             }
         }
     }
     return deviceUpdaterInfos;
 }
 
+UpdateCheckpoint UpdateManager::resumeCheckpoint(
+    mctp_eid_t eid, const FirmwareDeviceIDRecord& fwDeviceIDRecord,
+    uint32_t packageHash, uint64_t packageSize)
+{
+    UpdateCheckpoint checkpoint{packageHash, packageSize, 0, 0, {}};
+    auto saved = checkpoints.load(eid);
+    if (!saved || saved->packageHash != packageHash ||
+        saved->packageSize != packageSize)
+    {
+        return checkpoint;
+    }
+
+    const auto& applicableComponents =
+        std::get<ApplicableComponents>(fwDeviceIDRecord);
+    const auto& compImageInfos = parser->getComponentImageInfos();
+    auto pending = pendingCompVersionMap.find(eid);
+    for (auto index : saved->appliedComponents)
+    {
+        if (index >= applicableComponents.size() ||
+            pending == pendingCompVersionMap.end())
+        {
+            continue;
+        }
+        const auto& comp = compImageInfos[applicableComponents[index]];
+        CompKey compKey{std::get<static_cast<size_t>(
+                            ComponentImageInfoPos::CompClassificationPos)>(comp),
+                        std::get<static_cast<size_t>(
+                            ComponentImageInfoPos::CompIdentifierPos)>(comp)};
+        auto version = pending->second.find(compKey);
+        if (version != pending->second.end() &&
+            version->second ==
+                std::get<static_cast<size_t>(
+                    ComponentImageInfoPos::CompVersionPos)>(comp))
+        {
+            checkpoint.appliedComponents.push_back(index);
+        }
+    }
+    checkpoint.componentIndex = saved->componentIndex;
+    checkpoint.offset = saved->offset;
+    return checkpoint;
+}
+
 void UpdateManager::updateDeviceCompletion(mctp_eid_t eid, bool status)
 {
+    noteProgress();
+    scheduler.complete(eid);
+    // The FD now reports other pending versions, or is in an unknown state
+    if (invalidateInventory)
+    {
+        invalidateInventory(eid);
+    }
+    if (status)
+    {
+        checkpoints.remove(eid);
+    }
+    else
+    {
+        activationBatch.failed(eid);
+    }
     deviceUpdateCompletionMap.emplace(eid, status);
     if (deviceUpdateCompletionMap.size() == deviceUpdaterMap.size())
     {
@@ -199,16 +291,32 @@ void UpdateManager::updateDeviceCompletion(mctp_eid_t eid, bool status)
             {
                 activation->activation(
                     software::Activation::Activations::Failed);
-                return;
+                break;
             }
         }
 
-        auto endTime = std::chrono::steady_clock::now();
-        auto dur =
-            std::chrono::duration<double, std::milli>(endTime - startTime)
-                .count();
-        error("Firmware update time: {DURATION}ms", "DURATION", dur);
-        activation->activation(software::Activation::Activations::Active);
+        if (activation->activation() !=
+            software::Activation::Activations::Failed)
+        {
+            auto endTime = std::chrono::steady_clock::now();
+            auto dur =
+                std::chrono::duration<double, std::milli>(endTime - startTime)
+                    .count();
+            error("Firmware update time: {DURATION}ms", "DURATION", dur);
+            activationProgress->progress(100);
+            activation->activation(software::Activation::Activations::Active);
+        }
+
+        // The packages staged during the activation replace this one, once
+        // the DeviceUpdaters are out of their callbacks
+        if (stager.size())
+        {
+            stagedRequest = std::make_unique<sdeventplus::source::Defer>(
+                event, [this](sdeventplus::source::EventBase&) {
+                stagedRequest.reset();
+                processStagedPackages();
+            });
+        }
     }
     return;
 }
@@ -260,33 +368,155 @@ Response UpdateManager::handleRequest(mctp_eid_t eid, uint8_t command,
 void UpdateManager::activatePackage()
 {
     startTime = std::chrono::steady_clock::now();
+    scheduler.clear();
+    activationBatch.clear();
+    totalUpdateSize = 0;
+    totalBytesTransferred = 0;
+    deviceBytesTransferred.clear();
     for (const auto& [eid, deviceUpdaterPtr] : deviceUpdaterMap)
     {
-        deviceUpdaterPtr->startFwUpdateFlow();
+        auto route = endpointRoutes.find(eid);
+        scheduler.add(eid,
+                      route != endpointRoutes.end() ? route->second
+                                                    : EndpointRoute{},
+                      deviceUpdaterPtr->getUpdateSize());
+        activationBatch.add(eid);
+        totalUpdateSize += deviceUpdaterPtr->getUpdateSize();
+    }
+    noteProgress();
+    if (activationTimeout.count())
+    {
+        activationTimer.start(activationTimeout);
+    }
+    scheduler.start();
+    info("Firmware update started, ACTIVE={ACTIVE}, WAITING={WAITING}",
+         "ACTIVE", scheduler.active(), "WAITING", scheduler.waiting());
+}
+
+void UpdateManager::deviceTransferComplete(mctp_eid_t eid)
+{
+    noteProgress();
+    scheduler.complete(eid);
+}
+
+void UpdateManager::requestTransferSlot(mctp_eid_t eid)
+{
+    auto route = endpointRoutes.find(eid);
+    scheduler.add(eid,
+                  route != endpointRoutes.end() ? route->second
+                                                : EndpointRoute{},
+                  deviceUpdaterMap.at(eid)->getUpdateSize());
+}
+
+void UpdateManager::deviceApplied(mctp_eid_t eid)
+{
+    noteProgress();
+    activationBatch.applied(eid);
+    info("Firmware applied, EID={EID}, WAITING={WAITING}", "EID",
+         unsigned(eid), "WAITING", activationBatch.pending());
+}
+
+void UpdateManager::activationTimedOut()
+{
+    if (!activationBatch.pending())
+    {
+        return;
+    }
+    auto idle = std::chrono::steady_clock::now() - lastProgress;
+    if (idle < activationTimeout)
+    {
+        activationTimer.start(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                activationTimeout - idle));
+        return;
+    }
+
+    error(
+        "Firmware update stalled, aborting the FDs holding back the activation, PENDING={PENDING}",
+        "PENDING", activationBatch.pending());
+    for (auto eid : activationBatch.expire())
+    {
+        deviceUpdaterMap.at(eid)->abortUpdate();
     }
 }
 
+void UpdateManager::updateDeviceProgress(mctp_eid_t eid,
+                                         uint64_t bytesTransferred,
+                                         uint64_t updateSize)
+{
+    noteProgress();
+    auto& deviceBytes = deviceBytesTransferred[eid];
+    totalBytesTransferred += bytesTransferred - deviceBytes;
+    deviceBytes = bytesTransferred;
+    refreshActivationProgress();
+
+    auto search = deviceProgressMap.find(eid);
+    if (search == deviceProgressMap.end() || !updateSize)
+    {
+        return;
+    }
+    search->second->progress(static_cast<uint8_t>(
+        std::min<uint64_t>(100, 100 * bytesTransferred / updateSize)));
+}
+
 void UpdateManager::clearActivationInfo()
 {
+    activationTimer.stop();
     activation.reset();
     activationProgress.reset();
+    deviceProgressMap.clear();
+    scheduler.clear();
     objPath.clear();
 
     deviceUpdaterMap.clear();
     deviceUpdateCompletionMap.clear();
     parser.reset();
-    package.close();
-    std::filesystem::remove(fwPackageFilePath);
+    package.reset();
+    if (!fwPackageFilePath.empty())
+    {
+        std::filesystem::remove(fwPackageFilePath);
+    }
+    fwPackageFilePath.clear();
+    packageContentHash = 0;
     totalNumComponentUpdates = 0;
     compUpdateCompletedCount = 0;
+    totalUpdateSize = 0;
+    totalBytesTransferred = 0;
+    deviceBytesTransferred.clear();
+    activationBatch.clear();
 }
 
 void UpdateManager::updateActivationProgress()
 {
+    noteProgress();
     compUpdateCompletedCount++;
-    auto progressPercent = static_cast<uint8_t>(std::floor(
-        (100 * compUpdateCompletedCount) / totalNumComponentUpdates));
-    activationProgress->progress(progressPercent);
+    refreshActivationProgress();
+}
+
+void UpdateManager::refreshActivationProgress()
+{
+    if (!activationProgress)
+    {
+        return;
+    }
+    // Half of the progress is the transfer of the bytes to the FDs, the other
+    // half the components verified and applied, so it moves with every chunk
+    // instead of once per component
+    uint64_t transferred =
+        totalUpdateSize ? 50 * std::min(totalBytesTransferred, totalUpdateSize) /
+                              totalUpdateSize
+                        : 0;
+    uint64_t applied = totalNumComponentUpdates
+                           ? 50 * std::min(compUpdateCompletedCount,
+                                           totalNumComponentUpdates) /
+                                 totalNumComponentUpdates
+                           : 0;
+    auto progressPercent = static_cast<uint8_t>(transferred + applied);
+    // Set only on change, every set is signalled on D-Bus
+    if (progressPercent != activationProgress->progress())
+    {
+        activationProgress->progress(progressPercent);
+    }
 }
 
 } // namespace fw_update
@@ -1,17 +1,25 @@
 #pragma once
 
+#include "activation_batch.hpp"
 #include "common/instance_id.hpp"
 #include "common/types.hpp"
 #include "device_updater.hpp"
+#include "package_image.hpp"
 #include "package_parser.hpp"
+#include "package_stager.hpp"
 #include "requester/handler.hpp"
+#include "update_checkpoint.hpp"
+#include "update_scheduler.hpp"
 #include "watch.hpp"
 
 #include <libpldm/base.h>
 
+#include <sdbusplus/timer.hpp>
+
 #include <chrono>
 #include <filesystem>
-#include <fstream>
+#include <functional>
+#include <memory>
 #include <tuple>
 #include <unordered_map>
 
@@ -47,12 +55,49 @@ class UpdateManager
         Event& event,
         pldm::requester::Handler<pldm::requester::Request>& handler,
         InstanceIdDb& instanceIdDb, const DescriptorMap& descriptorMap,
-        const ComponentInfoMap& componentInfoMap) :
+        const ComponentInfoMap& componentInfoMap,
+        const EndpointRoutes& endpointRoutes,
+        const PendingCompVersionMap& pendingCompVersionMap,
+        std::function<void(mctp_eid_t)> invalidateInventory = {},
+        std::chrono::seconds activationTimeout =
+            std::chrono::seconds(FW_UPDATE_ACTIVATION_TIMEOUT)) :
         event(event),
         handler(handler), instanceIdDb(instanceIdDb),
-        descriptorMap(descriptorMap), componentInfoMap(componentInfoMap),
+        checkpoints(FW_UPDATE_CHECKPOINT_DIR), descriptorMap(descriptorMap),
+        componentInfoMap(componentInfoMap), endpointRoutes(endpointRoutes),
+        pendingCompVersionMap(pendingCompVersionMap),
+        invalidateInventory(std::move(invalidateInventory)),
+        stager(event, FW_UPDATE_STAGING_DEPTH,
+               std::bind_front(&UpdateManager::processStagedPackages, this)),
         watch(event.get(),
-              std::bind_front(&UpdateManager::processPackage, this))
+              [this](std::string& packageFilePath) {
+        stager.add(packageFilePath);
+        return 0;
+    }),
+        scheduler(FW_UPDATE_MAX_PER_ROUTE,
+#ifdef FW_UPDATE_SMALLEST_FIRST
+                  SchedulePolicy::SmallestFirst,
+#else
+                  SchedulePolicy::LargestFirst,
+#endif
+                  [this](mctp_eid_t eid) {
+        deviceUpdaterMap.at(eid)->startTransfer();
+    }),
+        activationBatch(
+#if defined(FW_UPDATE_SELF_CONTAINED_ALWAYS)
+            SelfContainedActivation::Always,
+#elif defined(FW_UPDATE_SELF_CONTAINED_ALL_APPLIED)
+            SelfContainedActivation::AllApplied,
+#else
+            SelfContainedActivation::Never,
+#endif
+            [this](mctp_eid_t eid, bool selfContained) {
+        deviceUpdaterMap.at(eid)->activate(selfContained);
+    }),
+        activationTimeout(activationTimeout),
+        activationTimer(event.get(),
+                        std::bind_front(&UpdateManager::activationTimedOut,
+                                        this))
     {}
 
     /** @brief Handle PLDM request for the commands in the FW update
@@ -68,12 +113,84 @@ class UpdateManager
     Response handleRequest(mctp_eid_t eid, uint8_t command,
                            const pldm_msg* request, size_t reqMsgLen);
 
+    /** @brief Stage a package on the event loop and expose it for activation
+     *
+     *  @param[in] packageFilePath - path of the package
+     *
+     *  @return 0 if the package is processed, -1 if it is rejected
+     */
     int processPackage(const std::filesystem::path& packageFilePath);
 
+    /** @brief Expose a staged package for activation
+     *
+     *  A package with the content of the one ready or being activated is
+     *  removed instead.
+     *
+     *  @param[in] staged - the package, mapped and parsed
+     *
+     *  @return 0 if the package is processed, -1 if it is rejected
+     */
+    int processPackage(StagedPackage&& staged);
+
+    /** @brief Expose the newest staged package for activation, unless a
+     *         package is being activated
+     *
+     *  The older staged packages are superseded and removed.
+     */
+    void processStagedPackages();
+
     void updateDeviceCompletion(mctp_eid_t eid, bool status);
 
     void updateActivationProgress();
 
+    /** @brief Update the progress of the transfer to a firmware device
+     *
+     *  @param[in] eid - Remote MCTP Endpoint ID
+     *  @param[in] bytesTransferred - bytes of the components sent so far
+     *  @param[in] updateSize - total bytes of the components to send
+     */
+    void updateDeviceProgress(mctp_eid_t eid, uint64_t bytesTransferred,
+                              uint64_t updateSize);
+
+    /** @brief The firmware device fetched all its components, so another
+     *         device on its route can start transferring
+     *
+     *  @param[in] eid - Remote MCTP Endpoint ID
+     */
+    void deviceTransferComplete(mctp_eid_t eid);
+
+    /** @brief Queue the firmware device for a transfer slot on its route, to
+     *         transfer its next component
+     *
+     *  @param[in] eid - Remote MCTP Endpoint ID
+     */
+    void requestTransferSlot(mctp_eid_t eid);
+
+    /** @brief The firmware device applied all its components, it is
+     *         activated once every device of the package is done
+     *
+     *  @param[in] eid - Remote MCTP Endpoint ID
+     */
+    void deviceApplied(mctp_eid_t eid);
+
+    /** @brief Build the checkpoint the update of an FD starts from
+     *
+     *  A saved checkpoint for the same package is resumed. Of the components
+     *  it lists as applied, only those the FD still reports as pending
+     *  activation are kept, the others are updated again.
+     *
+     *  @param[in] eid - Remote MCTP Endpoint ID
+     *  @param[in] fwDeviceIDRecord - record of the package matching the FD
+     *  @param[in] packageHash - CRC32 of the package header
+     *  @param[in] packageSize - size of the package
+     *
+     *  @return the checkpoint
+     */
+    UpdateCheckpoint
+        resumeCheckpoint(mctp_eid_t eid,
+                         const FirmwareDeviceIDRecord& fwDeviceIDRecord,
+                         uint32_t packageHash, uint64_t packageSize);
+
     /** @brief Callback function that will be invoked when the
      *         RequestedActivation will be set to active in the Activation
      *         interface
@@ -82,25 +199,51 @@ class UpdateManager
 
     void clearActivationInfo();
 
-    /** @brief
+    /** @brief Find the FDs the firmware device ID records of a package match
      *
+     *  An FD matches a record if its descriptors include all the descriptors
+     *  of the record. The FDs are indexed by descriptor, so each record is
+     *  only compared with the FDs sharing its initial descriptor.
+     *
+     *  @param[in] fwDeviceIDRecords - records of the package
+     *  @param[in] descriptorMap - descriptors of the managed FDs
+     *  @param[out] totalNumComponentUpdates - incremented by the number of
+     *                                         components of each match
+     *
+     *  @return the matching FDs, with the index of the record they match
      */
-    DeviceUpdaterInfos
-        associatePkgToDevices(const FirmwareDeviceIDRecords& fwDeviceIDRecords,
-                              const DescriptorMap& descriptorMap,
-                              TotalComponentUpdates& totalNumComponentUpdates);
+    DeviceUpdaterInfos associatePkgToDevices(
+        const FirmwareDeviceIDRecordViews& fwDeviceIDRecords,
+        const DescriptorMap& descriptorMap,
+        TotalComponentUpdates& totalNumComponentUpdates);
 
     const std::string swRootPath{"/xyz/openbmc_project/software/"};
     Event& event; //!< reference to PLDM daemon's main event loop
     /** @brief PLDM request handler */
     pldm::requester::Handler<pldm::requester::Request>& handler;
     InstanceIdDb& instanceIdDb; //!< reference to an InstanceIdDb
+    /** @brief Progress of the FD updates, to resume interrupted updates */
+    CheckpointStore checkpoints;
+    /** @brief Length the FDs requested firmware data with, to read ahead the
+     *         first chunk of the next component or update
+     */
+    std::unordered_map<mctp_eid_t, uint32_t> requestLengths;
 
   private:
     /** @brief Device identifiers of the managed FDs */
     const DescriptorMap& descriptorMap;
     /** @brief Component information needed for the update of the managed FDs */
     const ComponentInfoMap& componentInfoMap;
+    /** @brief Route each managed FD is reached through */
+    const EndpointRoutes& endpointRoutes;
+    /** @brief Versions of the components pending activation on the FDs */
+    const PendingCompVersionMap& pendingCompVersionMap;
+    /** @brief Drops the cached inventory of an FD whose firmware changed */
+    std::function<void(mctp_eid_t)> invalidateInventory;
+    /** @brief Parses the packages dropped in the image directory off the
+     *         event loop
+     */
+    PackageStager stager;
     Watch watch;
 
     std::unique_ptr<Activation> activation;
@@ -108,13 +251,40 @@ class UpdateManager
     std::string objPath;
 
     std::filesystem::path fwPackageFilePath;
+    /** @brief CRC32 of the whole package ready or being activated */
+    uint32_t packageContentHash = 0;
     std::unique_ptr<PackageParser> parser;
-    std::ifstream package;
+    std::shared_ptr<const PackageImage> package;
 
     std::unordered_map<mctp_eid_t, std::unique_ptr<DeviceUpdater>>
         deviceUpdaterMap;
     std::unordered_map<mctp_eid_t, bool> deviceUpdateCompletionMap;
 
+    /** @brief Transfer progress of each FD, below the package object */
+    std::unordered_map<mctp_eid_t, std::unique_ptr<ActivationProgress>>
+        deviceProgressMap;
+
+    /** @brief Limits the number of FDs transferring at once on a route */
+    UpdateScheduler scheduler;
+
+    /** @brief Activates the FDs together once all of them applied */
+    ActivationBatch activationBatch;
+
+    /** @brief Time the activation waits without progress from any FD
+     *         before the FDs still updating are aborted, 0 waits
+     *         indefinitely
+     */
+    std::chrono::seconds activationTimeout;
+
+    /** @brief Last progress of an FD of the package being activated */
+    std::chrono::steady_clock::time_point lastProgress;
+
+    /** @brief Gives up on the FDs holding back the activation */
+    sdbusplus::Timer activationTimer;
+
+    /** @brief Processes the staged packages once the activation is over */
+    std::unique_ptr<sdeventplus::source::Defer> stagedRequest;
+
     /** @brief Total number of component updates to calculate the progress of
      *         the Firmware activation
      */
@@ -126,6 +296,32 @@ class UpdateManager
      *         Applied) ActivationProgress is updated.
      */
     size_t compUpdateCompletedCount;
+
+    /** @brief Bytes of the components to send to all the FDs, and the bytes
+     *         sent so far to each FD, the transfer accounts for half of the
+     *         ActivationProgress
+     */
+    uint64_t totalUpdateSize = 0;
+    uint64_t totalBytesTransferred = 0;
+    std::unordered_map<mctp_eid_t, uint64_t> deviceBytesTransferred;
+
+    /** @brief Set the ActivationProgress from the bytes transferred and the
+     *         components applied
+     */
+    void refreshActivationProgress();
+
+    /** @brief An FD of the package progressed, the activation keeps waiting
+     *         for the FDs still updating
+     */
+    void noteProgress()
+    {
+        lastProgress = std::chrono::steady_clock::now();
+    }
+
+    /** @brief Abort the FDs holding back the activation if none progressed
+     *         for the activation timeout, and activate the others
+     */
+    void activationTimedOut();
     decltype(std::chrono::steady_clock::now()) startTime;
 };
 
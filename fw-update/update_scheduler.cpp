@@ -0,0 +1,98 @@
+#include "update_scheduler.hpp"
+
+#include <algorithm>
+#include <string>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+void UpdateScheduler::add(mctp_eid_t eid, const EndpointRoute& route,
+                          uint64_t updateSize)
+{
+    // A device with no known route gets a route of its own
+    auto key = route.empty() ? "eid:" + std::to_string(eid) : route;
+    auto& queue = routes[key];
+
+    auto before = [this](const Device& lhs, const Device& rhs) {
+        return policy == SchedulePolicy::LargestFirst
+                   ? lhs.updateSize > rhs.updateSize
+                   : lhs.updateSize < rhs.updateSize;
+    };
+    Device device{eid, updateSize};
+    queue.waiting.insert(std::upper_bound(queue.waiting.begin(),
+                                          queue.waiting.end(), device, before),
+                         device);
+
+    if (started)
+    {
+        dispatch(queue, key);
+    }
+}
+
+void UpdateScheduler::start()
+{
+    started = true;
+    for (auto& [route, queue] : routes)
+    {
+        dispatch(queue, route);
+    }
+}
+
+void UpdateScheduler::complete(mctp_eid_t eid)
+{
+    auto search = activeRoutes.find(eid);
+    if (search == activeRoutes.end())
+    {
+        // A device completing before it was started is dropped from its queue
+        for (auto& [route, queue] : routes)
+        {
+            std::erase_if(queue.waiting, [eid](const Device& device) {
+                return device.eid == eid;
+            });
+        }
+        return;
+    }
+
+    auto route = std::move(search->second);
+    activeRoutes.erase(search);
+    auto& queue = routes[route];
+    queue.active--;
+    dispatch(queue, route);
+}
+
+void UpdateScheduler::clear()
+{
+    started = false;
+    routes.clear();
+    activeRoutes.clear();
+}
+
+size_t UpdateScheduler::waiting() const
+{
+    size_t count = 0;
+    for (const auto& [route, queue] : routes)
+    {
+        count += queue.waiting.size();
+    }
+    return count;
+}
+
+void UpdateScheduler::dispatch(RouteQueue& queue, const EndpointRoute& route)
+{
+    while (!queue.waiting.empty() &&
+           (!maxPerRoute || queue.active < maxPerRoute))
+    {
+        auto device = queue.waiting.front();
+        queue.waiting.erase(queue.waiting.begin());
+        queue.active++;
+        activeRoutes.emplace(device.eid, route);
+        startUpdate(device.eid);
+    }
+}
+
+} // namespace fw_update
+
+} // namespace pldm
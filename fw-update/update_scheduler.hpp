@@ -0,0 +1,123 @@
+#pragma once
+
+#include "common/types.hpp"
+
+#include <libpldm/base.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+namespace pldm
+{
+
+namespace fw_update
+{
+
+/** @brief Order in which firmware devices waiting on a route are started */
+enum class SchedulePolicy
+{
+    LargestFirst,
+    SmallestFirst,
+};
+
+/** @class UpdateScheduler
+ *
+ *  @brief Limits the number of firmware devices transferring at once over
+ *         each route
+ *
+ *  Devices sharing a route queue up behind at most maxPerRoute active
+ *  transfers, in the order given by the SchedulePolicy. When a device
+ *  finishes its transfer the next device waiting on the same route is
+ *  started. Devices with no known route are never held back.
+ */
+class UpdateScheduler
+{
+  public:
+    using StartUpdate = std::function<void(mctp_eid_t eid)>;
+
+    UpdateScheduler() = delete;
+    UpdateScheduler(const UpdateScheduler&) = delete;
+    UpdateScheduler(UpdateScheduler&&) = delete;
+    UpdateScheduler& operator=(const UpdateScheduler&) = delete;
+    UpdateScheduler& operator=(UpdateScheduler&&) = delete;
+    ~UpdateScheduler() = default;
+
+    /** @brief Constructor
+     *
+     *  @param[in] maxPerRoute - maximum number of devices transferring at
+     *                           once on a route, 0 for no limit
+     *  @param[in] policy - order of the devices waiting on a route
+     *  @param[in] startUpdate - starts the update of a device
+     */
+    UpdateScheduler(size_t maxPerRoute, SchedulePolicy policy,
+                    StartUpdate startUpdate) :
+        maxPerRoute(maxPerRoute),
+        policy(policy), startUpdate(std::move(startUpdate))
+    {}
+
+    /** @brief Queue the update of a device
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     *  @param[in] route - route the device is reached through, empty if not
+     *                     known
+     *  @param[in] updateSize - number of bytes to transfer to the device
+     */
+    void add(mctp_eid_t eid, const EndpointRoute& route, uint64_t updateSize);
+
+    /** @brief Start as many queued updates as the routes allow */
+    void start();
+
+    /** @brief Release the route slot of a device whose transfer finished,
+     *         and start the next device waiting on that route
+     *
+     *  A device still waiting is dropped without being started. Calling
+     *  this again for the same device has no effect.
+     *
+     *  @param[in] eid - MCTP endpoint ID of the device
+     */
+    void complete(mctp_eid_t eid);
+
+    /** @brief Drop all queued and active updates */
+    void clear();
+
+    /** @brief Number of devices waiting for a route slot */
+    size_t waiting() const;
+
+    /** @brief Number of devices transferring */
+    size_t active() const
+    {
+        return activeRoutes.size();
+    }
+
+  private:
+    struct Device
+    {
+        mctp_eid_t eid;
+        uint64_t updateSize;
+    };
+
+    struct RouteQueue
+    {
+        /** @brief devices waiting, in the order they are started */
+        std::vector<Device> waiting;
+        size_t active = 0;
+    };
+
+    /** @brief Start the devices a route has room for */
+    void dispatch(RouteQueue& queue, const EndpointRoute& route);
+
+    size_t maxPerRoute;
+    SchedulePolicy policy;
+    StartUpdate startUpdate;
+    bool started = false;
+    std::map<EndpointRoute, RouteQueue> routes;
+    /** @brief route of each transferring device */
+    std::unordered_map<mctp_eid_t, EndpointRoute> activeRoutes;
+};
+
+} // namespace fw_update
+
+} // namespace pldm
@@ -4,6 +4,8 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <algorithm>
+
 PHOSPHOR_LOG2_USING;
 
 namespace pldm
@@ -22,9 +24,150 @@ DbusToPLDMEvent::DbusToPLDMEvent(
     int mctp_fd, uint8_t mctp_eid, pldm::InstanceIdDb& instanceIdDb,
     pldm::requester::Handler<pldm::requester::Request>* handler) :
     mctp_fd(mctp_fd),
-    mctp_eid(mctp_eid), instanceIdDb(instanceIdDb), handler(handler)
+    mctp_eid(mctp_eid), instanceIdDb(instanceIdDb), handler(handler),
+    event(sdeventplus::Event::get_default()),
+    drainTimer(event.get(),
+               std::bind_front(&DbusToPLDMEvent::drainEvents, this))
 {}
 
+void DbusToPLDMEvent::queueSensorEvent(SensorId sensorId, uint8_t offset,
+                                       uint8_t eventState,
+                                       uint8_t previousEventState)
+{
+    uint32_t key = (static_cast<uint32_t>(sensorId) << 8) | offset;
+    auto [it, inserted] = pendingEvents.try_emplace(key, eventState,
+                                                    previousEventState);
+    if (!inserted)
+    {
+        // Keep the previous state of the change the host has not seen yet
+        it->second.eventState = eventState;
+        ++coalescedEvents;
+        return;
+    }
+
+    eventQueue.push_back(key);
+    drainEvents();
+}
+
+std::vector<uint8_t> DbusToPLDMEvent::popSensorEvent()
+{
+    auto key = eventQueue.front();
+    eventQueue.pop_front();
+    auto node = pendingEvents.extract(key);
+
+    std::vector<uint8_t> sensorEventDataVec(PLDM_SENSOR_EVENT_DATA_MIN_LENGTH +
+                                            1);
+    auto eventData = reinterpret_cast<struct pldm_sensor_event_data*>(
+        sensorEventDataVec.data());
+    eventData->sensor_id = static_cast<SensorId>(key >> 8);
+    eventData->sensor_event_class_type = PLDM_STATE_SENSOR_STATE;
+    eventData->event_class[0] = key & 0xFF;
+    eventData->event_class[1] = node.mapped().eventState;
+    eventData->event_class[2] = node.mapped().previousEventState;
+    return sensorEventDataVec;
+}
+
+void DbusToPLDMEvent::drainEvents()
+{
+    if (eventPolling)
+    {
+        // Tell the host once per burst, it polls until the queue is empty
+        if (pollNotified)
+        {
+            return;
+        }
+
+        auto polled = getPolledEvent();
+        if (!polled)
+        {
+            return;
+        }
+
+        std::vector<uint8_t> eventDataVec(PLDM_MSG_POLL_EVENT_LENGTH);
+        pldm_message_poll_event pollEvent{1 /*formatVersion*/,
+                                          polled->eventId, polled->eventId};
+        auto rc = encode_pldm_message_poll_event_data(
+            &pollEvent, eventDataVec.data(), eventDataVec.size());
+        if (rc != PLDM_SUCCESS)
+        {
+            error("Failed to encode pldmMessagePollEvent, rc = {RC}", "RC",
+                  rc);
+            return;
+        }
+        pollNotified = true;
+        sendEventMsg(PLDM_MESSAGE_POLL_EVENT, eventDataVec);
+        return;
+    }
+
+    if (SENSOR_EVENT_RATE)
+    {
+        auto now = std::chrono::steady_clock::now();
+        std::chrono::duration<double> elapsed = now - lastTokenRefill;
+        lastTokenRefill = now;
+        eventTokens = std::min<double>(SENSOR_EVENT_BURST,
+                                       eventTokens +
+                                           elapsed.count() * SENSOR_EVENT_RATE);
+    }
+
+    while (!eventQueue.empty() && (!SENSOR_EVENT_RATE || eventTokens >= 1))
+    {
+        eventTokens -= 1;
+        sendEventMsg(PLDM_SENSOR_EVENT, popSensorEvent());
+    }
+
+    if (!eventQueue.empty() && !drainTimer.isRunning())
+    {
+        std::chrono::duration<double> wait((1 - eventTokens) /
+                                           SENSOR_EVENT_RATE);
+        drainTimer.start(std::chrono::ceil<std::chrono::microseconds>(wait));
+    }
+}
+
+const DbusToPLDMEvent::PolledEvent* DbusToPLDMEvent::getPolledEvent()
+{
+    // The queue belongs to drainEvents() unless the host polls
+    if (!eventPolling)
+    {
+        return nullptr;
+    }
+    if (!polledEvent)
+    {
+        if (eventQueue.empty())
+        {
+            // The host drained the queue, notify it again on the next event
+            pollNotified = false;
+            return nullptr;
+        }
+
+        // Event IDs 0x0000 and 0xFFFF are reserved
+        lastEventId = lastEventId >= 0xFFFE ? 1 : lastEventId + 1;
+        polledEvent.emplace(lastEventId, PLDM_SENSOR_EVENT, popSensorEvent());
+    }
+    return &*polledEvent;
+}
+
+bool DbusToPLDMEvent::acknowledgePolledEvent(uint16_t eventId)
+{
+    if (!polledEvent || polledEvent->eventId != eventId)
+    {
+        return false;
+    }
+    polledEvent.reset();
+    // The host may acknowledge without polling again, the next event must
+    // notify it once the queue is drained
+    if (eventQueue.empty())
+    {
+        pollNotified = false;
+    }
+    return true;
+}
+
+void DbusToPLDMEvent::notifyPendingEvents()
+{
+    pollNotified = false;
+    drainEvents();
+}
+
 void DbusToPLDMEvent::sendEventMsg(uint8_t eventType,
                                    const std::vector<uint8_t>& eventDataVec)
 {
@@ -89,85 +232,134 @@ void DbusToPLDMEvent::sendStateSensorEvent(SensorId sensorId,
         return;
     }
 
-    size_t sensorEventSize = PLDM_SENSOR_EVENT_DATA_MIN_LENGTH + 1;
     const auto& [dbusMappings, dbusValMaps] = dbusMaps.at(sensorId);
     for (uint8_t offset = 0; offset < dbusMappings.size(); ++offset)
     {
-        std::vector<uint8_t> sensorEventDataVec{};
-        sensorEventDataVec.resize(sensorEventSize);
-        auto eventData = reinterpret_cast<struct pldm_sensor_event_data*>(
-            sensorEventDataVec.data());
-        eventData->sensor_id = sensorId;
-        eventData->sensor_event_class_type = PLDM_STATE_SENSOR_STATE;
-        eventData->event_class[0] = offset;
-        eventData->event_class[1] = PLDM_SENSOR_UNKNOWN;
-        eventData->event_class[2] = PLDM_SENSOR_UNKNOWN;
-
         const auto& dbusMapping = dbusMappings[offset];
-        const auto& dbusValueMapping = dbusValMaps[offset];
-        auto stateSensorMatch = std::make_unique<sdbusplus::bus::match_t>(
-            pldm::utils::DBusHandler::getBus(),
-            propertiesChanged(dbusMapping.objectPath.c_str(),
-                              dbusMapping.interface.c_str()),
-            [this, sensorEventDataVec, dbusValueMapping, dbusMapping, sensorId,
-             offset](auto& msg) mutable {
-            DbusChangedProps props{};
-            std::string intf;
-            uint8_t previousState = PLDM_SENSOR_UNKNOWN;
-            msg.read(intf, props);
-            if (!props.contains(dbusMapping.propertyName))
+        addPropertyListener(sensorId, offset, dbusMapping, dbusValMaps[offset]);
+
+        // Every sensor offset mapped to the same object shares one match
+        if (!stateSensorMatchs.contains(dbusMapping.objectPath))
+        {
+            stateSensorMatchs.emplace(
+                dbusMapping.objectPath,
+                std::make_unique<sdbusplus::bus::match_t>(
+                    pldm::utils::DBusHandler::getBus(),
+                    type::signal() + member("PropertiesChanged") +
+                        interface(pldm::utils::dbusProperties) +
+                        path(dbusMapping.objectPath),
+                    std::bind_front(&DbusToPLDMEvent::processPropertiesChanged,
+                                    this)));
+        }
+    }
+}
+
+void DbusToPLDMEvent::addPropertyListener(
+    SensorId sensorId, uint8_t offset, const DBusMapping& dbusMapping,
+    const pldm::responder::pdr_utils::StatestoDbusVal& valueMap)
+{
+    propertyListeners[dbusMapping.objectPath][dbusMapping.interface]
+                     [dbusMapping.propertyName]
+                         .emplace_back(sensorId, offset,
+                                       dbusMapping.propertyType, valueMap);
+}
+
+void DbusToPLDMEvent::processPropertiesChanged(sdbusplus::message_t& msg)
+{
+    DbusChangedProps props{};
+    std::string intf;
+    try
+    {
+        msg.read(intf, props);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to read PropertiesChanged signal: {ERROR}", "ERROR", e);
+        return;
+    }
+
+    dispatchPropertiesChanged(msg.get_path(), intf, props);
+}
+
+void DbusToPLDMEvent::dispatchPropertiesChanged(const std::string& path,
+                                                const std::string& intf,
+                                                const DbusChangedProps& props)
+{
+    auto pathIt = propertyListeners.find(path);
+    if (pathIt == propertyListeners.end())
+    {
+        return;
+    }
+
+    auto intfIt = pathIt->second.find(intf);
+    if (intfIt == pathIt->second.end())
+    {
+        return;
+    }
+
+    for (const auto& [prop, value] : props)
+    {
+        auto propIt = intfIt->second.find(prop);
+        if (propIt == intfIt->second.end())
+        {
+            continue;
+        }
+        for (const auto& listener : propIt->second)
+        {
+            processSensorOffset(listener, value);
+        }
+    }
+}
+
+void DbusToPLDMEvent::processSensorOffset(
+    const SensorOffsetListener& listener,
+    const pldm::utils::PropertyValue& value)
+{
+    const auto& [sensorId, offset, propertyType, valueMap] = listener;
+    uint8_t previousState = PLDM_SENSOR_UNKNOWN;
+
+    for (const auto& itr : valueMap)
+    {
+        bool findValue = false;
+        if (propertyType == "string")
+        {
+            const auto* dst = std::get_if<std::string>(&value);
+            if (!dst)
             {
                 return;
             }
-            for (const auto& itr : dbusValueMapping)
-            {
-                bool findValue = false;
-                if (dbusMapping.propertyType == "string")
-                {
-                    std::string src = std::get<std::string>(itr.second);
-                    std::string dst = std::get<std::string>(
-                        props.at(dbusMapping.propertyName));
-
-                    auto values = pldm::utils::split(src, "||", " ");
-                    for (auto& value : values)
-                    {
-                        if (value == dst)
-                        {
-                            findValue = true;
-                            break;
-                        }
-                    }
-                }
-                else
-                {
-                    findValue = itr.second == props.at(dbusMapping.propertyName)
-                                    ? true
-                                    : false;
-                }
+            std::string src = std::get<std::string>(itr.second);
 
-                if (findValue)
+            auto values = pldm::utils::split(src, "||", " ");
+            for (const auto& val : values)
+            {
+                if (val == *dst)
                 {
-                    auto eventData =
-                        reinterpret_cast<struct pldm_sensor_event_data*>(
-                            sensorEventDataVec.data());
-                    eventData->event_class[1] = itr.first;
-                    if (sensorCacheMap.contains(sensorId) &&
-                        sensorCacheMap[sensorId][offset] != PLDM_SENSOR_UNKNOWN)
-                    {
-                        previousState = sensorCacheMap[sensorId][offset];
-                    }
-                    else
-                    {
-                        previousState = itr.first;
-                    }
-                    eventData->event_class[2] = previousState;
-                    this->sendEventMsg(PLDM_SENSOR_EVENT, sensorEventDataVec);
-                    updateSensorCacheMaps(sensorId, offset, previousState);
+                    findValue = true;
                     break;
                 }
             }
-        });
-        stateSensorMatchs.emplace_back(std::move(stateSensorMatch));
+        }
+        else
+        {
+            findValue = itr.second == value ? true : false;
+        }
+
+        if (findValue)
+        {
+            if (sensorCacheMap.contains(sensorId) &&
+                sensorCacheMap[sensorId][offset] != PLDM_SENSOR_UNKNOWN)
+            {
+                previousState = sensorCacheMap[sensorId][offset];
+            }
+            else
+            {
+                previousState = itr.first;
+            }
+            queueSensorEvent(sensorId, offset, itr.first, previousState);
+            updateSensorCacheMaps(sensorId, offset, previousState);
+            break;
+        }
     }
 }
 
@@ -211,6 +403,24 @@ void DbusToPLDMEvent::listenSensorEvent(const pdr_utils::Repo& repo,
             pdrRecord = sensorPDRs.getNextRecord(pdrRecord, pdrEntry);
         }
     }
+
+    size_t numListeners = 0;
+    for (const auto& [path, interfaces] : propertyListeners)
+    {
+        for (const auto& [intf, properties] : interfaces)
+        {
+            for (const auto& [prop, listeners] : properties)
+            {
+                numListeners += listeners.size();
+            }
+        }
+    }
+    info(
+        "Listening for {LISTENERS} state sensor offsets with {MATCHES} D-Bus matches",
+        "LISTENERS", numListeners, "MATCHES", stateSensorMatchs.size());
+    info(
+        "State sensor events are limited to {RATE}/s with bursts of {BURST} events",
+        "RATE", SENSOR_EVENT_RATE, "BURST", SENSOR_EVENT_BURST);
 }
 
 } // namespace state_sensor
@@ -6,7 +6,18 @@
 
 #include <libpldm/platform.h>
 
+#include <sdbusplus/timer.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <chrono>
+#include <deque>
 #include <map>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+class TestDbusToPLDMEvent;
 
 namespace pldm
 {
@@ -34,7 +45,7 @@ class DbusToPLDMEvent
     DbusToPLDMEvent(DbusToPLDMEvent&&) = delete;
     DbusToPLDMEvent& operator=(const DbusToPLDMEvent&) = delete;
     DbusToPLDMEvent& operator=(DbusToPLDMEvent&&) = delete;
-    ~DbusToPLDMEvent() = default;
+    virtual ~DbusToPLDMEvent() = default;
 
     /** @brief Constructor
      *  @param[in] mctp_fd - fd of MCTP communications socket
@@ -47,6 +58,8 @@ class DbusToPLDMEvent
         pldm::requester::Handler<pldm::requester::Request>* handler);
 
   public:
+    friend class ::TestDbusToPLDMEvent;
+
     /** @brief Listen all of the state sensor PDRs
      *  @param[in] repo - pdr utils repo object
      *  @param[in] dbusMaps - The map of D-Bus mapping and value
@@ -54,6 +67,51 @@ class DbusToPLDMEvent
     void listenSensorEvent(const pldm::responder::pdr_utils::Repo& repo,
                            const DbusObjMaps& dbusMaps);
 
+    /** @brief Size of the largest event data queued for the host */
+    static constexpr uint16_t maxEventDataSize =
+        PLDM_SENSOR_EVENT_DATA_MIN_LENGTH + 1;
+
+    /** @brief A queued event handed out to the host through
+     *         PollForPlatformEventMessage
+     */
+    struct PolledEvent
+    {
+        uint16_t eventId;
+        uint8_t eventClass;
+        std::vector<uint8_t> eventData;
+    };
+
+    /** @brief Get the oldest event the host has not acknowledged yet
+     *
+     *  The event keeps its event ID until it is acknowledged, so repeated
+     *  polls for it return the same data.
+     *
+     *  @return pointer to the event, or nullptr when the queue is empty or
+     *          the events are sent to the host instead
+     */
+    const PolledEvent* getPolledEvent();
+
+    /** @brief Whether the host polls for the queued events */
+    bool pollingEnabled() const
+    {
+        return eventPolling;
+    }
+
+    /** @brief Acknowledge the event last handed out by getPolledEvent()
+     *
+     *  Once the queue is empty the host is notified again on the next event,
+     *  whether or not it polls again after the acknowledgement.
+     *
+     *  @param[in] eventId - event ID the host acknowledges
+     *  @return true if eventId matched the outstanding event
+     */
+    bool acknowledgePolledEvent(uint16_t eventId);
+
+    /** @brief Notify the host again of the events still queued, once it
+     *         stopped polling with an acknowledgement alone
+     */
+    void notifyPendingEvents();
+
     /** @brief get the sensor state cache */
     inline const stateSensorCacheMaps& getSensorCache()
     {
@@ -73,17 +131,95 @@ class DbusToPLDMEvent
     }
 
   private:
-    /** @brief Send state sensor event msg when a D-Bus property changes
+    /** @brief A state sensor offset that is driven by a D-Bus property */
+    struct SensorOffsetListener
+    {
+        SensorId sensorId;
+        uint8_t offset;
+        std::string propertyType;
+        pldm::responder::pdr_utils::StatestoDbusVal valueMap;
+    };
+
+    /** @brief Listeners of a D-Bus object, keyed by interface and property
+     *         name
+     */
+    using PropertyListeners = std::unordered_map<
+        std::string,
+        std::unordered_map<std::string, std::vector<SensorOffsetListener>>>;
+
+    /** @brief Register the offsets of a state sensor so that a state sensor
+     *         event msg is sent when their D-Bus property changes
      *  @param[in] sensorId - sensor id
      */
     void sendStateSensorEvent(SensorId sensorId, const DbusObjMaps& dbusMaps);
 
+    /** @brief Register a sensor offset as a listener of its D-Bus property
+     *  @param[in] sensorId - sensor id
+     *  @param[in] offset - sensor offset
+     *  @param[in] dbusMapping - D-Bus property driving the sensor offset
+     *  @param[in] valueMap - states of the sensor offset and the property
+     *                        values mapping to them
+     */
+    void addPropertyListener(
+        SensorId sensorId, uint8_t offset,
+        const pldm::utils::DBusMapping& dbusMapping,
+        const pldm::responder::pdr_utils::StatestoDbusVal& valueMap);
+
+    /** @brief Unpack a PropertiesChanged signal and dispatch it to the sensor
+     *         offsets listening on the object it was emitted from
+     *  @param[in] msg - PropertiesChanged signal
+     */
+    void processPropertiesChanged(sdbusplus::message_t& msg);
+
+    /** @brief Dispatch changed properties to the sensor offsets listening on
+     *         them
+     *  @param[in] path - object path the properties changed on
+     *  @param[in] intf - interface of the properties
+     *  @param[in] props - changed properties and their new values
+     */
+    void dispatchPropertiesChanged(const std::string& path,
+                                   const std::string& intf,
+                                   const pldm::utils::DbusChangedProps& props);
+
+    /** @brief Send the state sensor event msg for a listener if the new
+     *         property value maps to one of its states
+     *  @param[in] listener - sensor offset listening on the property
+     *  @param[in] value - new property value
+     */
+    void processSensorOffset(const SensorOffsetListener& listener,
+                             const pldm::utils::PropertyValue& value);
+
+    /** @brief Queue a state sensor event for the host
+     *
+     *  A change of a sensor offset that is already queued replaces the
+     *  queued state instead of adding another event, so the host only sees
+     *  the latest state of a flapping sensor.
+     *
+     *  @param[in] sensorId - sensor id
+     *  @param[in] offset - sensor offset
+     *  @param[in] eventState - new state of the sensor offset
+     *  @param[in] previousEventState - previous state of the sensor offset
+     */
+    void queueSensorEvent(SensorId sensorId, uint8_t offset,
+                          uint8_t eventState, uint8_t previousEventState);
+
+    /** @brief Send queued events as long as the rate limit allows, and arm
+     *         the drain timer for the rest. With the polling model the host
+     *         is notified instead and drains the queue itself.
+     */
+    void drainEvents();
+
+    /** @brief Pop the oldest queued event and encode its event data
+     *  @return state sensor event data
+     */
+    std::vector<uint8_t> popSensorEvent();
+
     /** @brief Send all of sensor event
      *  @param[in] eventType - PLDM Event types
      *  @param[in] eventDataVec - std::vector, contains send event data
      */
-    void sendEventMsg(uint8_t eventType,
-                      const std::vector<uint8_t>& eventDataVec);
+    virtual void sendEventMsg(uint8_t eventType,
+                              const std::vector<uint8_t>& eventDataVec);
 
     /** @brief fd of MCTP communications socket */
     int mctp_fd;
@@ -96,14 +232,70 @@ class DbusToPLDMEvent
      */
     pldm::InstanceIdDb& instanceIdDb;
 
-    /** @brief D-Bus property changed signal match */
-    std::vector<std::unique_ptr<sdbusplus::bus::match_t>> stateSensorMatchs;
+    /** @brief D-Bus property changed signal matches, one per object path
+     *         shared by every sensor offset mapped to the object
+     */
+    std::unordered_map<std::string, std::unique_ptr<sdbusplus::bus::match_t>>
+        stateSensorMatchs;
+
+    /** @brief Sensor offsets listening on D-Bus properties, keyed by object
+     *         path
+     */
+    std::unordered_map<std::string, PropertyListeners> propertyListeners;
 
     /** @brief PLDM request handler */
     pldm::requester::Handler<pldm::requester::Request>* handler;
 
     /** @brief sensor cache */
     stateSensorCacheMaps sensorCacheMap;
+
+    /** @brief States of a queued sensor offset change */
+    struct PendingEvent
+    {
+        uint8_t eventState;
+        uint8_t previousEventState;
+    };
+
+    /** @brief Sensor offsets with a queued change in arrival order, packed
+     *         as (sensor id << 8 | offset)
+     */
+    std::deque<uint32_t> eventQueue;
+
+    /** @brief Latest queued change of each sensor offset in eventQueue */
+    std::unordered_map<uint32_t, PendingEvent> pendingEvents;
+
+    /** @brief Event handed out to the host and not yet acknowledged */
+    std::optional<PolledEvent> polledEvent;
+
+    /** @brief ID assigned to the last polled event */
+    uint16_t lastEventId = 0;
+
+    /** @brief Whether the host has been told there are events to poll */
+    bool pollNotified = false;
+
+    /** @brief Whether the host polls for queued events instead of having
+     *         them sent
+     */
+#ifdef SENSOR_EVENT_POLLING
+    bool eventPolling = true;
+#else
+    bool eventPolling = false;
+#endif
+
+    /** @brief Token bucket limiting the rate of sent events */
+    double eventTokens = SENSOR_EVENT_BURST;
+
+    /** @brief Last time eventTokens was refilled */
+    std::chrono::steady_clock::time_point lastTokenRefill =
+        std::chrono::steady_clock::now();
+
+    /** @brief Number of changes folded into an already queued event */
+    uint64_t coalescedEvents = 0;
+
+    sdeventplus::Event event;
+
+    /** @brief Timer to send queued events once the rate limit allows */
+    sdbusplus::Timer drainTimer;
 };
 
 } // namespace state_sensor
@@ -969,7 +969,8 @@ void HostPDRHandler::getFRURecordTableMetadataByRemote(
         }
 
         // pass total to getFRURecordTableByRemote
-        this->getFRURecordTableByRemote(fruRecordSetPDRs, total);
+        this->getFRURecordTableByRemote(fruRecordSetPDRs, total,
+                                        fru_table_length);
     };
 
     rc = handler->registerRequest(
@@ -985,9 +986,14 @@ void HostPDRHandler::getFRURecordTableMetadataByRemote(
 }
 
 void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
-                                               uint16_t totalTableRecords)
+                                               uint16_t totalTableRecords,
+                                               uint32_t tableLength)
 {
     fruRecordData.clear();
+    fruRecordTable.clear();
+    fruRecordTableHandles = {0};
+    // Room for the pad bytes and the checksum following the records
+    fruRecordTableLimit = size_t(tableLength) + 3 + sizeof(uint32_t);
 
     if (!totalTableRecords)
     {
@@ -995,6 +1001,14 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
         return;
     }
 
+    getFRURecordTablePartByRemote(fruRecordSetPDRs, totalTableRecords, 0,
+                                  PLDM_GET_FIRSTPART);
+}
+
+void HostPDRHandler::getFRURecordTablePartByRemote(
+    const PDRList& fruRecordSetPDRs, uint16_t totalTableRecords,
+    uint32_t dataTransferHandle, uint8_t transferOpFlag)
+{
     auto instanceId = instanceIdDb.next(mctp_eid);
     std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr) +
                                     PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
@@ -1002,7 +1016,7 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
     // send the getFruRecordTable command
     auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
     auto rc = encode_get_fru_record_table_req(
-        instanceId, 0, PLDM_GET_FIRSTPART, request,
+        instanceId, dataTransferHandle, transferOpFlag, request,
         requestMsg.size() - sizeof(pldm_msg_hdr));
     if (rc != PLDM_SUCCESS)
     {
@@ -1019,6 +1033,7 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
         {
             lg2::error(
                 "Failed to receive response for the Get FRU Record Table");
+            fruRecordTable.clear();
             return;
         }
 
@@ -1026,12 +1041,13 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
         uint32_t next_data_transfer_handle = 0;
         uint8_t transfer_flag = 0;
         size_t fru_record_table_length = 0;
-        std::vector<uint8_t> fru_record_table_data(respMsgLen -
-                                                   sizeof(pldm_msg_hdr));
+        auto curSize = fruRecordTable.size();
+        // Decode the part straight onto the end of the table received so far
+        fruRecordTable.resize(curSize + respMsgLen);
         auto responsePtr = reinterpret_cast<const struct pldm_msg*>(response);
         auto rc = decode_get_fru_record_table_resp(
             responsePtr, respMsgLen, &cc, &next_data_transfer_handle,
-            &transfer_flag, fru_record_table_data.data(),
+            &transfer_flag, fruRecordTable.data() + curSize,
             &fru_record_table_length);
 
         if (rc != PLDM_SUCCESS || cc != PLDM_SUCCESS)
@@ -1039,11 +1055,41 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
             lg2::error(
                 "Failed to decode get fru record table resp, Message Error: {RC}, cc: {CC}",
                 "RC", lg2::hex, rc, "CC", cc);
+            fruRecordTable.clear();
+            return;
+        }
+        fruRecordTable.resize(curSize + fru_record_table_length);
+        if (fruRecordTable.size() > fruRecordTableLimit)
+        {
+            lg2::error(
+                "FRU record table larger than reported, LENGTH={LENGTH}, LIMIT={LIMIT}",
+                "LENGTH", fruRecordTable.size(), "LIMIT", fruRecordTableLimit);
+            fruRecordTable.clear();
+            return;
+        }
+
+        if (transfer_flag == PLDM_START || transfer_flag == PLDM_MIDDLE)
+        {
+            // Every part must make progress towards the end of the table
+            if (!fru_record_table_length ||
+                !fruRecordTableHandles.insert(next_data_transfer_handle).second)
+            {
+                lg2::error(
+                    "FRU record table transfer not progressing, HANDLE={HANDLE}, LENGTH={LENGTH}",
+                    "HANDLE", next_data_transfer_handle, "LENGTH",
+                    fru_record_table_length);
+                fruRecordTable.clear();
+                return;
+            }
+            this->getFRURecordTablePartByRemote(
+                fruRecordSetPDRs, totalTableRecords, next_data_transfer_handle,
+                PLDM_GET_NEXTPART);
             return;
         }
 
         fruRecordData = responder::pdr_utils::parseFruRecordTable(
-            fru_record_table_data.data(), fru_record_table_length);
+            fruRecordTable.data(), fruRecordTable.size());
+        fruRecordTable.clear();
 
         if (totalTableRecords != fruRecordData.size())
         {
@@ -1061,7 +1107,8 @@ void HostPDRHandler::getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
         std::move(requestMsg), std::move(getFruRecordTableResponseHandler));
     if (rc != PLDM_SUCCESS)
     {
-        lg2::error("Failed to send the the Set State Effecter States request");
+        lg2::error("Failed to send the Get FRU Record Table request");
+        fruRecordTable.clear();
     }
 }
 
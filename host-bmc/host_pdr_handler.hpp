@@ -18,6 +18,7 @@
 #include <filesystem>
 #include <map>
 #include <memory>
+#include <set>
 #include <vector>
 
 namespace pldm
@@ -233,10 +234,27 @@ class HostPDRHandler
      *
      *  @param[in] fruRecordSetPDRs  - the Fru Record set PDR's
      *  @param[in] totalTableRecords - the Number of total table records
+     *  @param[in] tableLength - length of the table reported in the metadata,
+     *                           the transfer is aborted if the parts exceed it
      *  @return
      */
     void getFRURecordTableByRemote(const PDRList& fruRecordSetPDRs,
-                                   uint16_t totalTableRecords);
+                                   uint16_t totalTableRecords,
+                                   uint32_t tableLength);
+
+    /** @brief Request one part of the FRU record table from the remote PLDM
+     *         terminus, the following parts are requested as each response
+     *         arrives until the last part has been received
+     *
+     *  @param[in] fruRecordSetPDRs  - the Fru Record set PDR's
+     *  @param[in] totalTableRecords - the Number of total table records
+     *  @param[in] dataTransferHandle - handle of the part to request
+     *  @param[in] transferOpFlag - PLDM_GET_FIRSTPART or PLDM_GET_NEXTPART
+     */
+    void getFRURecordTablePartByRemote(const PDRList& fruRecordSetPDRs,
+                                       uint16_t totalTableRecords,
+                                       uint32_t dataTransferHandle,
+                                       uint8_t transferOpFlag);
 
     /** @brief Create Dbus objects by remote PLDM entity Fru PDRs
      *
@@ -331,6 +349,18 @@ class HostPDRHandler
      */
     std::vector<responder::pdr_utils::FruRecordDataFormat> fruRecordData;
 
+    /** @brief the FRU record table received so far from the remote terminus
+     */
+    std::vector<uint8_t> fruRecordTable;
+
+    /** @brief Maximum size of the FRU record table being received */
+    size_t fruRecordTableLimit = 0;
+
+    /** @brief Data transfer handles requested in the FRU record table
+     *         transfer, a handle repeated by the remote terminus aborts it
+     */
+    std::set<uint32_t> fruRecordTableHandles;
+
     /** @OEM platform handler */
     pldm::responder::oem_platform::Handler* oemPlatformHandler;
 
@@ -0,0 +1,204 @@
+/* Cost of dispatching state sensor PropertiesChanged signals
+ *
+ * A number of objects each drive the offsets of one state sensor, every
+ * offset through its own property. Signals changing one property of an
+ * object are emitted on the bus and dispatched either by one match per
+ * sensor offset, each unpacking the signal as the daemon used to, or by
+ * DbusToPLDMEvent with one match per object. The bus round trip is the same
+ * for both, the difference is the cost of the matches in this process.
+ *
+ * Needs a D-Bus system bus the process may emit signals on.
+ */
+
+#include "common/utils.hpp"
+#include "host-bmc/dbus_to_event_handler.hpp"
+#include "libpldmresponder/pdr_utils.hpp"
+#include "test/test_instance_id.hpp"
+
+#include <endian.h>
+#include <libpldm/pdr.h>
+#include <libpldm/platform.h>
+
+#include <sdbusplus/bus.hpp>
+#include <sdbusplus/bus/match.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace pldm;
+using namespace pldm::responder;
+using namespace sdbusplus::bus::match::rules;
+
+namespace
+{
+
+constexpr size_t objects = 32;
+constexpr size_t offsetsPerObject = 8;
+constexpr size_t signals = 20000;
+constexpr auto benchInterface = "xyz.openbmc_project.Test.Bench";
+const std::string sentinelPath = "/xyz/openbmc_project/test/bench/done";
+
+std::string objectPath(size_t object)
+{
+    return "/xyz/openbmc_project/test/bench/obj" + std::to_string(object);
+}
+
+std::string propertyName(size_t offset)
+{
+    return "State" + std::to_string(offset);
+}
+
+void emitPropertiesChanged(sdbusplus::bus_t& bus, const std::string& path,
+                           const std::string& property, bool value)
+{
+    auto msg = bus.new_signal(path.c_str(), utils::dbusProperties,
+                              "PropertiesChanged");
+    msg.append(std::string(benchInterface),
+               utils::DbusChangedProps{{property, value}},
+               std::vector<std::string>{});
+    msg.signal_send();
+}
+
+/** @brief Emit signals round-robin over the properties of the objects and
+ *         process them with the matches installed on the bus
+ *
+ *  @return nanoseconds per signal, until the last one is dispatched
+ */
+double nsPerSignal(sdbusplus::bus_t& bus)
+{
+    bool done = false;
+    sdbusplus::bus::match_t sentinel(
+        bus, propertiesChanged(sentinelPath, benchInterface),
+        [&done](sdbusplus::message_t&) { done = true; });
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < signals; i++)
+    {
+        emitPropertiesChanged(bus, objectPath(i % objects),
+                              propertyName(i / objects % offsetsPerObject),
+                              i / (objects * offsetsPerObject) % 2);
+        // Keep the receive queue short, as a daemon idle between signals
+        while (bus.process_discard())
+        {}
+    }
+    emitPropertiesChanged(bus, sentinelPath, "Done", true);
+    while (!done)
+    {
+        if (!bus.process_discard())
+        {
+            bus.wait(std::chrono::seconds(1));
+        }
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           signals;
+}
+
+/** @brief Sends nothing, the events only have to be dispatched */
+class DiscardingDbusToPLDMEvent : public state_sensor::DbusToPLDMEvent
+{
+  public:
+    explicit DiscardingDbusToPLDMEvent(InstanceIdDb& instanceIdDb) :
+        DbusToPLDMEvent(0, 9, instanceIdDb, nullptr)
+    {}
+
+    void sendEventMsg(uint8_t /*eventType*/,
+                      const std::vector<uint8_t>& /*eventDataVec*/) override
+    {}
+};
+
+} // namespace
+
+/** @brief Compare the per signal dispatch cost of one match per sensor
+ *         offset with one match per object path
+ */
+int main()
+{
+    auto& bus = utils::DBusHandler::getBus();
+
+    // One match per sensor offset, each unpacking every signal of its object
+    double perOffset = 0;
+    {
+        std::vector<std::unique_ptr<sdbusplus::bus::match_t>> matches;
+        size_t hits = 0;
+        for (size_t object = 0; object < objects; object++)
+        {
+            for (size_t offset = 0; offset < offsetsPerObject; offset++)
+            {
+                matches.push_back(std::make_unique<sdbusplus::bus::match_t>(
+                    bus, propertiesChanged(objectPath(object), benchInterface),
+                    [&hits, property = propertyName(offset)](
+                        sdbusplus::message_t& msg) {
+                    std::string intf;
+                    utils::DbusChangedProps props;
+                    msg.read(intf, props);
+                    if (props.contains(property))
+                    {
+                        hits++;
+                    }
+                }));
+            }
+        }
+        perOffset = nsPerSignal(bus);
+        if (hits != signals)
+        {
+            std::fprintf(stderr, "per offset matches dispatched %zu of %zu\n",
+                         hits, signals);
+            return 1;
+        }
+    }
+
+    // The state sensor PDRs and D-Bus mappings pldmd would build
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo(
+        pldm_pdr_init(), pldm_pdr_destroy);
+    DbusObjMaps dbusMaps;
+    for (size_t object = 0; object < objects; object++)
+    {
+        SensorId sensorId = object + 1;
+        std::vector<uint8_t> pdr(sizeof(pldm_state_sensor_pdr));
+        auto rec = reinterpret_cast<pldm_state_sensor_pdr*>(pdr.data());
+        rec->hdr.type = PLDM_STATE_SENSOR_PDR;
+        rec->hdr.length = htole16(pdr.size() - sizeof(pldm_pdr_hdr));
+        rec->sensor_id = htole16(sensorId);
+        rec->composite_sensor_count = offsetsPerObject;
+        uint32_t handle = 0;
+        if (pldm_pdr_add_check(pdrRepo.get(), pdr.data(), pdr.size(), false,
+                               1, &handle))
+        {
+            throw std::runtime_error("Failed to add a state sensor PDR");
+        }
+
+        pdr_utils::DbusMappings dbusMappings;
+        pdr_utils::DbusValMaps dbusValMaps;
+        for (size_t offset = 0; offset < offsetsPerObject; offset++)
+        {
+            dbusMappings.push_back({objectPath(object), benchInterface,
+                                    propertyName(offset), "bool"});
+            dbusValMaps.push_back({{1, true}, {2, false}});
+        }
+        dbusMaps.emplace(sensorId, std::make_tuple(std::move(dbusMappings),
+                                                   std::move(dbusValMaps)));
+    }
+
+    // One match per object path, dispatched to the listening offsets
+    double perPath = 0;
+    {
+        TestInstanceIdDb instanceIdDb;
+        DiscardingDbusToPLDMEvent handler(instanceIdDb);
+        pdr_utils::Repo repo(pdrRepo.get());
+        handler.listenSensorEvent(repo, dbusMaps);
+        perPath = nsPerSignal(bus);
+    }
+
+    std::printf("%zu objects, %zu offsets each, %zu signals\n", objects,
+                offsetsPerObject, signals);
+    std::printf("match per offset %10.1f ns/signal\n", perOffset);
+    std::printf("match per path   %10.1f ns/signal\n", perPath);
+
+    return 0;
+}
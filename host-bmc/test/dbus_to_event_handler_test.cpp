@@ -0,0 +1,277 @@
+#include "common/instance_id.hpp"
+#include "host-bmc/dbus_to_event_handler.hpp"
+#include "test/test_instance_id.hpp"
+
+#include <libpldm/platform.h>
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm::state_sensor;
+
+/** @brief Records the event messages instead of sending them to the host */
+class RecordingDbusToPLDMEvent : public DbusToPLDMEvent
+{
+  public:
+    explicit RecordingDbusToPLDMEvent(pldm::InstanceIdDb& instanceIdDb) :
+        DbusToPLDMEvent(0, 9, instanceIdDb, nullptr)
+    {}
+
+    void sendEventMsg(uint8_t eventType,
+                      const std::vector<uint8_t>& eventDataVec) override
+    {
+        sent.emplace_back(eventType, eventDataVec);
+    }
+
+    std::vector<std::pair<uint8_t, std::vector<uint8_t>>> sent;
+};
+
+class TestDbusToPLDMEvent : public testing::Test
+{
+  protected:
+    TestDbusToPLDMEvent() : handler(instanceIdDb) {}
+
+    void setPolling(bool polling)
+    {
+        handler.eventPolling = polling;
+    }
+
+    void queue(uint16_t sensorId, uint8_t offset, uint8_t state,
+               uint8_t previousState)
+    {
+        handler.queueSensorEvent(sensorId, offset, state, previousState);
+    }
+
+    /** @brief Set the token bucket as last refilled elapsed ago */
+    void setTokens(double tokens, std::chrono::milliseconds elapsed)
+    {
+        handler.eventTokens = tokens;
+        handler.lastTokenRefill = std::chrono::steady_clock::now() - elapsed;
+    }
+
+    void drain()
+    {
+        handler.drainEvents();
+    }
+
+    size_t queued()
+    {
+        return handler.eventQueue.size();
+    }
+
+    uint64_t coalesced()
+    {
+        return handler.coalescedEvents;
+    }
+
+    bool drainTimerRunning()
+    {
+        return handler.drainTimer.isRunning();
+    }
+
+    /** @brief Listen on a boolean property, true is state 1, false state 2 */
+    void listen(uint16_t sensorId, uint8_t offset, const std::string& path,
+                const std::string& property)
+    {
+        pldm::utils::DBusMapping dbusMapping{path, stateInterface, property,
+                                             "bool"};
+        handler.addPropertyListener(sensorId, offset, dbusMapping,
+                                    {{1, true}, {2, false}});
+    }
+
+    void propertiesChanged(const std::string& path, const std::string& intf,
+                           const pldm::utils::DbusChangedProps& props)
+    {
+        handler.dispatchPropertiesChanged(path, intf, props);
+    }
+
+    /** @brief Poll and acknowledge the queued events
+     *  @return the event data of the events, in the order queued
+     */
+    std::vector<std::vector<uint8_t>> pollAll()
+    {
+        std::vector<std::vector<uint8_t>> events;
+        while (auto polled = handler.getPolledEvent())
+        {
+            events.push_back(polled->eventData);
+            handler.acknowledgePolledEvent(polled->eventId);
+        }
+        return events;
+    }
+
+    /** @brief Check event data is the state sensor event of a sensor offset */
+    static void expectSensorEvent(const std::vector<uint8_t>& eventData,
+                                  uint16_t sensorId, uint8_t offset,
+                                  uint8_t state, uint8_t previousState)
+    {
+        ASSERT_EQ(eventData.size(), DbusToPLDMEvent::maxEventDataSize);
+        auto data =
+            reinterpret_cast<const pldm_sensor_event_data*>(eventData.data());
+        EXPECT_EQ(data->sensor_id, sensorId);
+        EXPECT_EQ(data->sensor_event_class_type, PLDM_STATE_SENSOR_STATE);
+        EXPECT_EQ(data->event_class[0], offset);
+        EXPECT_EQ(data->event_class[1], state);
+        EXPECT_EQ(data->event_class[2], previousState);
+    }
+
+    static constexpr auto stateInterface = "xyz.openbmc_project.Test.State";
+
+    TestInstanceIdDb instanceIdDb;
+    RecordingDbusToPLDMEvent handler;
+};
+
+TEST_F(TestDbusToPLDMEvent, coalesceQueuedEvents)
+{
+    // Nothing is sent until the host polls
+    setPolling(true);
+
+    // The first event is handed out with the poll notification, the changes
+    // after it wait in the queue
+    queue(1, 0, 2, 1);
+    queue(1, 0, 3, 2);
+    queue(1, 0, 4, 3);
+    queue(1, 0, 5, 4);
+    queue(2, 1, 1, 2);
+    EXPECT_EQ(queued(), 2u);
+    EXPECT_EQ(coalesced(), 2u);
+
+    auto polled = handler.getPolledEvent();
+    ASSERT_NE(polled, nullptr);
+    expectSensorEvent(polled->eventData, 1, 0, 2, 1);
+    ASSERT_TRUE(handler.acknowledgePolledEvent(polled->eventId));
+
+    // Coalesced changes keep the previous state the host hasn't seen
+    polled = handler.getPolledEvent();
+    ASSERT_NE(polled, nullptr);
+    expectSensorEvent(polled->eventData, 1, 0, 5, 2);
+    ASSERT_TRUE(handler.acknowledgePolledEvent(polled->eventId));
+
+    polled = handler.getPolledEvent();
+    ASSERT_NE(polled, nullptr);
+    expectSensorEvent(polled->eventData, 2, 1, 1, 2);
+    ASSERT_TRUE(handler.acknowledgePolledEvent(polled->eventId));
+    EXPECT_EQ(handler.getPolledEvent(), nullptr);
+    EXPECT_EQ(handler.sent.size(), 1u);
+}
+
+TEST_F(TestDbusToPLDMEvent, acknowledgementOnly)
+{
+    setPolling(true);
+
+    queue(1, 0, 2, 1);
+    ASSERT_EQ(handler.sent.size(), 1u);
+    EXPECT_EQ(handler.sent[0].first, PLDM_MESSAGE_POLL_EVENT);
+    ASSERT_EQ(handler.sent[0].second.size(),
+              static_cast<size_t>(PLDM_MSG_POLL_EVENT_LENGTH));
+
+    // The host polls the announced event
+    auto polled = handler.getPolledEvent();
+    ASSERT_NE(polled, nullptr);
+    auto eventId = polled->eventId;
+    EXPECT_EQ(handler.sent[0].second[1] | (handler.sent[0].second[2] << 8),
+              eventId);
+    EXPECT_EQ(handler.getPolledEvent()->eventId, eventId);
+
+    // Events queued while the host polls don't notify it again
+    queue(2, 0, 2, 1);
+    EXPECT_EQ(handler.sent.size(), 1u);
+
+    EXPECT_FALSE(handler.acknowledgePolledEvent(eventId + 1));
+    ASSERT_TRUE(handler.acknowledgePolledEvent(eventId));
+    polled = handler.getPolledEvent();
+    ASSERT_NE(polled, nullptr);
+    EXPECT_NE(polled->eventId, eventId);
+
+    // The host acknowledges the last event without polling again
+    ASSERT_TRUE(handler.acknowledgePolledEvent(polled->eventId));
+    EXPECT_EQ(handler.sent.size(), 1u);
+
+    // The next event is announced
+    queue(3, 0, 2, 1);
+    ASSERT_EQ(handler.sent.size(), 2u);
+    EXPECT_EQ(handler.sent[1].first, PLDM_MESSAGE_POLL_EVENT);
+}
+
+TEST_F(TestDbusToPLDMEvent, rateLimit)
+{
+    if (!SENSOR_EVENT_RATE)
+    {
+        GTEST_SKIP() << "Sensor events are not rate limited";
+    }
+    setPolling(false);
+
+    // One token left, the next events wait for the bucket to refill
+    setTokens(1.5, std::chrono::milliseconds(0));
+    queue(1, 0, 2, 1);
+    queue(2, 0, 2, 1);
+    queue(3, 0, 2, 1);
+    ASSERT_EQ(handler.sent.size(), 1u);
+    EXPECT_EQ(handler.sent[0].first, PLDM_SENSOR_EVENT);
+    expectSensorEvent(handler.sent[0].second, 1, 0, 2, 1);
+    EXPECT_EQ(queued(), 2u);
+    EXPECT_TRUE(drainTimerRunning());
+
+    // Queued changes are coalesced while they wait
+    queue(2, 0, 3, 2);
+    EXPECT_EQ(queued(), 2u);
+
+    // Refilled, at most a burst is sent at once, in the order queued
+    setTokens(0, std::chrono::milliseconds(2000));
+    drain();
+    size_t expected = 1 + std::min<size_t>(2, SENSOR_EVENT_BURST);
+    ASSERT_EQ(handler.sent.size(), expected);
+    expectSensorEvent(handler.sent[1].second, 2, 0, 3, 1);
+    if (expected == 3)
+    {
+        expectSensorEvent(handler.sent[2].second, 3, 0, 2, 1);
+    }
+    EXPECT_EQ(queued(), 3 - expected);
+}
+
+TEST_F(TestDbusToPLDMEvent, dispatchPerPath)
+{
+    setPolling(true);
+
+    // Two offsets of sensor 1 on one object, sensor 3 on the same property
+    // as sensor 1 offset 0, and sensor 2 on another object
+    const std::string pathA = "/xyz/openbmc_project/test/a";
+    const std::string pathB = "/xyz/openbmc_project/test/b";
+    listen(1, 0, pathA, "State");
+    listen(1, 1, pathA, "Health");
+    listen(3, 0, pathA, "State");
+    listen(2, 0, pathB, "State");
+
+    // Only the offset listening on the changed property is signalled
+    propertiesChanged(pathA, stateInterface, {{"Health", true}});
+    auto events = pollAll();
+    ASSERT_EQ(events.size(), 1u);
+    expectSensorEvent(events[0], 1, 1, 1, 1);
+
+    // The same property name on another object
+    propertiesChanged(pathB, stateInterface, {{"State", false}});
+    events = pollAll();
+    ASSERT_EQ(events.size(), 1u);
+    expectSensorEvent(events[0], 2, 0, 2, 2);
+
+    // Every offset listening on the property, none for the other property
+    propertiesChanged(pathA, stateInterface,
+                      {{"Other", false}, {"State", true}});
+    events = pollAll();
+    ASSERT_EQ(events.size(), 2u);
+    expectSensorEvent(events[0], 1, 0, 1, 1);
+    expectSensorEvent(events[1], 3, 0, 1, 1);
+
+    // Another interface, an unknown object and a value of the wrong type
+    propertiesChanged(pathA, "xyz.openbmc_project.Test.Other",
+                      {{"State", false}});
+    propertiesChanged("/xyz/openbmc_project/test/c", stateInterface,
+                      {{"State", false}});
+    propertiesChanged(pathA, stateInterface,
+                      {{"State", std::string("false")}});
+    EXPECT_TRUE(pollAll().empty());
+}
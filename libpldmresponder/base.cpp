@@ -39,7 +39,8 @@ static const std::map<Type, Cmd> capabilities{
      {PLDM_GET_PDR, PLDM_SET_STATE_EFFECTER_STATES, PLDM_SET_EVENT_RECEIVER,
       PLDM_GET_SENSOR_READING, PLDM_GET_STATE_SENSOR_READINGS,
       PLDM_SET_NUMERIC_EFFECTER_VALUE, PLDM_GET_NUMERIC_EFFECTER_VALUE,
-      PLDM_PLATFORM_EVENT_MESSAGE}},
+      PLDM_PLATFORM_EVENT_MESSAGE, PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE,
+      PLDM_EVENT_MESSAGE_BUFFER_SIZE}},
     {PLDM_BIOS,
      {PLDM_GET_DATE_TIME, PLDM_SET_DATE_TIME, PLDM_GET_BIOS_TABLE,
       PLDM_GET_BIOS_ATTRIBUTE_CURRENT_VALUE_BY_HANDLE,
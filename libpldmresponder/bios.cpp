@@ -240,7 +240,7 @@ Response Handler::getBIOSTable(const pldm_msg* request, size_t payloadLength)
         return ccOnlyResponse(request, rc);
     }
 
-    auto table =
+    const auto& table =
         biosConfig.getBIOSTable(static_cast<pldm_bios_table_types>(tableType));
     if (!table)
     {
@@ -48,8 +48,9 @@ BIOSConfig::BIOSConfig(
     jsonDir(jsonDir),
     tableDir(tableDir), dbusHandler(dbusHandler), fd(fd), eid(eid),
     instanceIdDb(instanceIdDb), handler(handler),
-    platformConfigHandler(platformConfigHandler)
-
+    platformConfigHandler(platformConfigHandler),
+    event(sdeventplus::Event::get_default()),
+    flushTimer(event.get(), std::bind_front(&BIOSConfig::flushTables, this))
 {
     if (platformConfigHandler)
     {
@@ -64,6 +65,11 @@ BIOSConfig::BIOSConfig(
     listenPendingAttributes();
 }
 
+BIOSConfig::~BIOSConfig()
+{
+    flushTables();
+}
+
 void BIOSConfig::buildTables()
 {
     auto stringTable = buildAndStoreStringTable();
@@ -73,31 +79,35 @@ void BIOSConfig::buildTables()
     }
 }
 
-std::optional<Table> BIOSConfig::getBIOSTable(pldm_bios_table_types tableType)
+fs::path BIOSConfig::tablePath(pldm_bios_table_types tableType) const
 {
-    fs::path tablePath;
     switch (tableType)
     {
         case PLDM_BIOS_STRING_TABLE:
-            tablePath = tableDir / stringTableFile;
-            break;
+            return tableDir / stringTableFile;
         case PLDM_BIOS_ATTR_TABLE:
-            tablePath = tableDir / attrTableFile;
-            break;
+            return tableDir / attrTableFile;
         case PLDM_BIOS_ATTR_VAL_TABLE:
-            tablePath = tableDir / attrValueTableFile;
-            break;
+            return tableDir / attrValueTableFile;
+    }
+    return {};
+}
+
+const std::optional<Table>&
+    BIOSConfig::getBIOSTable(pldm_bios_table_types tableType)
+{
+    auto& cached = tableCache[tableType];
+    if (!cached.loaded)
+    {
+        cached.table = loadTable(tablePath(tableType));
+        cached.loaded = true;
     }
-    return loadTable(tablePath);
+    return cached.table;
 }
 
 int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
                              bool updateBaseBIOSTable)
 {
-    fs::path stringTablePath(tableDir / stringTableFile);
-    fs::path attrTablePath(tableDir / attrTableFile);
-    fs::path attrValueTablePath(tableDir / attrValueTableFile);
-
     if (!pldm_bios_table_checksum(table.data(), table.size()))
     {
         return PLDM_INVALID_BIOS_TABLE_DATA_INTEGRITY_CHECK;
@@ -105,12 +115,11 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
 
     if (tableType == PLDM_BIOS_STRING_TABLE)
     {
-        storeTable(stringTablePath, table);
+        storeTable(PLDM_BIOS_STRING_TABLE, table);
     }
     else if (tableType == PLDM_BIOS_ATTR_TABLE)
     {
-        BIOSTable biosStringTable(stringTablePath.c_str());
-        if (biosStringTable.isEmpty())
+        if (!getBIOSTable(PLDM_BIOS_STRING_TABLE))
         {
             return PLDM_INVALID_BIOS_TABLE_TYPE;
         }
@@ -121,13 +130,12 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
             return rc;
         }
 
-        storeTable(attrTablePath, table);
+        storeTable(PLDM_BIOS_ATTR_TABLE, table);
     }
     else if (tableType == PLDM_BIOS_ATTR_VAL_TABLE)
     {
-        BIOSTable biosStringTable(stringTablePath.c_str());
-        BIOSTable biosStringValueTable(attrTablePath.c_str());
-        if (biosStringTable.isEmpty() || biosStringValueTable.isEmpty())
+        if (!getBIOSTable(PLDM_BIOS_STRING_TABLE) ||
+            !getBIOSTable(PLDM_BIOS_ATTR_TABLE))
         {
             return PLDM_INVALID_BIOS_TABLE_TYPE;
         }
@@ -138,7 +146,7 @@ int BIOSConfig::setBIOSTable(uint8_t tableType, const Table& table,
             return rc;
         }
 
-        storeTable(attrValueTablePath, table);
+        storeTable(PLDM_BIOS_ATTR_VAL_TABLE, table);
     }
     else
     {
@@ -608,10 +616,48 @@ std::optional<Table> BIOSConfig::buildAndStoreStringTable()
     return table;
 }
 
-void BIOSConfig::storeTable(const fs::path& path, const Table& table)
+void BIOSConfig::storeTable(pldm_bios_table_types tableType,
+                            const Table& table)
 {
-    BIOSTable biosTable(path.c_str());
-    biosTable.store(table);
+    auto& cached = tableCache[tableType];
+    cached.table = table;
+    cached.loaded = true;
+    cached.generation++;
+
+    if (!flushTimer.isRunning())
+    {
+        flushTimer.start(
+            std::chrono::duration_cast<std::chrono::microseconds>(
+                tableFlushDelay));
+    }
+}
+
+void BIOSConfig::flushTables()
+{
+    for (auto type : {PLDM_BIOS_STRING_TABLE, PLDM_BIOS_ATTR_TABLE,
+                      PLDM_BIOS_ATTR_VAL_TABLE})
+    {
+        auto& cached = tableCache[type];
+        if (cached.generation == cached.storedGeneration || !cached.table)
+        {
+            continue;
+        }
+
+        try
+        {
+            BIOSTable biosTable(tablePath(type).c_str());
+            biosTable.store(*cached.table);
+            cached.storedGeneration = cached.generation;
+            tableWrites++;
+        }
+        catch (const std::exception& e)
+        {
+            // Leave the table dirty so that the next update retries the
+            // write-back.
+            error("Failed to persist BIOS table type {TYPE}: {ERR_EXCEP}",
+                  "TYPE", static_cast<unsigned>(type), "ERR_EXCEP", e.what());
+        }
+    }
 }
 
 std::optional<Table> BIOSConfig::loadTable(const fs::path& path)
@@ -909,6 +955,12 @@ int BIOSConfig::setAttrValue(const void* entry, size_t size, bool isBMC,
 
 void BIOSConfig::removeTables()
 {
+    flushTimer.stop();
+    for (auto& cached : tableCache)
+    {
+        cached = CachedTable{};
+    }
+
     try
     {
         fs::remove(tableDir / stringTableFile);
@@ -995,7 +1047,7 @@ void BIOSConfig::processBiosAttrChangeNotification(
         *attrValueSrcTable, newValue.data(), newValue.size());
     if (destTable.has_value())
     {
-        storeTable(tableDir / attrValueTableFile, *destTable);
+        storeTable(PLDM_BIOS_ATTR_VAL_TABLE, *destTable);
     }
 
     rc = setAttrValue(newValue.data(), newValue.size(), true, false);
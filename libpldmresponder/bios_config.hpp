@@ -11,7 +11,11 @@
 
 #include <nlohmann/json.hpp>
 #include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/timer.hpp>
+#include <sdeventplus/event.hpp>
 
+#include <array>
+#include <chrono>
 #include <functional>
 #include <iostream>
 #include <memory>
@@ -22,6 +26,8 @@
 
 PHOSPHOR_LOG2_USING;
 
+class TestBIOSConfig;
+
 namespace pldm
 {
 namespace responder
@@ -65,12 +71,14 @@ using PendingAttributes = std::map<AttributeName, PendingObj>;
 class BIOSConfig
 {
   public:
+    friend class ::TestBIOSConfig;
+
     BIOSConfig() = delete;
     BIOSConfig(const BIOSConfig&) = delete;
     BIOSConfig(BIOSConfig&&) = delete;
     BIOSConfig& operator=(const BIOSConfig&) = delete;
     BIOSConfig& operator=(BIOSConfig&&) = delete;
-    ~BIOSConfig() = default;
+    ~BIOSConfig();
 
     /** @brief Construct BIOSConfig
      *  @param[in] jsonDir - The directory where json file exists
@@ -110,9 +118,10 @@ class BIOSConfig
 
     /** @brief Get BIOS table of specified type
      *  @param[in] tableType - The table type
-     *  @return The bios table, std::nullopt if the table is unaviliable
+     *  @return The bios table, std::nullopt if the table is unaviliable. The
+     *          reference is valid until the table is next stored or removed.
      */
-    std::optional<Table> getBIOSTable(pldm_bios_table_types tableType);
+    const std::optional<Table>& getBIOSTable(pldm_bios_table_types tableType);
 
     /** @brief set BIOS table
      *  @param[in] tableType - Indicates what table is being transferred
@@ -126,6 +135,21 @@ class BIOSConfig
     int setBIOSTable(uint8_t tableType, const Table& table,
                      bool updateBaseBIOSTable = true);
 
+    /** @brief Write every table modified since the last flush to persistent
+     *         storage
+     *
+     *  Table updates are applied to the in-memory copy immediately and are
+     *  written back after tableFlushDelay, so that a burst of sets costs a
+     *  single rewrite per table. A table is durable once this returns
+     *  (either from the flush timer, an explicit call or the destructor).
+     */
+    void flushTables();
+
+    /** @brief Delay between the first unflushed table update and the
+     *         write-back of all pending updates
+     */
+    static constexpr std::chrono::milliseconds tableFlushDelay{500};
+
   private:
     /** @enum Index into the fields in the BaseBIOSTable
      */
@@ -179,6 +203,32 @@ class BIOSConfig
     /** @brief system type/model */
     std::string sysType;
 
+    /** @brief In-memory copy of a persisted BIOS table
+     *
+     *  generation is bumped on every update, storedGeneration records the
+     *  generation last written to flash; the table is dirty while they
+     *  differ.
+     */
+    struct CachedTable
+    {
+        std::optional<Table> table;
+        bool loaded = false;
+        uint64_t generation = 0;
+        uint64_t storedGeneration = 0;
+    };
+
+    /** @brief Cached tables, indexed by pldm_bios_table_types */
+    std::array<CachedTable, PLDM_BIOS_ATTR_VAL_TABLE + 1> tableCache;
+
+    /** @brief reference to the default event loop, drives flushTimer */
+    sdeventplus::Event event;
+
+    /** @brief Coalesces table updates into a single deferred write-back */
+    sdbusplus::Timer flushTimer;
+
+    /** @brief Number of tables written back to persistent storage */
+    uint64_t tableWrites = 0;
+
     /** @brief Method to update a BIOS attribute when the corresponding Dbus
      *  property is changed
      *  @param[in] chProperties - list of properties which have changed
@@ -267,11 +317,17 @@ class BIOSConfig
      */
     void buildAndStoreAttrTables(const Table& stringTable);
 
-    /** @brief Persist the table
-     *  @param[in] path - Path to persist the table
+    /** @brief Get the path where a table type is persisted
+     *  @param[in] tableType - The table type
+     *  @return path of the table file
+     */
+    fs::path tablePath(pldm_bios_table_types tableType) const;
+
+    /** @brief Update the cached table and schedule its write-back
+     *  @param[in] tableType - The table type
      *  @param[in] table - The table
      */
-    void storeTable(const fs::path& path, const Table& table);
+    void storeTable(pldm_bios_table_types tableType, const Table& table);
 
     /** @brief Load bios table to ram
      *  @param[in] path - Path of the table
@@ -4,9 +4,15 @@
 #include <libpldm/bios_table.h>
 #include <libpldm/utils.h>
 
+#include <fcntl.h>
+#include <unistd.h>
+
 #include <phosphor-logging/lg2.hpp>
 
+#include <cerrno>
+#include <cstring>
 #include <fstream>
+#include <stdexcept>
 
 namespace pldm
 {
@@ -30,10 +36,76 @@ bool BIOSTable::isEmpty() const noexcept
     return empty;
 }
 
+namespace
+{
+/** @brief Write the whole buffer to fd, retrying on short writes and EINTR
+ *
+ *  @return true on success, false with errno set otherwise
+ */
+bool writeAll(int fd, const uint8_t* data, size_t size)
+{
+    while (size)
+    {
+        auto rc = ::write(fd, data, size);
+        if (rc < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        data += rc;
+        size -= rc;
+    }
+    return true;
+}
+} // namespace
+
 void BIOSTable::store(const Table& table)
 {
-    std::ofstream stream(filePath.string(), std::ios::out | std::ios::binary);
-    stream.write(reinterpret_cast<const char*>(table.data()), table.size());
+    // Write the new contents next to the table, sync them and only then
+    // rename over the old file, so that a power loss leaves either the
+    // previous or the new table on flash, never a truncated one.
+    auto tmpPath = filePath;
+    tmpPath += ".tmp";
+
+    int fd = ::open(tmpPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC,
+                    0644);
+    if (fd < 0)
+    {
+        throw std::runtime_error("Failed to open " + tmpPath.string() + ": " +
+                                 std::strerror(errno));
+    }
+
+    bool ok = writeAll(fd, table.data(), table.size()) && ::fsync(fd) == 0;
+    int savedErrno = errno;
+    ::close(fd);
+    if (!ok)
+    {
+        fs::remove(tmpPath);
+        throw std::runtime_error("Failed to write " + tmpPath.string() +
+                                 ": " + std::strerror(savedErrno));
+    }
+
+    if (::rename(tmpPath.c_str(), filePath.c_str()) < 0)
+    {
+        savedErrno = errno;
+        fs::remove(tmpPath);
+        throw std::runtime_error("Failed to rename " + tmpPath.string() +
+                                 ": " + std::strerror(savedErrno));
+    }
+
+    // Persist the directory entry as well, otherwise the rename itself may
+    // be lost on power failure.
+    auto dirPath = filePath.has_parent_path() ? filePath.parent_path()
+                                              : fs::path(".");
+    int dirFd = ::open(dirPath.c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirFd >= 0)
+    {
+        ::fsync(dirFd);
+        ::close(dirFd);
+    }
 }
 
 void BIOSTable::load(Response& response) const
@@ -56,8 +56,14 @@ class BIOSTable
     bool isEmpty() const noexcept;
 
     /** @brief Persist a BIOS table(string/attribute/attribute value)
+     *
+     *  The table is written to a temporary file, synced and renamed over the
+     *  previous one, so the persisted table is either the old or the new one
+     *  even across a power loss.
      *
      *  @param[in] table - BIOS table
+     *
+     *  @throw std::runtime_error if the table could not be persisted
      */
     void store(const Table& table);
 
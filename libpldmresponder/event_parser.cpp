@@ -6,6 +6,7 @@
 #include <filesystem>
 #include <fstream>
 #include <set>
+#include <variant>
 
 PHOSPHOR_LOG2_USING;
 
@@ -93,9 +94,13 @@ StateSensorHandler::StateSensorHandler(const std::string& dirPath)
 
             auto eventStateMap = mapStateToDBusVal(eventStates, propertyValues,
                                                    dbusInfo.propertyType);
+            auto setters = makeSetters(eventStateMap);
             eventMap.emplace(
                 stateSensorEntry,
-                std::make_tuple(std::move(dbusInfo), std::move(eventStateMap)));
+                EventAction{std::make_tuple(std::move(dbusInfo),
+                                            std::move(eventStateMap)),
+                            std::move(setters),
+                            {}});
         }
     }
 }
@@ -116,42 +121,79 @@ StateToDBusValue StateSensorHandler::mapStateToDBusVal(
     return eventStateMap;
 }
 
+template <typename T>
+static void appendAs(sdbusplus::message_t& method,
+                     const pldm::utils::PropertyValue& value)
+{
+    method.append(std::variant<T>(std::get<T>(value)));
+}
+
+std::vector<StateSetter>
+    StateSensorHandler::makeSetters(const StateToDBusValue& eventStateMap)
+{
+    std::vector<StateSetter> setters;
+    if (eventStateMap.empty())
+    {
+        return setters;
+    }
+
+    setters.resize(eventStateMap.rbegin()->first + 1);
+    for (const auto& [state, value] : eventStateMap)
+    {
+        setters[state].append = std::visit(
+            [](const auto& v) -> AppendValue {
+            return &appendAs<std::decay_t<decltype(v)>>;
+        },
+            value);
+        setters[state].value = value;
+    }
+    return setters;
+}
+
 int StateSensorHandler::eventAction(const StateSensorEntry& entry,
                                     pdr::EventState state)
 {
+    auto it = eventMap.find(entry);
+    if (it == eventMap.end())
+    {
+        // There is no BMC action for this PLDM event
+        return PLDM_SUCCESS;
+    }
+
+    auto& action = it->second;
+    if (state >= action.setters.size() || !action.setters[state].append)
+    {
+        error("Invalid event state '{EVENT_STATE}'", "EVENT_STATE", state);
+        return PLDM_ERROR_INVALID_DATA;
+    }
+
+    const auto& dbusMapping = std::get<pldm::utils::DBusMapping>(action.info);
+    const auto& setter = action.setters[state];
     try
     {
-        const auto& [dbusMapping, eventStateMap] = eventMap.at(entry);
-        utils::PropertyValue propValue{};
-        try
-        {
-            propValue = eventStateMap.at(state);
-        }
-        catch (const std::out_of_range& e)
+        if (action.service.empty())
         {
-            error("Invalid event state '{EVENT_STATE}': {ERROR}", "EVENT_STATE",
-                  state, "ERROR", e);
-            return PLDM_ERROR_INVALID_DATA;
+            action.service = pldm::utils::DBusHandler().getService(
+                dbusMapping.objectPath.c_str(), dbusMapping.interface.c_str());
         }
 
-        try
-        {
-            pldm::utils::DBusHandler().setDbusProperty(dbusMapping, propValue);
-        }
-        catch (const std::exception& e)
-        {
-            error(
-                "Error setting property value '{PROPERTY}' on interface '{INTERFACE}' at '{PATH}': {ERROR}",
-                "PROPERTY", dbusMapping.propertyName, "INTERFACE",
-                dbusMapping.interface, "PATH", dbusMapping.objectPath, "ERROR",
-                e);
-            return PLDM_ERROR;
-        }
+        auto& bus = pldm::utils::DBusHandler::getBus();
+        auto method = bus.new_method_call(action.service.c_str(),
+                                          dbusMapping.objectPath.c_str(),
+                                          pldm::utils::dbusProperties, "Set");
+        method.append(dbusMapping.interface, dbusMapping.propertyName);
+        setter.append(method, setter.value);
+        bus.call_noreply(method, dbusTimeout);
     }
-    catch (const std::out_of_range&)
+    catch (const std::exception& e)
     {
-        // There is no BMC action for this PLDM event
-        return PLDM_SUCCESS;
+        // The service may have been restarted, look it up again next time
+        action.service.clear();
+        error(
+            "Error setting property value '{PROPERTY}' on interface '{INTERFACE}' at '{PATH}': {ERROR}",
+            "PROPERTY", dbusMapping.propertyName, "INTERFACE",
+            dbusMapping.interface, "PATH", dbusMapping.objectPath, "ERROR", e);
+        return PLDM_ERROR;
     }
     return PLDM_SUCCESS;
 }
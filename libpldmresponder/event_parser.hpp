@@ -9,8 +9,11 @@
 #include <map>
 #include <string>
 #include <tuple>
+#include <unordered_map>
 #include <vector>
 
+class TestStateSensorHandler;
+
 namespace pldm::responder::events
 {
 
@@ -18,8 +21,9 @@ namespace pldm::responder::events
  *
  *  StateSensorEntry is a key to uniquely identify a state sensor, so that a
  *  D-Bus action can be defined for PlatformEventMessage command with
- *  sensorEvent type. This struct is used as a key in a std::map so implemented
- *  operator== and operator<.
+ *  sensorEvent type. This struct is used as a key in a std::unordered_map
+ *  with StateSensorEntryHash so implemented operator==, operator< is kept
+ *  for ordered containers.
  */
 struct StateSensorEntry
 {
@@ -53,11 +57,64 @@ struct StateSensorEntry
     }
 };
 
+/** @struct StateSensorEntryHash
+ *
+ *  Hashes a StateSensorEntry by packing its container ID, entity type,
+ *  entity instance and state set ID into one 64-bit word and mixing in the
+ *  sensor offset.
+ */
+struct StateSensorEntryHash
+{
+    size_t operator()(const StateSensorEntry& e) const noexcept
+    {
+        uint64_t packed = (static_cast<uint64_t>(e.containerId) << 48) |
+                          (static_cast<uint64_t>(e.entityType) << 32) |
+                          (static_cast<uint64_t>(e.entityInstance) << 16) |
+                          e.stateSetid;
+        packed ^= e.sensorOffset * 0x9e3779b97f4a7c15ULL;
+        return std::hash<uint64_t>{}(packed);
+    }
+};
+
 using StateToDBusValue = std::map<pdr::EventState, pldm::utils::PropertyValue>;
 using EventDBusInfo = std::tuple<pldm::utils::DBusMapping, StateToDBusValue>;
-using EventMap = std::map<StateSensorEntry, EventDBusInfo>;
 using Json = nlohmann::json;
 
+/** @brief Append a property value to a D-Bus Set method call as a variant of
+ *         the property's own type
+ */
+using AppendValue = void (*)(sdbusplus::message_t& method,
+                             const pldm::utils::PropertyValue& value);
+
+/** @struct StateSetter
+ *
+ *  The D-Bus property value for one event state, with the appender for its
+ *  type resolved when the JSON is parsed.
+ */
+struct StateSetter
+{
+    AppendValue append = nullptr;
+    pldm::utils::PropertyValue value;
+};
+
+/** @struct EventAction
+ *
+ *  The D-Bus action of a state sensor, compiled from the event JSON.
+ */
+struct EventAction
+{
+    EventDBusInfo info;
+    /** @brief setters indexed by event state, states without a D-Bus value
+     *         have no appender
+     */
+    std::vector<StateSetter> setters;
+    /** @brief D-Bus service hosting the object, looked up on first use */
+    std::string service;
+};
+
+using EventMap =
+    std::unordered_map<StateSensorEntry, EventAction, StateSensorEntryHash>;
+
 /** @class StateSensorHandler
  *
  *  @brief Parses the event state sensor configuration JSON file and build
@@ -68,6 +125,8 @@ using Json = nlohmann::json;
 class StateSensorHandler
 {
   public:
+    friend class ::TestStateSensorHandler;
+
     StateSensorHandler() = delete;
 
     /** @brief Parse the event state sensor configuration JSON file and build
@@ -101,11 +160,11 @@ class StateSensorHandler
      */
     const EventDBusInfo& getEventInfo(const StateSensorEntry& entry) const
     {
-        return eventMap.at(entry);
+        return eventMap.at(entry).info;
     }
 
   private:
-    EventMap eventMap; //!< a map of StateSensorEntry to D-Bus information
+    EventMap eventMap; //!< a map of StateSensorEntry to D-Bus action
 
     /** @brief Create a map of EventState to D-Bus property values from
      *         the information provided in the event state configuration
@@ -120,6 +179,15 @@ class StateSensorHandler
     StateToDBusValue mapStateToDBusVal(const Json& eventStates,
                                        const Json& propertyValues,
                                        std::string_view type);
+
+    /** @brief Build the setters indexed by event state
+     *
+     *  @param[in] eventStateMap - map of EventState to D-Bus property values
+     *
+     *  @return the setter of each event state
+     */
+    static std::vector<StateSetter>
+        makeSetters(const StateToDBusValue& eventStateMap);
 };
 
 } // namespace pldm::responder::events
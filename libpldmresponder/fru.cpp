@@ -9,6 +9,10 @@
 #include <phosphor-logging/lg2.hpp>
 #include <sdbusplus/bus.hpp>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <functional>
 #include <optional>
 #include <set>
 #include <stack>
@@ -21,6 +25,8 @@ namespace responder
 {
 
 constexpr auto root = "/xyz/openbmc_project/inventory/";
+constexpr auto itemInterface = "xyz.openbmc_project.Inventory.Item";
+constexpr auto presentProperty = "Present";
 
 std::optional<pldm_entity>
     FruImpl::getEntityByObjectPath(const dbus::InterfaceMap& intfMaps)
@@ -147,7 +153,6 @@ void FruImpl::buildFRUTable()
     fru_parser::DBusLookupInfo dbusInfo;
     // Read the all the inventory D-Bus objects
     auto& bus = pldm::utils::DBusHandler::getBus();
-    dbus::ObjectValueTree objects;
 
     try
     {
@@ -156,7 +161,7 @@ void FruImpl::buildFRUTable()
             std::get<0>(dbusInfo).c_str(), std::get<1>(dbusInfo).c_str(),
             "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
         auto reply = bus.call(method, dbusTimeout);
-        reply.read(objects);
+        reply.read(inventoryObjects);
     }
     catch (const std::exception& e)
     {
@@ -165,68 +170,585 @@ void FruImpl::buildFRUTable()
         return;
     }
 
-    auto itemIntfsLookup = std::get<2>(dbusInfo);
+    auto startTime = std::chrono::steady_clock::now();
 
-    for (const auto& object : objects)
+    // The Present property normally comes with GetManagedObjects, only look
+    // up the FRUs for which the inventory manager did not report it.
+    const auto& itemIntfsLookup = std::get<2>(dbusInfo);
+    std::vector<dbus::ObjectPath> missingPresence;
+    for (const auto& [path, interfaces] : inventoryObjects)
     {
-        const auto& interfaces = object.second;
-        for (const auto& interface : interfaces)
+        bool isItem = std::ranges::any_of(interfaces, [&](const auto& intf) {
+            return itemIntfsLookup.contains(intf.first);
+        });
+        if (isItem && !getPresence(interfaces))
         {
-            if (itemIntfsLookup.contains(interface.first))
+            missingPresence.emplace_back(path.str);
+        }
+    }
+    fetchPresence(missingPresence);
+
+    for (const auto& object : inventoryObjects)
+    {
+        addFRU(object.first.str);
+    }
+
+    int rc = pldm_entity_association_pdr_add_check(entityTree, pdrRepo, false,
+                                                   TERMINUS_HANDLE);
+    if (rc < 0)
+    {
+        // pldm_entity_assocation_pdr_add() assert()ed on failure
+        error("Failed to add PLDM entity association PDR: {LIBPLDM_ERROR}",
+              "LIBPLDM_ERROR", rc);
+        throw std::runtime_error("Failed to add PLDM entity association PDR");
+    }
+
+    // save a copy of bmc's entity association tree
+    pldm_entity_association_tree_copy_root(entityTree, bmcEntityTree);
+
+    isBuilt = true;
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime);
+    info(
+        "Built FRU table with {RECORDS} records from {OBJECTS} inventory objects in {DURATION} ms, {FETCHED} presence lookups",
+        "RECORDS", numRecs, "OBJECTS", inventoryObjects.size(), "DURATION",
+        elapsed.count(), "FETCHED", missingPresence.size());
+
+    subscribeInventorySignals(std::get<1>(dbusInfo));
+}
+
+std::optional<bool> FruImpl::getPresence(const dbus::InterfaceMap& interfaces)
+{
+    auto intfIt = interfaces.find(itemInterface);
+    if (intfIt == interfaces.end())
+    {
+        return std::nullopt;
+    }
+    auto propIt = intfIt->second.find(presentProperty);
+    if (propIt == intfIt->second.end())
+    {
+        return std::nullopt;
+    }
+    auto present = std::get_if<bool>(&propIt->second);
+    if (!present)
+    {
+        return std::nullopt;
+    }
+    return *present;
+}
+
+void FruImpl::fetchPresence(const std::vector<dbus::ObjectPath>& paths)
+{
+    if (paths.empty())
+    {
+        return;
+    }
+
+    // Resolve the owners of the objects. A single object is looked up by
+    // itself, several with one mapper call rather than a GetObject each.
+    pldm::utils::DBusHandler dbusHandler;
+    const auto& inventoryPath = std::get<1>(parser.inventoryLookup());
+    std::map<std::string, std::vector<dbus::ObjectPath>> pathsByService;
+    try
+    {
+        if (paths.size() == 1)
+        {
+            pathsByService[dbusHandler.getService(paths.front().c_str(),
+                                                  itemInterface)]
+                .emplace_back(paths.front());
+        }
+        else
+        {
+            std::set<dbus::ObjectPath> wanted(paths.begin(), paths.end());
+            auto subtree = dbusHandler.getSubtree(inventoryPath, 0,
+                                                  {itemInterface});
+            for (const auto& [path, serviceMap] : subtree)
             {
-                // checking fru present property is available or not.
-                if (!pldm::utils::checkForFruPresence(object.first.str))
+                if (!serviceMap.empty() && wanted.contains(path))
                 {
-                    continue;
+                    pathsByService[serviceMap.front().first].emplace_back(
+                        path);
                 }
+            }
+        }
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to look up inventory item owners: {ERROR}", "ERROR", e);
+        return;
+    }
+
+    auto& bus = pldm::utils::DBusHandler::getBus();
+    auto getAll = [&bus](const std::string& service,
+                         const dbus::ObjectPath& path) {
+        auto method = bus.new_method_call(service.c_str(), path.c_str(),
+                                          pldm::utils::dbusProperties,
+                                          "GetAll");
+        method.append(itemInterface);
+        return bus.call(method, dbusTimeout).unpack<dbus::PropertyMap>();
+    };
+
+    // Only the presence actually read is added to the snapshot, a FRU whose
+    // presence couldn't be read is looked up again the next time
+    for (const auto& [service, servicePaths] : pathsByService)
+    {
+        dbus::ObjectValueTree objects;
+        if (servicePaths.size() > 1)
+        {
+            // One GetManagedObjects for all the FRUs of the service
+            try
+            {
+                auto method = bus.new_method_call(
+                    service.c_str(), inventoryPath.c_str(),
+                    "org.freedesktop.DBus.ObjectManager", "GetManagedObjects");
+                bus.call(method, dbusTimeout).read(objects);
+            }
+            catch (const std::exception& e)
+            {
+                error(
+                    "Failed to get the inventory objects of {SERVICE}, reading each FRU: {ERROR}",
+                    "SERVICE", service, "ERROR", e);
+            }
+        }
 
-                // An exception will be thrown by getRecordInfo, if the item
-                // D-Bus interface name specified in FRU_Master.json does
-                // not have corresponding config jsons
+        for (const auto& path : servicePaths)
+        {
+            std::optional<bool> present;
+            auto objIt = objects.find(sdbusplus::message::object_path(path));
+            if (objIt != objects.end())
+            {
+                present = getPresence(objIt->second);
+            }
+            else
+            {
                 try
                 {
-                    updateAssociationTree(objects, object.first.str);
-                    pldm_entity entity{};
-                    if (objToEntityNode.contains(object.first.str))
-                    {
-                        pldm_entity_node* node =
-                            objToEntityNode.at(object.first.str);
-
-                        entity = pldm_entity_extract(node);
-                    }
-
-                    auto recordInfos = parser.getRecordInfo(interface.first);
-                    populateRecords(interfaces, recordInfos, entity);
-
-                    associatedEntityMap.emplace(object.first, entity);
-                    break;
+                    present = getPresence({{itemInterface,
+                                            getAll(service, path)}});
                 }
                 catch (const std::exception& e)
                 {
                     error(
-                        "Config JSONs missing for the item interface type, interface = {INTF}",
-                        "INTF", interface.first);
-                    break;
+                        "Failed to check for FRU presence for {OBJ_PATH} ERROR = {ERR_EXCEP}",
+                        "OBJ_PATH", path, "ERR_EXCEP", e.what());
                 }
             }
+            if (present)
+            {
+                inventoryObjects[path][itemInterface][presentProperty] =
+                    *present;
+            }
         }
     }
+}
 
-    int rc = pldm_entity_association_pdr_add_check(entityTree, pdrRepo, false,
-                                                   TERMINUS_HANDLE);
-    if (rc < 0)
+bool FruImpl::addFRU(const dbus::ObjectPath& objectPath)
+{
+    auto objIt = inventoryObjects.find(objectPath);
+    if (objIt == inventoryObjects.end())
     {
-        // pldm_entity_assocation_pdr_add() assert()ed on failure
-        error("Failed to add PLDM entity association PDR: {LIBPLDM_ERROR}",
-              "LIBPLDM_ERROR", rc);
-        throw std::runtime_error("Failed to add PLDM entity association PDR");
+        return false;
     }
 
-    // save a copy of bmc's entity association tree
-    pldm_entity_association_tree_copy_root(entityTree, bmcEntityTree);
+    const auto& itemIntfsLookup = std::get<2>(parser.inventoryLookup());
+    const auto& interfaces = objIt->second;
+    for (const auto& interface : interfaces)
+    {
+        if (!itemIntfsLookup.contains(interface.first))
+        {
+            continue;
+        }
 
-    isBuilt = true;
+        // checking fru present property is available or not.
+        auto present = getPresence(interfaces);
+        if (!present)
+        {
+            fetchPresence({objectPath});
+            present = getPresence(interfaces);
+        }
+        if (!present.value_or(false))
+        {
+            return false;
+        }
+
+        // An exception will be thrown by getRecordInfo, if the item
+        // D-Bus interface name specified in FRU_Master.json does
+        // not have corresponding config jsons
+        try
+        {
+            updateAssociationTree(inventoryObjects, objectPath);
+            pldm_entity entity{};
+            if (objToEntityNode.contains(objectPath))
+            {
+                pldm_entity_node* node = objToEntityNode.at(objectPath);
+
+                entity = pldm_entity_extract(node);
+
+                if (isBuilt)
+                {
+                    // The association PDRs were already generated from the
+                    // tree, account for the new entity in them and in the
+                    // BMC's copy of the tree.
+                    auto parentIt = objToEntityNode.find(
+                        pldm::utils::findParent(objectPath));
+                    if (parentIt != objToEntityNode.end())
+                    {
+                        pldm_entity parent =
+                            pldm_entity_extract(parentIt->second);
+                        uint32_t assocRecordHandle = 0;
+                        pldm_entity_association_pdr_create_new(
+                            pdrRepo, 0, &parent, &entity, &assocRecordHandle);
+                        auto bmcParent = pldm_entity_association_tree_find(
+                            bmcEntityTree, &parent);
+                        if (bmcParent)
+                        {
+                            pldm_entity_association_tree_add_entity(
+                                bmcEntityTree, &entity, 0xFFFF, bmcParent,
+                                PLDM_ENTITY_ASSOCIAION_PHYSICAL, false, true,
+                                0xFFFF);
+                        }
+                    }
+                }
+            }
+
+            auto recordInfos = parser.getRecordInfo(interface.first);
+            populateRecords(objectPath, interfaces, recordInfos, entity);
+
+            associatedEntityMap.emplace(objectPath, entity);
+            return true;
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "Config JSONs missing for the item interface type, interface = {INTF}",
+                "INTF", interface.first);
+            return false;
+        }
+    }
+
+    return false;
+}
+
+void FruImpl::updateFRU(const dbus::ObjectPath& objectPath)
+{
+    auto setIt = findRecordSet(objectPath);
+    auto objIt = inventoryObjects.find(objectPath);
+    if (setIt == recordSets.end() || objIt == inventoryObjects.end())
+    {
+        return;
+    }
+
+    const auto& itemIntfsLookup = std::get<2>(parser.inventoryLookup());
+    std::vector<uint8_t> records;
+    uint16_t count = 0;
+    for (const auto& interface : objIt->second)
+    {
+        if (!itemIntfsLookup.contains(interface.first))
+        {
+            continue;
+        }
+        try
+        {
+            auto recordInfos = parser.getRecordInfo(interface.first);
+            records = encodeRecords(objIt->second, recordInfos, setIt->entity,
+                                    setIt->rsi, count);
+        }
+        catch (const std::exception& e)
+        {
+            error(
+                "Config JSONs missing for the item interface type, interface = {INTF}",
+                "INTF", interface.first);
+        }
+        break;
+    }
+
+    if (records.empty())
+    {
+        // Nothing left to describe the FRU with, drop it from the table
+        removeFRU(objectPath);
+        return;
+    }
+
+    if (records.size() == setIt->length &&
+        std::equal(records.begin(), records.end(),
+                   table.begin() + setIt->offset))
+    {
+        return;
+    }
+
+    auto first = table.begin() + setIt->offset;
+    if (records.size() >= setIt->length)
+    {
+        std::copy_n(records.begin(), setIt->length, first);
+        table.insert(first + setIt->length, records.begin() + setIt->length,
+                     records.end());
+    }
+    else
+    {
+        std::copy(records.begin(), records.end(), first);
+        table.erase(first + records.size(), first + setIt->length);
+    }
+
+    auto delta = static_cast<ptrdiff_t>(records.size()) -
+                 static_cast<ptrdiff_t>(setIt->length);
+    for (auto it = setIt + 1; it != recordSets.end(); ++it)
+    {
+        it->offset += delta;
+    }
+    numRecs = numRecs - setIt->numRecords + count;
+    setIt->numRecords = count;
+    setIt->length = records.size();
+
+    rechainChecksum(std::distance(recordSets.begin(), setIt));
+    tableChangeCount++;
 }
+
+void FruImpl::removeFRU(const dbus::ObjectPath& objectPath)
+{
+    // Entities contained in the removed FRU go away with it
+    auto prefix = objectPath + "/";
+    std::vector<dbus::ObjectPath> contained;
+    for (const auto& [path, node] : objToEntityNode)
+    {
+        if (path.starts_with(prefix))
+        {
+            contained.emplace_back(path);
+        }
+    }
+    // Remove the innermost entities first
+    for (auto it = contained.rbegin(); it != contained.rend(); ++it)
+    {
+        removeFRU(*it);
+    }
+
+    auto setIt = findRecordSet(objectPath);
+    if (setIt != recordSets.end())
+    {
+        auto first = table.begin() + setIt->offset;
+        table.erase(first, first + setIt->length);
+        for (auto it = setIt + 1; it != recordSets.end(); ++it)
+        {
+            it->offset -= setIt->length;
+        }
+        numRecs -= setIt->numRecords;
+
+        uint32_t removedRecordHandle = 0;
+        pldm_pdr_remove_fru_record_set_by_rsi(pdrRepo, setIt->rsi, false,
+                                              &removedRecordHandle);
+
+        auto index = std::distance(recordSets.begin(), setIt);
+        auto crcAtOffset = setIt->crcAtOffset;
+        recordSets.erase(setIt);
+        if (static_cast<size_t>(index) < recordSets.size())
+        {
+            recordSets[index].crcAtOffset = crcAtOffset;
+            rechainChecksum(index);
+        }
+        else
+        {
+            tableCrcState = crcAtOffset;
+            updateChecksum();
+        }
+        tableChangeCount++;
+    }
+
+    auto nodeIt = objToEntityNode.find(objectPath);
+    if (nodeIt != objToEntityNode.end())
+    {
+        pldm_entity entity = pldm_entity_extract(nodeIt->second);
+        uint32_t assocRecordHandle = 0;
+        pldm_entity_association_pdr_remove_contained_entity(
+            pdrRepo, &entity, false, &assocRecordHandle);
+        pldm_entity_association_tree_delete_node(entityTree, &entity);
+        pldm_entity_association_tree_delete_node(bmcEntityTree, &entity);
+        objToEntityNode.erase(nodeIt);
+    }
+    associatedEntityMap.erase(objectPath);
+}
+
+std::vector<FruImpl::FruRecordSet>::iterator
+    FruImpl::findRecordSet(const dbus::ObjectPath& objectPath)
+{
+    return std::find_if(recordSets.begin(), recordSets.end(),
+                        [&objectPath](const auto& recordSet) {
+        return recordSet.objectPath == objectPath;
+    });
+}
+
+void FruImpl::rechainChecksum(size_t index)
+{
+    if (index >= recordSets.size())
+    {
+        updateChecksum();
+        return;
+    }
+
+    // Records before index are untouched, so resume from the CRC state saved
+    // at the first changed record set instead of walking the whole table.
+    auto state = recordSets[index].crcAtOffset;
+    for (auto it = recordSets.begin() + index; it != recordSets.end(); ++it)
+    {
+        it->crcAtOffset = state;
+        state = pldm::utils::crc32Update(state, table.data() + it->offset,
+                                         it->length);
+    }
+    tableCrcState = state;
+    updateChecksum();
+}
+
+void FruImpl::updateChecksum()
+{
+    static constexpr std::array<uint8_t, 3> pad{};
+    padBytes = pldm::utils::getNumPadBytes(table.size());
+    tableImage.reset();
+    checksum = table.size()
+                   ? pldm::utils::crc32Final(pldm::utils::crc32Update(
+                         tableCrcState, pad.data(), padBytes))
+                   : 0;
+}
+
+void FruImpl::subscribeInventorySignals(const std::string& inventoryPath)
+{
+    using namespace sdbusplus::bus::match::rules;
+    auto& bus = pldm::utils::DBusHandler::getBus();
+
+    inventoryMatches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus, interfacesAdded(inventoryPath),
+        std::bind_front(&FruImpl::processInterfacesAdded, this)));
+    inventoryMatches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus, interfacesRemoved(inventoryPath),
+        std::bind_front(&FruImpl::processInterfacesRemoved, this)));
+    inventoryMatches.emplace_back(std::make_unique<sdbusplus::bus::match_t>(
+        bus,
+        type::signal() + member("PropertiesChanged") +
+            interface(pldm::utils::dbusProperties) +
+            path_namespace(inventoryPath),
+        std::bind_front(&FruImpl::processPropertiesChanged, this)));
+}
+
+void FruImpl::processInterfacesAdded(sdbusplus::message_t& msg)
+{
+    sdbusplus::message::object_path path;
+    dbus::InterfaceMap interfaces;
+    try
+    {
+        msg.read(path, interfaces);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to read InterfacesAdded signal: {ERROR}", "ERROR", e);
+        return;
+    }
+
+    auto& cached = inventoryObjects[path];
+    for (auto& [intf, props] : interfaces)
+    {
+        for (auto& [prop, value] : props)
+        {
+            cached[intf][prop] = std::move(value);
+        }
+    }
+
+    if (findRecordSet(path.str) != recordSets.end())
+    {
+        updateFRU(path.str);
+    }
+    else
+    {
+        addFRU(path.str);
+    }
+}
+
+void FruImpl::processInterfacesRemoved(sdbusplus::message_t& msg)
+{
+    sdbusplus::message::object_path path;
+    std::vector<std::string> interfaces;
+    try
+    {
+        msg.read(path, interfaces);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to read InterfacesRemoved signal: {ERROR}", "ERROR", e);
+        return;
+    }
+
+    auto objIt = inventoryObjects.find(path);
+    if (objIt == inventoryObjects.end())
+    {
+        return;
+    }
+
+    const auto& itemIntfsLookup = std::get<2>(parser.inventoryLookup());
+    bool itemRemoved = false;
+    for (const auto& intf : interfaces)
+    {
+        itemRemoved |= itemIntfsLookup.contains(intf);
+        objIt->second.erase(intf);
+    }
+
+    if (itemRemoved || objIt->second.empty())
+    {
+        inventoryObjects.erase(objIt);
+        removeFRU(path.str);
+    }
+    else
+    {
+        updateFRU(path.str);
+    }
+}
+
+void FruImpl::processPropertiesChanged(sdbusplus::message_t& msg)
+{
+    std::string intf;
+    dbus::PropertyMap props;
+    try
+    {
+        msg.read(intf, props);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to read PropertiesChanged signal: {ERROR}", "ERROR", e);
+        return;
+    }
+
+    std::string path = msg.get_path();
+    auto objIt = inventoryObjects.find(path);
+    if (objIt == inventoryObjects.end())
+    {
+        return;
+    }
+
+    auto& cachedProps = objIt->second[intf];
+    for (auto& [prop, value] : props)
+    {
+        cachedProps[prop] = std::move(value);
+    }
+
+    bool tracked = findRecordSet(path) != recordSets.end();
+    auto presentIt = props.find(presentProperty);
+    if (intf == itemInterface && presentIt != props.end())
+    {
+        auto present = std::get_if<bool>(&presentIt->second);
+        if (present && *present && !tracked)
+        {
+            addFRU(path);
+            return;
+        }
+        if (present && !*present)
+        {
+            removeFRU(path);
+            return;
+        }
+    }
+
+    if (tracked)
+    {
+        updateFRU(path);
+    }
+}
+
 std::string FruImpl::populatefwVersion()
 {
     static constexpr auto fwFunctionalObjPath =
@@ -257,14 +779,55 @@ std::string FruImpl::populatefwVersion()
     return currentBmcVersion;
 }
 void FruImpl::populateRecords(
+    const dbus::ObjectPath& objectPath,
     const pldm::responder::dbus::InterfaceMap& interfaces,
     const fru_parser::FruRecordInfos& recordInfos, const pldm_entity& entity)
 {
     // recordSetIdentifier for the FRU will be set when the first record gets
     // added for the FRU
-    uint16_t recordSetIdentifier = 0;
-    auto numRecsCount = numRecs;
-    static uint32_t bmc_record_handle = 0;
+    uint16_t count = 0;
+    auto records = encodeRecords(interfaces, recordInfos, entity, rsi + 1,
+                                 count);
+    if (records.empty())
+    {
+        return;
+    }
+
+    auto recordSetIdentifier = nextRSI();
+    uint32_t bmcRecordHandle = nextRecordHandle();
+    int rc = pldm_pdr_add_fru_record_set_check(
+        pdrRepo, TERMINUS_HANDLE, recordSetIdentifier, entity.entity_type,
+        entity.entity_instance_num, entity.entity_container_id,
+        &bmcRecordHandle);
+    if (rc)
+    {
+        // pldm_pdr_add_fru_record_set() assert()ed on failure
+        throw std::runtime_error("Failed to add PDR FRU record set");
+    }
+
+    recordSets.push_back({objectPath, recordSetIdentifier, bmcRecordHandle,
+                          entity, count, table.size(), records.size(),
+                          tableCrcState});
+    table.insert(table.end(), records.begin(), records.end());
+    numRecs += count;
+
+    tableCrcState = pldm::utils::crc32Update(tableCrcState, records.data(),
+                                             records.size());
+    updateChecksum();
+
+    if (isBuilt)
+    {
+        tableChangeCount++;
+    }
+}
+
+std::vector<uint8_t> FruImpl::encodeRecords(
+    const pldm::responder::dbus::InterfaceMap& interfaces,
+    const fru_parser::FruRecordInfos& recordInfos, const pldm_entity& entity,
+    uint16_t recordSetIdentifier, uint16_t& count)
+{
+    std::vector<uint8_t> records;
+    count = 0;
 
     for (const auto& [recType, encType, fieldInfos] : recordInfos)
     {
@@ -323,71 +886,43 @@ void FruImpl::populateRecords(
 
         if (tlvs.size())
         {
-            if (numRecs == numRecsCount)
-            {
-                recordSetIdentifier = nextRSI();
-                bmc_record_handle = nextRecordHandle();
-                int rc = pldm_pdr_add_fru_record_set_check(
-                    pdrRepo, TERMINUS_HANDLE, recordSetIdentifier,
-                    entity.entity_type, entity.entity_instance_num,
-                    entity.entity_container_id, &bmc_record_handle);
-                if (rc)
-                {
-                    // pldm_pdr_add_fru_record_set() assert()ed on failure
-                    throw std::runtime_error(
-                        "Failed to add PDR FRU record set");
-                }
-            }
-            auto curSize = table.size();
-            table.resize(curSize + recHeaderSize + tlvs.size());
-            encode_fru_record(table.data(), table.size(), &curSize,
+            auto curSize = records.size();
+            records.resize(curSize + recHeaderSize + tlvs.size());
+            encode_fru_record(records.data(), records.size(), &curSize,
                               recordSetIdentifier, recType, numFRUFields,
                               encType, tlvs.data(), tlvs.size());
-            numRecs++;
+            count++;
         }
     }
-}
-
-std::vector<uint8_t> FruImpl::tableResize()
-{
-    std::vector<uint8_t> tempTable;
 
-    if (table.size())
-    {
-        std::copy(table.begin(), table.end(), std::back_inserter(tempTable));
-        padBytes = pldm::utils::getNumPadBytes(table.size());
-        tempTable.resize(tempTable.size() + padBytes, 0);
-    }
-    return tempTable;
+    return records;
 }
 
-void FruImpl::getFRUTable(Response& response)
+std::shared_ptr<const std::vector<uint8_t>> FruImpl::tableSnapshot()
 {
-    auto hdrSize = response.size();
-    std::vector<uint8_t> tempTable;
-
-    if (table.size())
+    if (!tableImage)
     {
-        tempTable = tableResize();
-        checksum = crc32(tempTable.data(), tempTable.size());
+        auto image = std::make_shared<std::vector<uint8_t>>();
+        if (table.size())
+        {
+            image->reserve(table.size() + padBytes + sizeof(checksum));
+            image->assign(table.begin(), table.end());
+            image->resize(table.size() + padBytes, 0);
+        }
+        image->insert(image->end(),
+                      reinterpret_cast<const uint8_t*>(&checksum),
+                      reinterpret_cast<const uint8_t*>(&checksum) +
+                          sizeof(checksum));
+        tableImage = std::move(image);
     }
-    response.resize(hdrSize + tempTable.size() + sizeof(checksum), 0);
-    std::copy(tempTable.begin(), tempTable.end(), response.begin() + hdrSize);
-
-    // Copy the checksum to response data
-    auto iter = response.begin() + hdrSize + tempTable.size();
-    std::copy_n(reinterpret_cast<const uint8_t*>(&checksum), sizeof(checksum),
-                iter);
+    return tableImage;
 }
 
-void FruImpl::getFRURecordTableMetadata()
+void FruImpl::getFRUTable(Response& response)
 {
-    std::vector<uint8_t> tempTable;
-    if (table.size())
-    {
-        tempTable = tableResize();
-        checksum = crc32(tempTable.data(), tempTable.size());
-    }
+    // checksum is maintained incrementally as records change
+    auto snapshot = tableSnapshot();
+    response.insert(response.end(), snapshot->begin(), snapshot->end());
 }
 
 int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
@@ -405,11 +940,11 @@ int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
      * it must be less than the source table. So it's safe to use sizeof the
      * source table + 7 as the buffer length
      */
-    size_t recordTableSize = table.size() - padBytes + 7;
+    size_t recordTableSize = table.size() + 7;
     fruData.resize(recordTableSize, 0);
 
     int rc = get_fru_record_by_option_check(
-        table.data(), table.size() - padBytes, fruData.data(), &recordTableSize,
+        table.data(), table.size(), fruData.data(), &recordTableSize,
         recordSetIdentifer, recordType, fieldType);
 
     if (rc != PLDM_SUCCESS || recordTableSize == 0)
@@ -417,12 +952,16 @@ int FruImpl::getFRURecordByOption(std::vector<uint8_t>& fruData,
         return PLDM_FRU_DATA_STRUCTURE_TABLE_UNAVAILABLE;
     }
 
+    // The checksum covers the records selected by the options, not the
+    // whole FRU table
     auto pads = pldm::utils::getNumPadBytes(recordTableSize);
-    crc32(fruData.data(), recordTableSize + pads);
+    std::fill_n(fruData.begin() + recordTableSize, pads, 0);
+    sum recordsChecksum = pldm::utils::crc32Final(pldm::utils::crc32Update(
+        pldm::utils::crc32Init, fruData.data(), recordTableSize + pads));
 
     auto iter = fruData.begin() + recordTableSize + pads;
-    std::copy_n(reinterpret_cast<const uint8_t*>(&checksum), sizeof(checksum),
-                iter);
+    std::copy_n(reinterpret_cast<const uint8_t*>(&recordsChecksum),
+                sizeof(recordsChecksum), iter);
     fruData.resize(recordTableSize + pads + sizeof(sum));
 
     return PLDM_SUCCESS;
@@ -463,8 +1002,6 @@ Response Handler::getFRURecordTableMetadata(const pldm_msg* request,
                       0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
-    impl.getFRURecordTableMetadata();
-
     auto rc = encode_get_fru_record_table_metadata_resp(
         request->hdr.instance_id, PLDM_SUCCESS, major, minor, maxSize,
         impl.size(), impl.numRSI(), impl.numRecords(), impl.checkSum(),
@@ -477,7 +1014,7 @@ Response Handler::getFRURecordTableMetadata(const pldm_msg* request,
     return response;
 }
 
-Response Handler::getFRURecordTable(const pldm_msg* request,
+Response Handler::getFRURecordTable(pldm_tid_t tid, const pldm_msg* request,
                                     size_t payloadLength)
 {
     // FRU table is built lazily, build if not done.
@@ -488,19 +1025,82 @@ Response Handler::getFRURecordTable(const pldm_msg* request,
         return ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
     }
 
-    Response response(
-        sizeof(pldm_msg_hdr) + PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES, 0);
+    uint32_t dataTransferHandle = 0;
+    uint8_t transferOpFlag = 0;
+    auto rc = decode_get_fru_record_table_req(
+        request, payloadLength, &dataTransferHandle, &transferOpFlag);
+    if (rc != PLDM_SUCCESS)
+    {
+        return ccOnlyResponse(request, rc);
+    }
+
+    // Drop the snapshots of the termini that stopped requesting parts
+    auto now = std::chrono::steady_clock::now();
+    std::erase_if(tableTransfers, [this, now](const auto& transfer) {
+        return now - transfer.second.lastRequest >= tableTransferTimeout;
+    });
+
+    std::shared_ptr<const std::vector<uint8_t>> snapshot;
+    if (transferOpFlag == PLDM_GET_FIRSTPART)
+    {
+        if (dataTransferHandle != 0)
+        {
+            return ccOnlyResponse(request,
+                                  PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+        }
+        snapshot = impl.tableSnapshot();
+        tableTransfers[tid] = {snapshot, now};
+    }
+    else if (transferOpFlag == PLDM_GET_NEXTPART)
+    {
+        auto it = tableTransfers.find(tid);
+        if (it == tableTransfers.end() ||
+            dataTransferHandle >= it->second.snapshot->size())
+        {
+            return ccOnlyResponse(request,
+                                  PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+        }
+        snapshot = it->second.snapshot;
+        it->second.lastRequest = now;
+    }
+    else
+    {
+        return ccOnlyResponse(request, PLDM_FRU_INVALID_TRANSFER_FLAG);
+    }
+
+    size_t offset = dataTransferHandle;
+    size_t length = std::min<size_t>(FRU_TABLE_TRANSFER_SIZE,
+                                     snapshot->size() - offset);
+    bool isLast = offset + length == snapshot->size();
+
+    uint8_t transferFlag = PLDM_MIDDLE;
+    if (offset == 0)
+    {
+        transferFlag = isLast ? PLDM_START_AND_END : PLDM_START;
+    }
+    else if (isLast)
+    {
+        transferFlag = PLDM_END;
+    }
+    uint32_t nextDataTransferHandle = isLast ? 0 : offset + length;
+
+    Response response(sizeof(pldm_msg_hdr) +
+                          PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES + length,
+                      0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
-    auto rc = encode_get_fru_record_table_resp(request->hdr.instance_id,
-                                               PLDM_SUCCESS, 0,
-                                               PLDM_START_AND_END, responsePtr);
+    rc = encode_get_fru_record_table_resp(request->hdr.instance_id,
+                                          PLDM_SUCCESS, nextDataTransferHandle,
+                                          transferFlag, responsePtr);
     if (rc != PLDM_SUCCESS)
     {
         return ccOnlyResponse(request, rc);
     }
 
-    impl.getFRUTable(response);
+    // Serve the part straight out of the snapshot
+    std::copy_n(snapshot->begin() + offset, length,
+                response.begin() + sizeof(pldm_msg_hdr) +
+                    PLDM_GET_FRU_RECORD_TABLE_MIN_RESP_BYTES);
 
     return response;
 }
@@ -8,13 +8,19 @@
 #include <libpldm/fru.h>
 #include <libpldm/pdr.h>
 
+#include <sdbusplus/bus/match.hpp>
 #include <sdbusplus/message.hpp>
 
+#include <chrono>
 #include <map>
+#include <memory>
+#include <optional>
 #include <string>
 #include <variant>
 #include <vector>
 
+class TestFruImpl;
+
 namespace pldm
 {
 
@@ -42,6 +48,8 @@ using AssociatedEntityMap = std::map<ObjectPath, pldm_entity>;
 class FruImpl
 {
   public:
+    friend class ::TestFruImpl;
+
     /* @brief Header size for FRU record, it includes the FRU record set
      *        identifier, FRU record type, Number of FRU fields, Encoding type
      *        of FRU fields
@@ -98,7 +106,7 @@ class FruImpl
      */
     uint16_t numRSI() const
     {
-        return rsi;
+        return recordSets.size();
     }
 
     /** @brief The number of FRU records in the table
@@ -110,16 +118,33 @@ class FruImpl
         return numRecs;
     }
 
+    /** @brief Number of times the FRU table changed after it was built, by
+     *         inventory items being added, updated or removed
+     *
+     *  @return FRU table change count
+     */
+    uint32_t changeCount() const
+    {
+        return tableChangeCount;
+    }
+
     /** @brief Get the FRU table
      *
      *  @param[out] - Populate response with the FRU table
      */
     void getFRUTable(Response& response);
 
-    /** @brief Get the Fru Table MetaData
+    /** @brief Get the FRU table as transferred by GetFRURecordTable, the
+     *         padded table followed by its checksum
      *
+     *  The returned buffer is immutable and shared, it stays valid and
+     *  unchanged for as long as the caller holds it even if the FRU records
+     *  change meanwhile, which makes it a consistent snapshot for multipart
+     *  transfers.
+     *
+     *  @return the FRU table snapshot
      */
-    void getFRURecordTableMetadata();
+    std::shared_ptr<const std::vector<uint8_t>> tableSnapshot();
 
     /** @brief Get FRU Record Table By Option
      *  @param[out] response - Populate response with the FRU table got by
@@ -135,7 +160,9 @@ class FruImpl
 
     /** @brief FRU table is built by processing the D-Bus inventory namespace
      *         based on the config files for FRU. The table is populated based
-     *         on the isBuilt flag.
+     *         on the isBuilt flag. Once built, the table is kept up to date
+     *         incrementally from the inventory InterfacesAdded,
+     *         InterfacesRemoved and PropertiesChanged signals.
      */
     void buildFRUTable();
 
@@ -187,12 +214,6 @@ class FruImpl
      */
     std::string populatefwVersion();
 
-    /* @brief Method to resize the table
-     *
-     * @return resized table
-     */
-    std::vector<uint8_t> tableResize();
-
     /* @brief set FRU Record Table
      *
      * @param[in] fruData - the data of the fru
@@ -202,6 +223,21 @@ class FruImpl
     int setFRUTable(const std::vector<uint8_t>& fruData);
 
   private:
+    /** @brief The FRU records of one inventory object, they share one record
+     *         set identifier and are stored contiguously in the FRU table
+     */
+    struct FruRecordSet
+    {
+        dbus::ObjectPath objectPath;
+        uint16_t rsi;
+        uint32_t pdrRecordHandle;
+        pldm_entity entity;
+        uint16_t numRecords;
+        size_t offset;        //!< offset of the records in table
+        size_t length;        //!< length of the records in table
+        uint32_t crcAtOffset; //!< CRC32 state over table[0, offset)
+    };
+
     uint16_t nextRSI()
     {
         return ++rsi;
@@ -218,8 +254,26 @@ class FruImpl
     uint8_t padBytes = 0;
     std::vector<uint8_t> table;
     uint32_t checksum = 0;
+
+    /** @brief table padded to a multiple of 4 bytes followed by checksum,
+     *         rebuilt on demand after the records change
+     */
+    std::shared_ptr<const std::vector<uint8_t>> tableImage;
     bool isBuilt = false;
 
+    /** @brief CRC32 state over the unpadded table */
+    uint32_t tableCrcState = pldm::utils::crc32Init;
+    uint32_t tableChangeCount = 0;
+
+    /** @brief Record sets in the order they are laid out in table */
+    std::vector<FruRecordSet> recordSets;
+
+    /** @brief Inventory objects as last seen on D-Bus */
+    dbus::ObjectValueTree inventoryObjects;
+
+    /** @brief Matches on the inventory signals for incremental updates */
+    std::vector<std::unique_ptr<sdbusplus::bus::match_t>> inventoryMatches;
+
     fru_parser::FruParser parser;
     pldm_pdr* pdrRepo;
     pldm_entity_association_tree* entityTree;
@@ -231,15 +285,117 @@ class FruImpl
     /** @brief populateRecord builds the FRU records for an instance of FRU and
      *         updates the FRU table with the FRU records.
      *
+     *  @param[in] objectPath - inventory object path of the FRU
      *  @param[in] interfaces - D-Bus interfaces and the associated property
      *                          values for the FRU
      *  @param[in] recordInfos - FRU record info to build the FRU records
      *  @param[in/out] entity - PLDM entity corresponding to FRU instance
      */
-    void populateRecords(const dbus::InterfaceMap& interfaces,
+    void populateRecords(const dbus::ObjectPath& objectPath,
+                         const dbus::InterfaceMap& interfaces,
                          const fru_parser::FruRecordInfos& recordInfos,
                          const pldm_entity& entity);
 
+    /** @brief Encode the FRU records for an instance of FRU
+     *
+     *  @param[in] interfaces - D-Bus interfaces and the associated property
+     *                          values for the FRU
+     *  @param[in] recordInfos - FRU record info to build the FRU records
+     *  @param[in] entity - PLDM entity corresponding to FRU instance
+     *  @param[in] recordSetIdentifier - RSI to encode the records with
+     *  @param[out] count - number of records encoded
+     *
+     *  @return the encoded FRU records, empty if the FRU has no data
+     */
+    std::vector<uint8_t>
+        encodeRecords(const dbus::InterfaceMap& interfaces,
+                      const fru_parser::FruRecordInfos& recordInfos,
+                      const pldm_entity& entity, uint16_t recordSetIdentifier,
+                      uint16_t& count);
+
+    /** @brief Add the FRU records and the entity for an inventory object,
+     *         if it implements a FRU item interface and is present
+     *
+     *  @param[in] objectPath - inventory object path
+     *
+     *  @return true if the object is now part of the FRU table
+     */
+    bool addFRU(const dbus::ObjectPath& objectPath);
+
+    /** @brief Re-encode the FRU records of an inventory object in place
+     *
+     *  @param[in] objectPath - inventory object path
+     */
+    void updateFRU(const dbus::ObjectPath& objectPath);
+
+    /** @brief Remove the FRU records, FRU record set PDR and entity of an
+     *         inventory object and of the FRUs contained in it
+     *
+     *  Entity instance numbers are assigned by libpldm as the last sibling of
+     *  the same type plus one, so removing the last instance of a type makes
+     *  its number available to the next FRU of that type added under the
+     *  same parent. An entity therefore only identifies the same FRU for as
+     *  long as the FRU table change count doesn't change.
+     *
+     *  @param[in] objectPath - inventory object path
+     */
+    void removeFRU(const dbus::ObjectPath& objectPath);
+
+    /** @brief Read the Present property of a FRU from its cached interfaces
+     *
+     *  @param[in] interfaces - D-Bus interfaces and the associated property
+     *                          values for the FRU
+     *
+     *  @return the presence, std::nullopt if it is not in the cache
+     */
+    static std::optional<bool>
+        getPresence(const dbus::InterfaceMap& interfaces);
+
+    /** @brief Fetch the Present property of FRUs whose presence wasn't
+     *         part of the inventory snapshot and add it to the snapshot
+     *
+     *  The properties are read with one GetManagedObjects per owning
+     *  service, or a GetAll for a service owning a single one of the FRUs.
+     *  Only the presence actually read is added to the snapshot.
+     *
+     *  @param[in] paths - inventory object paths of the FRUs
+     */
+    void fetchPresence(const std::vector<dbus::ObjectPath>& paths);
+
+    /** @brief Find the record set of an inventory object
+     *
+     *  @param[in] objectPath - inventory object path
+     *
+     *  @return iterator into recordSets, end() if not found
+     */
+    std::vector<FruRecordSet>::iterator
+        findRecordSet(const dbus::ObjectPath& objectPath);
+
+    /** @brief Recompute the CRC32 state of table from a record set onwards
+     *         and refresh the table checksum
+     *
+     *  @param[in] index - index of the first record set that changed
+     */
+    void rechainChecksum(size_t index);
+
+    /** @brief Refresh the padded table checksum from tableCrcState */
+    void updateChecksum();
+
+    /** @brief Subscribe to inventory signals to maintain the FRU table
+     *
+     *  @param[in] inventoryPath - root of the inventory namespace
+     */
+    void subscribeInventorySignals(const std::string& inventoryPath);
+
+    /** @brief Process InterfacesAdded on the inventory */
+    void processInterfacesAdded(sdbusplus::message_t& msg);
+
+    /** @brief Process InterfacesRemoved on the inventory */
+    void processInterfacesRemoved(sdbusplus::message_t& msg);
+
+    /** @brief Process PropertiesChanged on an inventory object */
+    void processPropertiesChanged(sdbusplus::message_t& msg);
+
     /** @brief Associate sensor/effecter to FRU entity
      */
     dbus::AssociatedEntityMap associatedEntityMap;
@@ -251,6 +407,8 @@ namespace fru
 class Handler : public CmdHandler
 {
   public:
+    friend class ::TestFruImpl;
+
     Handler(const std::string& configPath,
             const std::filesystem::path& fruMasterJsonPath, pldm_pdr* pdrRepo,
             pldm_entity_association_tree* entityTree,
@@ -266,8 +424,9 @@ class Handler : public CmdHandler
         });
         handlers.emplace(
             PLDM_GET_FRU_RECORD_TABLE,
-            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
-            return this->getFRURecordTable(request, payloadLength);
+            [this](pldm_tid_t tid, const pldm_msg* request,
+                   size_t payloadLength) {
+            return this->getFRURecordTable(tid, request, payloadLength);
         });
         handlers.emplace(
             PLDM_GET_FRU_RECORD_BY_OPTION,
@@ -293,12 +452,23 @@ class Handler : public CmdHandler
 
     /** @brief Handler for GetFRURecordTable
      *
+     *  The table is transferred in parts of at most FRU_TABLE_TRANSFER_SIZE
+     *  bytes. The data transfer handle is the offset of the part in the
+     *  table, so an interrupted transfer can be resumed by requesting the
+     *  same handle again. GetFirstPart takes a snapshot of the table that
+     *  the following parts requested by the same terminus are served from.
+     *  The snapshot is kept after the last part, so a lost final response
+     *  can be requested again, until the next GetFirstPart of the terminus
+     *  or until the terminus requests no part for tableTransferTimeout.
+     *
+     *  @param[in] tid - PLDM request TID
      *  @param[in] request - Request message payload
      *  @param[in] payloadLength - Request payload length
      *
      *  @return PLDM response message
      */
-    Response getFRURecordTable(const pldm_msg* request, size_t payloadLength);
+    Response getFRURecordTable(pldm_tid_t tid, const pldm_msg* request,
+                               size_t payloadLength);
 
     /** @brief Build FRU table is bnot already built
      *
@@ -343,6 +513,21 @@ class Handler : public CmdHandler
 
   private:
     FruImpl impl;
+
+    /** @brief A GetFRURecordTable transfer to a terminus */
+    struct TableTransfer
+    {
+        /** @brief The table as it was at GetFirstPart */
+        std::shared_ptr<const std::vector<uint8_t>> snapshot;
+        /** @brief Time the terminus last requested a part */
+        std::chrono::steady_clock::time_point lastRequest;
+    };
+
+    /** @brief GetFRURecordTable transfers, keyed by requester TID */
+    std::map<pldm_tid_t, TableTransfer> tableTransfers;
+
+    /** @brief Time without a request after which a transfer is dropped */
+    std::chrono::seconds tableTransferTimeout{FRU_TABLE_TRANSFER_TIMEOUT};
 };
 
 } // namespace fru
@@ -212,8 +212,6 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
         }
     }
 
-    Response response(sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES, 0);
-
     if (payloadLength != PLDM_GET_PDR_REQ_BYTES)
     {
         return CmdHandler::ccOnlyResponse(request, PLDM_ERROR_INVALID_LENGTH);
@@ -254,9 +252,9 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
             }
             recordData = e.data;
         }
-        response.resize(sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES +
-                            respSizeBytes,
-                        0);
+        Response response(sizeof(pldm_msg_hdr) + PLDM_GET_PDR_MIN_RESP_BYTES +
+                              respSizeBytes,
+                          0);
         auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
         rc = encode_get_pdr_resp(
             request->hdr.instance_id, PLDM_SUCCESS, e.handle.nextRecordHandle,
@@ -265,6 +263,7 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
         {
             return ccOnlyResponse(request, rc);
         }
+        return response;
     }
     catch (const std::exception& e)
     {
@@ -272,7 +271,6 @@ Response Handler::getPDR(const pldm_msg* request, size_t payloadLength)
               "REC_HANDLE", recordHandle, "ERR_EXCEP", e.what());
         return CmdHandler::ccOnlyResponse(request, PLDM_ERROR);
     }
-    return response;
 }
 
 Response Handler::setStateEffecterStates(const pldm_msg* request,
@@ -356,7 +354,6 @@ Response Handler::platformEventMessage(const pldm_msg* request,
 
     if (eventClass == PLDM_HEARTBEAT_TIMER_ELAPSED_EVENT)
     {
-        rc = PLDM_SUCCESS;
         if (oemPlatformHandler)
         {
             oemPlatformHandler->resetWatchDogTimer();
@@ -364,31 +361,44 @@ Response Handler::platformEventMessage(const pldm_msg* request,
     }
     else
     {
-        try
+        if (!eventHandlers.contains(eventClass))
         {
-            const auto& handlers = eventHandlers.at(eventClass);
-            for (const auto& handler : handlers)
-            {
-                auto rc = handler(request, payloadLength, formatVersion, tid,
-                                  offset);
-                if (rc != PLDM_SUCCESS)
-                {
-                    return CmdHandler::ccOnlyResponse(request, rc);
-                }
-            }
+            error("Unsupported platform event class {CLASS}", "CLASS",
+                  static_cast<unsigned>(eventClass));
+            return CmdHandler::ccOnlyResponse(request, PLDM_ERROR_INVALID_DATA);
         }
-        catch (const std::out_of_range& e)
+        // Only the D-Bus and PDR updates are deferred, a malformed event is
+        // rejected with its completion code
+        rc = checkEvent(request, payloadLength, tid, eventClass, offset);
+        if (rc != PLDM_SUCCESS)
         {
-            error("Error in handling platform event msg: {ERROR}", "ERROR", e);
-            return CmdHandler::ccOnlyResponse(request, PLDM_ERROR_INVALID_DATA);
+            return CmdHandler::ccOnlyResponse(request, rc);
+        }
+        if (eventQueue.size() >= EVENT_QUEUE_DEPTH)
+        {
+            return CmdHandler::ccOnlyResponse(request, PLDM_ERROR_NOT_READY);
+        }
+
+        auto message = reinterpret_cast<const uint8_t*>(request);
+        eventQueue.emplace_back(
+            std::vector<uint8_t>(message,
+                                 message + sizeof(pldm_msg_hdr) +
+                                     payloadLength),
+            formatVersion, tid, eventClass, offset);
+        if (!deferredEventQueue)
+        {
+            deferredEventQueue = std::make_unique<sdeventplus::source::Defer>(
+                event, std::bind_front(&Handler::processEventQueue, this));
         }
     }
+
     Response response(
         sizeof(pldm_msg_hdr) + PLDM_PLATFORM_EVENT_MESSAGE_RESP_BYTES, 0);
     auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
 
-    rc = encode_platform_event_message_resp(request->hdr.instance_id, rc,
-                                            PLDM_EVENT_NO_LOGGING, responsePtr);
+    rc = encode_platform_event_message_resp(request->hdr.instance_id,
+                                            PLDM_SUCCESS, PLDM_EVENT_NO_LOGGING,
+                                            responsePtr);
     if (rc != PLDM_SUCCESS)
     {
         return ccOnlyResponse(request, rc);
@@ -397,115 +407,271 @@ Response Handler::platformEventMessage(const pldm_msg* request,
     return response;
 }
 
-int Handler::sensorEvent(const pldm_msg* request, size_t payloadLength,
-                         uint8_t /*formatVersion*/, uint8_t tid,
-                         size_t eventDataOffset)
+void Handler::processEventQueue(sdeventplus::source::EventBase& /*source*/)
+{
+    auto queued = std::move(eventQueue.front());
+    eventQueue.pop_front();
+    if (eventQueue.empty())
+    {
+        deferredEventQueue.reset();
+    }
+
+    auto request = reinterpret_cast<const pldm_msg*>(queued.message.data());
+    auto payloadLength = queued.message.size() - sizeof(pldm_msg_hdr);
+    for (const auto& handler : eventHandlers.at(queued.eventClass))
+    {
+        auto rc = handler(request, payloadLength, queued.formatVersion,
+                          queued.tid, queued.eventDataOffset);
+        if (rc != PLDM_SUCCESS)
+        {
+            error(
+                "Failed to handle platform event class {CLASS} from TID {TID}, rc = {RC}",
+                "CLASS", static_cast<unsigned>(queued.eventClass), "TID",
+                static_cast<unsigned>(queued.tid), "RC", rc);
+            break;
+        }
+    }
+}
+
+Response Handler::pollForPlatformEventMessage(const pldm_msg* request,
+                                              size_t payloadLength)
+{
+    uint8_t formatVersion{};
+    uint8_t transferOperationFlag{};
+    uint32_t dataTransferHandle{};
+    uint16_t eventIdToAcknowledge{};
+
+    auto rc = decode_poll_for_platform_event_message_req(
+        request, payloadLength, &formatVersion, &transferOperationFlag,
+        &dataTransferHandle, &eventIdToAcknowledge);
+    if (rc != PLDM_SUCCESS)
+    {
+        return CmdHandler::ccOnlyResponse(request, rc);
+    }
+    // The events are sent to the host unless it polls for them
+    if (!dbusToPLDMEventHandler || !dbusToPLDMEventHandler->pollingEnabled())
+    {
+        return CmdHandler::ccOnlyResponse(request,
+                                          PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+    }
+    // Queued events always fit in a single part
+    if (transferOperationFlag == PLDM_GET_NEXTPART)
+    {
+        return CmdHandler::ccOnlyResponse(request, PLDM_ERROR_INVALID_DATA);
+    }
+
+    if (eventIdToAcknowledge != PLDM_PLATFORM_EVENT_ID_NULL &&
+        eventIdToAcknowledge != PLDM_PLATFORM_EVENT_ID_FRAGMENT &&
+        !dbusToPLDMEventHandler->acknowledgePolledEvent(eventIdToAcknowledge))
+    {
+        error("Host acknowledged unknown platform event ID {EVENT_ID}",
+              "EVENT_ID", eventIdToAcknowledge);
+    }
+
+    const pldm::state_sensor::DbusToPLDMEvent::PolledEvent* polled = nullptr;
+    if (transferOperationFlag == PLDM_ACKNOWLEDGEMENT_ONLY)
+    {
+        // The host doesn't poll again after an acknowledgement alone, tell
+        // it about the events left in the queue
+        dbusToPLDMEventHandler->notifyPendingEvents();
+    }
+    else
+    {
+        polled = dbusToPLDMEventHandler->getPolledEvent();
+    }
+
+    if (!polled)
+    {
+        Response response(
+            sizeof(pldm_msg_hdr) +
+                PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_MIN_RESP_BYTES,
+            0);
+        auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+        rc = encode_poll_for_platform_event_message_resp(
+            request->hdr.instance_id, PLDM_SUCCESS, TERMINUS_ID,
+            PLDM_PLATFORM_EVENT_ID_NULL, 0, 0, 0, 0, nullptr, 0, responsePtr,
+            PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_MIN_RESP_BYTES);
+        if (rc != PLDM_SUCCESS)
+        {
+            return ccOnlyResponse(request, rc);
+        }
+        return response;
+    }
+
+    // completionCode, TID, eventID, nextDataTransferHandle, transferFlag,
+    // eventClass, eventDataSize and eventData. libpldm only encodes the
+    // eventDataIntegrityChecksum with the last part of the event data.
+    constexpr uint8_t transferFlag = PLDM_START_AND_END;
+    auto eventData = polled->eventData;
+    size_t responseLength =
+        PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_MIN_RESP_BYTES + sizeof(uint32_t) +
+        2 * sizeof(uint8_t) + sizeof(uint32_t) + eventData.size();
+    if (transferFlag == PLDM_END || transferFlag == PLDM_START_AND_END)
+    {
+        responseLength += sizeof(uint32_t);
+    }
+    Response response(sizeof(pldm_msg_hdr) + responseLength, 0);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    auto checksum = crc32Final(
+        crc32Update(crc32Init, eventData.data(), eventData.size()));
+    rc = encode_poll_for_platform_event_message_resp(
+        request->hdr.instance_id, PLDM_SUCCESS, TERMINUS_ID, polled->eventId,
+        0, transferFlag, polled->eventClass, eventData.size(),
+        eventData.data(), checksum, responsePtr, responseLength);
+    if (rc != PLDM_SUCCESS)
+    {
+        return ccOnlyResponse(request, rc);
+    }
+    return response;
+}
+
+Response Handler::eventMessageBufferSize(const pldm_msg* request,
+                                         size_t payloadLength)
+{
+    uint16_t receiverMaxBufferSize{};
+    auto rc = decode_event_message_buffer_size_req(request, payloadLength,
+                                                   &receiverMaxBufferSize);
+    if (rc != PLDM_SUCCESS)
+    {
+        return CmdHandler::ccOnlyResponse(request, rc);
+    }
+
+    Response response(
+        sizeof(pldm_msg_hdr) + PLDM_EVENT_MESSAGE_BUFFER_SIZE_RESP_BYTES, 0);
+    auto responsePtr = reinterpret_cast<pldm_msg*>(response.data());
+    rc = encode_event_message_buffer_size_resp(
+        request->hdr.instance_id, PLDM_SUCCESS,
+        pldm::state_sensor::DbusToPLDMEvent::maxEventDataSize, responsePtr);
+    if (rc != PLDM_SUCCESS)
+    {
+        return ccOnlyResponse(request, rc);
+    }
+    return response;
+}
+
+int Handler::decodeSensorEvent(const pldm_msg* request, size_t payloadLength,
+                               uint8_t tid, size_t eventDataOffset,
+                               StateSensorEvent& sensorEvent)
 {
-    uint16_t sensorId{};
     uint8_t eventClass{};
     size_t eventClassDataOffset{};
     auto eventData = reinterpret_cast<const uint8_t*>(request->payload) +
                      eventDataOffset;
     auto eventDataSize = payloadLength - eventDataOffset;
 
-    auto rc = decode_sensor_event_data(eventData, eventDataSize, &sensorId,
-                                       &eventClass, &eventClassDataOffset);
+    auto rc = decode_sensor_event_data(eventData, eventDataSize,
+                                       &sensorEvent.sensorId, &eventClass,
+                                       &eventClassDataOffset);
     if (rc != PLDM_SUCCESS)
     {
         return rc;
     }
 
+    if (eventClass != PLDM_STATE_SENSOR_STATE)
+    {
+        return PLDM_ERROR_INVALID_DATA;
+    }
+
     auto eventClassData = reinterpret_cast<const uint8_t*>(request->payload) +
                           eventDataOffset + eventClassDataOffset;
     auto eventClassDataSize = payloadLength - eventDataOffset -
                               eventClassDataOffset;
 
-    if (eventClass == PLDM_STATE_SENSOR_STATE)
+    rc = decode_state_sensor_data(eventClassData, eventClassDataSize,
+                                  &sensorEvent.sensorOffset,
+                                  &sensorEvent.eventState,
+                                  &sensorEvent.previousEventState);
+    if (rc != PLDM_SUCCESS)
     {
-        uint8_t sensorOffset{};
-        uint8_t eventState{};
-        uint8_t previousEventState{};
-
-        rc = decode_state_sensor_data(eventClassData, eventClassDataSize,
-                                      &sensorOffset, &eventState,
-                                      &previousEventState);
-        if (rc != PLDM_SUCCESS)
-        {
-            return PLDM_ERROR;
-        }
-
-        // Emitting state sensor event signal
-        emitStateSensorEventSignal(tid, sensorId, sensorOffset, eventState,
-                                   previousEventState);
+        return PLDM_ERROR;
+    }
 
-        // If there are no HOST PDR's, there is no further action
-        if (hostPDRHandler == NULL)
-        {
-            return PLDM_SUCCESS;
-        }
+    // If there are no HOST PDR's, there is no further action
+    sensorEvent.entry.reset();
+    if (hostPDRHandler == NULL)
+    {
+        return PLDM_SUCCESS;
+    }
 
-        // Handle PLDM events for which PDR is available
-        SensorEntry sensorEntry{tid, sensorId};
+    // Handle PLDM events for which PDR is available
+    SensorEntry sensorEntry{tid, sensorEvent.sensorId};
 
-        pldm::pdr::EntityInfo entityInfo{};
-        pldm::pdr::CompositeSensorStates compositeSensorStates{};
-        std::vector<pldm::pdr::StateSetId> stateSetIds{};
+    pldm::pdr::EntityInfo entityInfo{};
+    pldm::pdr::CompositeSensorStates compositeSensorStates{};
+    std::vector<pldm::pdr::StateSetId> stateSetIds{};
 
+    try
+    {
+        std::tie(entityInfo, compositeSensorStates, stateSetIds) =
+            hostPDRHandler->lookupSensorInfo(sensorEntry);
+    }
+    catch (const std::out_of_range&)
+    {
+        // If there is no mapping for tid, sensorId combination, try
+        // PLDM_TID_RESERVED, sensorId for terminus that is yet to
+        // implement TL PDR.
         try
         {
+            sensorEntry.terminusID = PLDM_TID_RESERVED;
             std::tie(entityInfo, compositeSensorStates, stateSetIds) =
                 hostPDRHandler->lookupSensorInfo(sensorEntry);
         }
+        // If there is no mapping for events return PLDM_SUCCESS
         catch (const std::out_of_range&)
         {
-            // If there is no mapping for tid, sensorId combination, try
-            // PLDM_TID_RESERVED, sensorId for terminus that is yet to
-            // implement TL PDR.
-            try
-            {
-                sensorEntry.terminusID = PLDM_TID_RESERVED;
-                std::tie(entityInfo, compositeSensorStates, stateSetIds) =
-                    hostPDRHandler->lookupSensorInfo(sensorEntry);
-            }
-            // If there is no mapping for events return PLDM_SUCCESS
-            catch (const std::out_of_range&)
-            {
-                return PLDM_SUCCESS;
-            }
-        }
-
-        if (sensorOffset >= compositeSensorStates.size())
-        {
-            return PLDM_ERROR_INVALID_DATA;
-        }
-
-        const auto& possibleStates = compositeSensorStates[sensorOffset];
-        if (!possibleStates.contains(eventState))
-        {
-            return PLDM_ERROR_INVALID_DATA;
+            return PLDM_SUCCESS;
         }
+    }
 
-        const auto& [containerId, entityType, entityInstance] = entityInfo;
-        events::StateSensorEntry stateSensorEntry{containerId, entityType,
-                                                  entityInstance, sensorOffset,
-                                                  stateSetIds[sensorOffset]};
-        return hostPDRHandler->handleStateSensorEvent(stateSensorEntry,
-                                                      eventState);
+    auto sensorOffset = sensorEvent.sensorOffset;
+    if (sensorOffset >= compositeSensorStates.size())
+    {
+        return PLDM_ERROR_INVALID_DATA;
     }
-    else
+
+    const auto& possibleStates = compositeSensorStates[sensorOffset];
+    if (!possibleStates.contains(sensorEvent.eventState))
     {
         return PLDM_ERROR_INVALID_DATA;
     }
 
+    const auto& [containerId, entityType, entityInstance] = entityInfo;
+    sensorEvent.entry = events::StateSensorEntry{containerId, entityType,
+                                                 entityInstance, sensorOffset,
+                                                 stateSetIds[sensorOffset]};
     return PLDM_SUCCESS;
 }
 
-int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
-                                       size_t payloadLength,
-                                       uint8_t /*formatVersion*/, uint8_t tid,
-                                       size_t eventDataOffset)
+int Handler::sensorEvent(const pldm_msg* request, size_t payloadLength,
+                         uint8_t /*formatVersion*/, uint8_t tid,
+                         size_t eventDataOffset)
+{
+    StateSensorEvent sensorEvent{};
+    auto rc = decodeSensorEvent(request, payloadLength, tid, eventDataOffset,
+                                sensorEvent);
+    if (rc != PLDM_SUCCESS)
+    {
+        return rc;
+    }
+
+    // Emitting state sensor event signal
+    emitStateSensorEventSignal(tid, sensorEvent.sensorId,
+                               sensorEvent.sensorOffset, sensorEvent.eventState,
+                               sensorEvent.previousEventState);
+
+    if (!sensorEvent.entry)
+    {
+        return PLDM_SUCCESS;
+    }
+    return hostPDRHandler->handleStateSensorEvent(*sensorEvent.entry,
+                                                  sensorEvent.eventState);
+}
+
+int Handler::decodePDRRepositoryChgEvent(const pldm_msg* request,
+                                         size_t payloadLength,
+                                         size_t eventDataOffset,
+                                         PDRRepositoryChange& change)
 {
-    uint8_t eventDataFormat{};
     uint8_t numberOfChangeRecords{};
     size_t dataOffset{};
 
@@ -514,21 +680,19 @@ int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
     auto eventDataSize = payloadLength - eventDataOffset;
 
     auto rc = decode_pldm_pdr_repository_chg_event_data(
-        eventData, eventDataSize, &eventDataFormat, &numberOfChangeRecords,
-        &dataOffset);
+        eventData, eventDataSize, &change.eventDataFormat,
+        &numberOfChangeRecords, &dataOffset);
     if (rc != PLDM_SUCCESS)
     {
         return rc;
     }
 
-    PDRRecordHandles pdrRecordHandles;
-
-    if (eventDataFormat == FORMAT_IS_PDR_TYPES)
+    if (change.eventDataFormat == FORMAT_IS_PDR_TYPES)
     {
         return PLDM_ERROR_INVALID_DATA;
     }
 
-    if (eventDataFormat == FORMAT_IS_PDR_HANDLES)
+    if (change.eventDataFormat == FORMAT_IS_PDR_HANDLES)
     {
         uint8_t eventDataOperation{};
         uint8_t numberOfChangeEntries{};
@@ -547,12 +711,19 @@ int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
                 return rc;
             }
 
+            // The change entries must fit in the change record data
+            if (numberOfChangeEntries >
+                (changeRecordDataSize - dataOffset) / sizeof(ChangeEntry))
+            {
+                return PLDM_ERROR_INVALID_DATA;
+            }
+
             if (eventDataOperation == PLDM_RECORDS_ADDED ||
                 eventDataOperation == PLDM_RECORDS_MODIFIED)
             {
                 if (eventDataOperation == PLDM_RECORDS_MODIFIED)
                 {
-                    hostPDRHandler->isHostPdrModified = true;
+                    change.modified = true;
                 }
 
                 rc = getPDRRecordHandles(
@@ -560,7 +731,7 @@ int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
                                                          dataOffset),
                     changeRecordDataSize - dataOffset,
                     static_cast<size_t>(numberOfChangeEntries),
-                    pdrRecordHandles);
+                    change.pdrRecordHandles);
 
                 if (rc != PLDM_SUCCESS)
                 {
@@ -574,12 +745,34 @@ int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
                 dataOffset + (numberOfChangeEntries * sizeof(ChangeEntry));
         }
     }
+
+    return PLDM_SUCCESS;
+}
+
+int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
+                                       size_t payloadLength,
+                                       uint8_t /*formatVersion*/, uint8_t tid,
+                                       size_t eventDataOffset)
+{
+    PDRRepositoryChange change{};
+    auto rc = decodePDRRepositoryChgEvent(request, payloadLength,
+                                          eventDataOffset, change);
+    if (rc != PLDM_SUCCESS)
+    {
+        return rc;
+    }
+
     if (hostPDRHandler)
     {
+        if (change.modified)
+        {
+            hostPDRHandler->isHostPdrModified = true;
+        }
+
         // if we get a Repository change event with the eventDataFormat
         // as REFRESH_ENTIRE_REPOSITORY, then delete all the PDR's that
         // have the matched Terminus handle
-        if (eventDataFormat == REFRESH_ENTIRE_REPOSITORY)
+        if (change.eventDataFormat == REFRESH_ENTIRE_REPOSITORY)
         {
             // We cannot get the Repo change event from the Terminus
             // that is not already added to the BMC repository
@@ -599,12 +792,36 @@ int Handler::pldmPDRRepositoryChgEvent(const pldm_msg* request,
                 }
             }
         }
-        hostPDRHandler->fetchPDR(std::move(pdrRecordHandles));
+        hostPDRHandler->fetchPDR(std::move(change.pdrRecordHandles));
     }
 
     return PLDM_SUCCESS;
 }
 
+int Handler::checkEvent(const pldm_msg* request, size_t payloadLength,
+                        uint8_t tid, uint8_t eventClass,
+                        size_t eventDataOffset)
+{
+    switch (eventClass)
+    {
+        case PLDM_SENSOR_EVENT:
+        {
+            StateSensorEvent sensorEvent{};
+            return decodeSensorEvent(request, payloadLength, tid,
+                                     eventDataOffset, sensorEvent);
+        }
+        case PLDM_PDR_REPOSITORY_CHG_EVENT:
+        {
+            PDRRepositoryChange change{};
+            return decodePDRRepositoryChgEvent(request, payloadLength,
+                                               eventDataOffset, change);
+        }
+        default:
+            // The OEM event classes are only decoded by their handlers
+            return PLDM_SUCCESS;
+    }
+}
+
 int Handler::getPDRRecordHandles(const ChangeEntry* changeEntryData,
                                  size_t changeEntryDataSize,
                                  size_t numberOfChangeEntries,
@@ -786,10 +1003,13 @@ Response Handler::getStateSensorReadings(const pldm_msg* request,
     }
     else
     {
+        static const pldm::stateSensorCacheMaps noSensorCache{};
         rc = platform_state_sensor::getStateSensorReadingsHandler<
             pldm::utils::DBusHandler, Handler>(
             dBusIntf, *this, sensorId, sensorRearmCount, comSensorCnt,
-            stateField, dbusToPLDMEventHandler->getSensorCache());
+            stateField,
+            dbusToPLDMEventHandler ? dbusToPLDMEventHandler->getSensorCache()
+                                   : noSensorCache);
     }
 
     if (rc != PLDM_SUCCESS)
@@ -18,7 +18,9 @@
 
 #include <phosphor-logging/lg2.hpp>
 
+#include <deque>
 #include <map>
+#include <optional>
 
 PHOSPHOR_LOG2_USING;
 
@@ -100,6 +102,16 @@ class Handler : public CmdHandler
             [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
             return this->platformEventMessage(request, payloadLength);
         });
+        handlers.emplace(
+            PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE,
+            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
+            return this->pollForPlatformEventMessage(request, payloadLength);
+        });
+        handlers.emplace(
+            PLDM_EVENT_MESSAGE_BUFFER_SIZE,
+            [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
+            return this->eventMessageBufferSize(request, payloadLength);
+        });
         handlers.emplace(
             PLDM_GET_STATE_SENSOR_READINGS,
             [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
@@ -256,6 +268,13 @@ class Handler : public CmdHandler
                                     size_t payloadLength);
 
     /** @brief Handler for PlatformEventMessage
+     *
+     *  The event data is decoded and checked before the event is
+     *  acknowledged, a malformed event is answered with the completion code
+     *  of the check. The event is then handed to the event handlers from a
+     *  deferred event source, so the sender does not wait for the D-Bus and
+     *  PDR updates. PLDM_ERROR_NOT_READY is returned while EVENT_QUEUE_DEPTH
+     *  events are waiting to be handled.
      *
      *  @param[in] request - Request message
      *  @param[in] payloadLength - Request payload length
@@ -264,6 +283,28 @@ class Handler : public CmdHandler
     Response platformEventMessage(const pldm_msg* request,
                                   size_t payloadLength);
 
+    /** @brief Handler for PollForPlatformEventMessage, hands out the state
+     *         sensor events queued for the host one at a time
+     *
+     *  PLDM_ERROR_UNSUPPORTED_PLDM_CMD is returned unless the host polls for
+     *  the events, see SENSOR_EVENT_POLLING.
+     *
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @return Response - PLDM Response message
+     */
+    Response pollForPlatformEventMessage(const pldm_msg* request,
+                                         size_t payloadLength);
+
+    /** @brief Handler for EventMessageBufferSize
+     *
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @return Response - PLDM Response message
+     */
+    Response eventMessageBufferSize(const pldm_msg* request,
+                                    size_t payloadLength);
+
     /** @brief Handler for event class Sensor event
      *
      *  @param[in] request - Request message
@@ -291,6 +332,72 @@ class Handler : public CmdHandler
                                   uint8_t formatVersion, uint8_t tid,
                                   size_t eventDataOffset);
 
+    /** @brief A state sensor event, decoded and checked against the PDRs
+     *         of its terminus
+     */
+    struct StateSensorEvent
+    {
+        uint16_t sensorId;
+        uint8_t sensorOffset;
+        uint8_t eventState;
+        uint8_t previousEventState;
+        /** @brief Sensor described by the host PDRs, unset if none does */
+        std::optional<events::StateSensorEntry> entry;
+    };
+
+    /** @brief Decode the data of a sensor event
+     *
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @param[in] tid - Terminus ID of the event's originator
+     *  @param[in] eventDataOffset - Offset of the event data in the request
+     *                               message
+     *  @param[out] sensorEvent - the decoded event
+     *  @return PLDM completion code
+     */
+    int decodeSensorEvent(const pldm_msg* request, size_t payloadLength,
+                          uint8_t tid, size_t eventDataOffset,
+                          StateSensorEvent& sensorEvent);
+
+    /** @brief A pldmPDRRepositoryChgEvent, decoded */
+    struct PDRRepositoryChange
+    {
+        uint8_t eventDataFormat;
+        /** @brief Whether a change record reports modified PDRs */
+        bool modified;
+        PDRRecordHandles pdrRecordHandles;
+    };
+
+    /** @brief Decode the data of a pldmPDRRepositoryChgEvent
+     *
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @param[in] eventDataOffset - Offset of the event data in the request
+     *                               message
+     *  @param[out] change - the decoded event
+     *  @return PLDM completion code
+     */
+    int decodePDRRepositoryChgEvent(const pldm_msg* request,
+                                    size_t payloadLength,
+                                    size_t eventDataOffset,
+                                    PDRRepositoryChange& change);
+
+    /** @brief Check the data of an event before it is acknowledged
+     *
+     *  The sensor and PDR repository change events are decoded, the OEM
+     *  event classes are left to their handlers.
+     *
+     *  @param[in] request - Request message
+     *  @param[in] payloadLength - Request payload length
+     *  @param[in] tid - Terminus ID of the event's originator
+     *  @param[in] eventClass - class of the event
+     *  @param[in] eventDataOffset - Offset of the event data in the request
+     *                               message
+     *  @return PLDM completion code
+     */
+    int checkEvent(const pldm_msg* request, size_t payloadLength, uint8_t tid,
+                   uint8_t eventClass, size_t eventDataOffset);
+
     /** @brief Handler for extracting the PDR handles from changeEntries
      *
      *  @param[in] changeEntryData - ChangeEntry data from changeRecord
@@ -490,6 +597,21 @@ class Handler : public CmdHandler
     void setEventReceiver();
 
   private:
+    /** @brief A PlatformEventMessage waiting to be handled */
+    struct QueuedEvent
+    {
+        std::vector<uint8_t> message;
+        uint8_t formatVersion;
+        uint8_t tid;
+        uint8_t eventClass;
+        size_t eventDataOffset;
+    };
+
+    /** @brief Run the event handlers of the oldest queued event
+     *  @param[in] source - sdeventplus event source
+     */
+    void processEventQueue(sdeventplus::source::EventBase& source);
+
     uint8_t eid;
     InstanceIdDb* instanceIdDb;
     pdr_utils::Repo pdrRepo;
@@ -509,6 +631,14 @@ class Handler : public CmdHandler
     bool pdrCreated;
     std::vector<fs::path> pdrJsonsDir;
     std::unique_ptr<sdeventplus::source::Defer> deferredGetPDREvent;
+
+    /** @brief PlatformEventMessages waiting to be handled */
+    std::deque<QueuedEvent> eventQueue;
+
+    /** @brief Deferred event source handling eventQueue, one event per event
+     *         loop iteration so requests are not held up behind a burst
+     */
+    std::unique_ptr<sdeventplus::source::Defer> deferredEventQueue;
 };
 
 /** @brief Function to check if a sensor falls in OEM range
@@ -7,7 +7,9 @@
 #include "mocked_bios.hpp"
 
 #include <nlohmann/json.hpp>
+#include <sdeventplus/event.hpp>
 
+#include <chrono>
 #include <fstream>
 #include <memory>
 
@@ -71,6 +73,54 @@ class TestBIOSConfig : public ::testing::Test
         fs::remove_all(tableDir);
     }
 
+    /** @brief Handle of the str_example1 attribute in the built tables */
+    static uint16_t strExample1Handle(BIOSConfig& biosConfig)
+    {
+        auto stringTable = biosConfig.getBIOSTable(PLDM_BIOS_STRING_TABLE);
+        auto attrTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_TABLE);
+        auto stringHandle =
+            BIOSStringTable(*stringTable).findHandle("str_example1");
+        for (auto entry : BIOSTableIter<PLDM_BIOS_ATTR_TABLE>(
+                 attrTable->data(), attrTable->size()))
+        {
+            auto header = table::attribute::decodeHeader(entry);
+            if (header.stringHandle == stringHandle)
+            {
+                return header.attrHandle;
+            }
+        }
+        return 0;
+    }
+
+    /** @brief Attribute value entry setting str_example1 to a 4 character
+     *         string
+     */
+    static std::vector<uint8_t> strExample1Value(uint16_t attrHandle,
+                                                 const std::string& value)
+    {
+        std::vector<uint8_t> entry{
+            static_cast<uint8_t>(attrHandle & 0xff),
+            static_cast<uint8_t>((attrHandle >> 8) & 0xff),
+            1, /* attr type string read-write */
+            static_cast<uint8_t>(value.size()), 0,
+        };
+        entry.insert(entry.end(), value.begin(), value.end());
+        return entry;
+    }
+
+    /** @brief The attribute value table persisted in tableDir */
+    static Table storedAttrValueTable()
+    {
+        Table table;
+        BIOSTable((tableDir / "attributeValueTable").c_str()).load(table);
+        return table;
+    }
+
+    static uint64_t tableWrites(const BIOSConfig& biosConfig)
+    {
+        return biosConfig.tableWrites;
+    }
+
     static fs::path tableDir;
     static std::vector<Json> jsons;
 };
@@ -407,3 +457,84 @@ TEST_F(TestBIOSConfig, setAttrValue)
     EXPECT_THAT(std::vector<uint8_t>(p, p + attrValueEntry.size()),
                 ElementsAreArray(attrValueEntry));
 }
+
+TEST_F(TestBIOSConfig, coalescedFlush)
+{
+    MockdBusHandler dbusHandler;
+    MockSystemConfig mockSystemConfig;
+
+    EXPECT_CALL(mockSystemConfig, getPlatformName()).WillOnce(Return(""));
+    BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler, 0, 0,
+                          nullptr, nullptr, &mockSystemConfig);
+    biosConfig.removeTables();
+    biosConfig.buildTables();
+    biosConfig.flushTables();
+    auto writes = tableWrites(biosConfig);
+
+    auto attrHandle = strExample1Handle(biosConfig);
+    EXPECT_NE(attrHandle, 0);
+
+    EXPECT_CALL(dbusHandler, setDbusProperty(_, _)).Times(3);
+    for (auto value : {"abcd", "efgh", "ijkl"})
+    {
+        auto attrValueEntry = strExample1Value(attrHandle, value);
+        auto rc = biosConfig.setAttrValue(attrValueEntry.data(),
+                                          attrValueEntry.size(), false);
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+    }
+
+    // The updates are held in memory until the flush delay expires
+    EXPECT_EQ(tableWrites(biosConfig), writes);
+    auto attrValueTable = biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+    EXPECT_NE(storedAttrValueTable(), *attrValueTable);
+
+    auto event = sdeventplus::Event::get_default();
+    auto deadline = std::chrono::steady_clock::now() +
+                    BIOSConfig::tableFlushDelay + std::chrono::seconds(2);
+    while (tableWrites(biosConfig) == writes &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        event.run(std::chrono::milliseconds(100));
+    }
+    // Let a second flush show up, were the timer restarted by each update
+    auto settle = std::chrono::steady_clock::now() +
+                  BIOSConfig::tableFlushDelay;
+    while (std::chrono::steady_clock::now() < settle)
+    {
+        event.run(std::chrono::milliseconds(100));
+    }
+
+    EXPECT_EQ(tableWrites(biosConfig), writes + 1);
+    EXPECT_EQ(storedAttrValueTable(), *attrValueTable);
+}
+
+TEST_F(TestBIOSConfig, flushOnDestruction)
+{
+    MockdBusHandler dbusHandler;
+    MockSystemConfig mockSystemConfig;
+    Table attrValueTable;
+
+    {
+        EXPECT_CALL(mockSystemConfig, getPlatformName()).WillOnce(Return(""));
+        BIOSConfig biosConfig("./bios_jsons", tableDir.c_str(), &dbusHandler,
+                              0, 0, nullptr, nullptr, &mockSystemConfig);
+        biosConfig.removeTables();
+        biosConfig.buildTables();
+        biosConfig.flushTables();
+
+        auto attrHandle = strExample1Handle(biosConfig);
+        EXPECT_NE(attrHandle, 0);
+
+        EXPECT_CALL(dbusHandler, setDbusProperty(_, _)).Times(1);
+        auto attrValueEntry = strExample1Value(attrHandle, "wxyz");
+        auto rc = biosConfig.setAttrValue(attrValueEntry.data(),
+                                          attrValueEntry.size(), false);
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+
+        attrValueTable = *biosConfig.getBIOSTable(PLDM_BIOS_ATTR_VAL_TABLE);
+        EXPECT_NE(storedAttrValueTable(), attrValueTable);
+    }
+
+    // The pending table is written back without running the event loop
+    EXPECT_EQ(storedAttrValueTable(), attrValueTable);
+}
@@ -59,3 +59,32 @@ TEST_F(TestBIOSTable, testLoadOntoExisting)
     ASSERT_EQ(out[0], 99);
     ASSERT_EQ(out[1], 99);
 }
+
+TEST_F(TestBIOSTable, testStoreReplacesAtomically)
+{
+    std::vector<uint8_t> first{1, 2, 3, 4, 5, 6, 7, 8};
+    std::vector<uint8_t> second{9, 10, 11};
+    fs::path file(dir / "t1");
+    BIOSTable t(file.string().c_str());
+
+    t.store(first);
+    t.store(second);
+
+    std::vector<uint8_t> out{};
+    t.load(out);
+    ASSERT_EQ(out, second);
+
+    auto tmpFile = file;
+    tmpFile += ".tmp";
+    ASSERT_FALSE(fs::exists(tmpFile));
+}
+
+TEST_F(TestBIOSTable, testStoreToMissingDirThrows)
+{
+    std::vector<uint8_t> table{1, 2, 3};
+    fs::path file(dir / "missing" / "t1");
+    BIOSTable t(file.string().c_str());
+
+    ASSERT_THROW(t.store(table), std::runtime_error);
+    ASSERT_EQ(true, t.isEmpty());
+}
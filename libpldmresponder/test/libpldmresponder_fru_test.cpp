@@ -4,9 +4,13 @@
 
 #include <config.h>
 #include <libpldm/pdr.h>
+#include <libpldm/utils.h>
 
 #include <sdbusplus/message.hpp>
 
+#include <array>
+#include <chrono>
+
 #include <gtest/gtest.h>
 
 TEST(FruParser, allScenarios)
@@ -182,3 +186,303 @@ TEST(FruImpl, entityByObjectPath)
     entityPtr = mockedFruHandler.getEntityByObjectPath(invalidIface);
     ASSERT_TRUE(!entityPtr);
 }
+
+class TestFruImpl : public ::testing::Test
+{
+  protected:
+    TestFruImpl() :
+        pdrRepo(pldm_pdr_init(), pldm_pdr_destroy),
+        entityTree(pldm_entity_association_tree_init(),
+                   pldm_entity_association_tree_destroy),
+        bmcEntityTree(pldm_entity_association_tree_init(),
+                      pldm_entity_association_tree_destroy),
+        handler("./fru_jsons/good", "./fru_jsons/fru_master/fru_master.json",
+                pdrRepo.get(), entityTree.get(), bmcEntityTree.get(), nullptr),
+        impl(handler.impl)
+    {
+        impl.inventoryObjects[systemPath] = {
+            {"xyz.openbmc_project.Inventory.Item.System", {}}};
+    }
+
+    /** @brief Put a CPU in the inventory snapshot */
+    void setCpu(const std::string& path, const std::string& serialNumber,
+                bool present = true)
+    {
+        impl.inventoryObjects[path] = {
+            {"xyz.openbmc_project.Inventory.Item", {{"Present", present}}},
+            {cpuInterface, {}},
+            {"xyz.openbmc_project.Inventory.Decorator.Asset",
+             {{"PartNumber", std::string("PN-CPU")},
+              {"SerialNumber", serialNumber}}}};
+    }
+
+    bool add(const std::string& path)
+    {
+        return impl.addFRU(path);
+    }
+
+    void update(const std::string& path, const std::string& serialNumber)
+    {
+        setCpu(path, serialNumber);
+        impl.updateFRU(path);
+    }
+
+    void remove(const std::string& path)
+    {
+        impl.inventoryObjects.erase(path);
+        impl.removeFRU(path);
+    }
+
+    /** @brief Check the incrementally maintained table against one encoded
+     *         from scratch out of the record sets, and its checksum and the
+     *         CRC32 state saved at every record set against a full CRC32
+     */
+    void expectRebuilt()
+    {
+        std::vector<uint8_t> expected;
+        uint16_t numRecords = 0;
+        for (const auto& recordSet : impl.recordSets)
+        {
+            EXPECT_EQ(recordSet.offset, expected.size());
+            EXPECT_EQ(recordSet.crcAtOffset,
+                      pldm::utils::crc32Update(pldm::utils::crc32Init,
+                                               expected.data(),
+                                               expected.size()));
+            uint16_t count = 0;
+            auto records = impl.encodeRecords(
+                impl.inventoryObjects.at(recordSet.objectPath),
+                impl.parser.getRecordInfo(cpuInterface), recordSet.entity,
+                recordSet.rsi, count);
+            EXPECT_EQ(recordSet.length, records.size());
+            EXPECT_EQ(recordSet.numRecords, count);
+            expected.insert(expected.end(), records.begin(), records.end());
+            numRecords += count;
+        }
+
+        EXPECT_EQ(impl.table, expected);
+        EXPECT_EQ(impl.numRecords(), numRecords);
+        EXPECT_EQ(impl.numRSI(), impl.recordSets.size());
+
+        uint32_t checksum = 0;
+        if (!expected.empty())
+        {
+            expected.resize(expected.size() +
+                                pldm::utils::getNumPadBytes(expected.size()),
+                            0);
+            checksum = crc32(expected.data(), expected.size());
+        }
+        EXPECT_EQ(impl.checkSum(), checksum);
+
+        auto snapshot = impl.tableSnapshot();
+        expected.insert(expected.end(),
+                        reinterpret_cast<const uint8_t*>(&checksum),
+                        reinterpret_cast<const uint8_t*>(&checksum) +
+                            sizeof(checksum));
+        EXPECT_EQ(*snapshot, expected);
+    }
+
+    uint32_t changeCount() const
+    {
+        return impl.changeCount();
+    }
+
+    /** @brief Skip building the table from the D-Bus inventory */
+    void markBuilt()
+    {
+        impl.isBuilt = true;
+    }
+
+    /** @brief Drop the GetFRURecordTable transfers on the next request */
+    void expireTransfers()
+    {
+        handler.tableTransferTimeout = std::chrono::seconds(0);
+    }
+
+    /** @brief Request a part of the FRU table with GetFRURecordTable
+     *
+     *  @return the completion code, and the part if it is PLDM_SUCCESS
+     */
+    uint8_t getPart(pldm_tid_t tid, uint32_t dataTransferHandle,
+                    uint8_t transferOpFlag, std::vector<uint8_t>& part,
+                    uint32_t& nextDataTransferHandle, uint8_t& transferFlag)
+    {
+        std::array<uint8_t,
+                   sizeof(pldm_msg_hdr) + PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES>
+            requestMsg{};
+        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+        EXPECT_EQ(encode_get_fru_record_table_req(
+                      0, dataTransferHandle, transferOpFlag, request,
+                      PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES),
+                  PLDM_SUCCESS);
+        auto response = handler.getFRURecordTable(
+            tid, request, PLDM_GET_FRU_RECORD_TABLE_REQ_BYTES);
+
+        uint8_t cc = response[sizeof(pldm_msg_hdr)];
+        if (cc != PLDM_SUCCESS)
+        {
+            return cc;
+        }
+        part.resize(response.size());
+        size_t length = 0;
+        EXPECT_EQ(decode_get_fru_record_table_resp(
+                      reinterpret_cast<const pldm_msg*>(response.data()),
+                      response.size() - sizeof(pldm_msg_hdr), &cc,
+                      &nextDataTransferHandle, &transferFlag, part.data(),
+                      &length),
+                  PLDM_SUCCESS);
+        part.resize(length);
+        return cc;
+    }
+
+    static constexpr auto systemPath = "/xyz/openbmc_project/inventory/system";
+    static constexpr auto cpuInterface =
+        "xyz.openbmc_project.Inventory.Item.Cpu";
+    const std::string cpu0 = std::string(systemPath) + "/cpu0";
+    const std::string cpu1 = std::string(systemPath) + "/cpu1";
+    const std::string cpu2 = std::string(systemPath) + "/cpu2";
+
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo;
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        entityTree;
+    std::unique_ptr<pldm_entity_association_tree,
+                    decltype(&pldm_entity_association_tree_destroy)>
+        bmcEntityTree;
+    pldm::responder::fru::Handler handler;
+    pldm::responder::FruImpl& impl;
+};
+
+TEST_F(TestFruImpl, addUpdateRemove)
+{
+    setCpu(cpu0, "S0");
+    setCpu(cpu1, "S1");
+    setCpu(cpu2, "S2");
+    ASSERT_TRUE(add(cpu0));
+    ASSERT_TRUE(add(cpu1));
+    ASSERT_TRUE(add(cpu2));
+    expectRebuilt();
+
+    // Records growing and shrinking in the middle and at the start of the
+    // table shift the record sets after them
+    update(cpu1, "SERIAL-NUMBER-OF-CPU1");
+    expectRebuilt();
+    update(cpu0, "0");
+    expectRebuilt();
+    update(cpu2, "SERIAL-NUMBER-OF-CPU2");
+    expectRebuilt();
+
+    // Unchanged records leave the table alone
+    auto count = changeCount();
+    update(cpu1, "SERIAL-NUMBER-OF-CPU1");
+    EXPECT_EQ(changeCount(), count);
+    expectRebuilt();
+
+    // Removing from the middle, the end and the start
+    remove(cpu1);
+    expectRebuilt();
+    remove(cpu2);
+    expectRebuilt();
+    remove(cpu0);
+    expectRebuilt();
+    EXPECT_EQ(changeCount(), count + 3);
+
+    // The table grows again after being emptied
+    setCpu(cpu1, "S1");
+    ASSERT_TRUE(add(cpu1));
+    expectRebuilt();
+}
+
+TEST_F(TestFruImpl, notPresentNotAdded)
+{
+    setCpu(cpu0, "S0", false);
+    EXPECT_FALSE(add(cpu0));
+    expectRebuilt();
+    EXPECT_EQ(impl.size(), 0u);
+}
+
+TEST_F(TestFruImpl, multipartTransfer)
+{
+    // A table spanning more than two parts
+    constexpr uint32_t partSize = FRU_TABLE_TRANSFER_SIZE;
+    for (size_t i = 0; impl.size() <= 2 * partSize; i++)
+    {
+        auto path = std::string(systemPath) + "/cpu" + std::to_string(i);
+        setCpu(path, std::string(200, static_cast<char>('A' + i % 26)));
+        ASSERT_TRUE(add(path));
+    }
+    markBuilt();
+    auto expected = *impl.tableSnapshot();
+
+    std::vector<uint8_t> part;
+    uint32_t next = 0;
+    uint8_t flag = 0;
+
+    // GetFirstPart must start at handle 0, GetNextPart needs a transfer
+    EXPECT_EQ(getPart(1, 4, PLDM_GET_FIRSTPART, part, next, flag),
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+    EXPECT_EQ(getPart(1, 0, PLDM_GET_NEXTPART, part, next, flag),
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+
+    // Start
+    ASSERT_EQ(getPart(1, 0, PLDM_GET_FIRSTPART, part, next, flag),
+              PLDM_SUCCESS);
+    EXPECT_EQ(flag, PLDM_START);
+    EXPECT_EQ(part.size(), partSize);
+    EXPECT_EQ(next, partSize);
+    std::vector<uint8_t> received(part);
+
+    // The parts of a transfer come from the table as it was at the start
+    update(std::string(systemPath) + "/cpu0", "CHANGED");
+
+    // A handle past the table, and another terminus without a transfer
+    EXPECT_EQ(getPart(1, expected.size(), PLDM_GET_NEXTPART, part, next,
+                      flag),
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+    EXPECT_EQ(getPart(2, next, PLDM_GET_NEXTPART, part, next, flag),
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+
+    // Middle, requested twice as after a lost response
+    ASSERT_EQ(getPart(1, next, PLDM_GET_NEXTPART, part, next, flag),
+              PLDM_SUCCESS);
+    EXPECT_EQ(flag, PLDM_MIDDLE);
+    auto middle = part;
+    auto middleNext = next;
+    ASSERT_EQ(getPart(1, received.size(), PLDM_GET_NEXTPART, part, next,
+                      flag),
+              PLDM_SUCCESS);
+    EXPECT_EQ(part, middle);
+    EXPECT_EQ(next, middleNext);
+    received.insert(received.end(), part.begin(), part.end());
+
+    // Up to the end
+    while (flag != PLDM_END)
+    {
+        ASSERT_EQ(next, received.size());
+        ASSERT_EQ(getPart(1, next, PLDM_GET_NEXTPART, part, next, flag),
+                  PLDM_SUCCESS);
+        ASSERT_TRUE(flag == PLDM_MIDDLE || flag == PLDM_END);
+        received.insert(received.end(), part.begin(), part.end());
+    }
+    EXPECT_EQ(next, 0u);
+    EXPECT_EQ(received, expected);
+
+    // The last part requested again, as after a lost response
+    auto lastPart = received.size() - part.size();
+    auto last = part;
+    ASSERT_EQ(getPart(1, lastPart, PLDM_GET_NEXTPART, part, next, flag),
+              PLDM_SUCCESS);
+    EXPECT_EQ(flag, PLDM_END);
+    EXPECT_EQ(next, 0u);
+    EXPECT_EQ(part, last);
+
+    // The snapshot is released once the terminus stops requesting parts
+    expireTransfers();
+    EXPECT_EQ(getPart(1, lastPart, PLDM_GET_NEXTPART, part, next, flag),
+              PLDM_FRU_INVALID_DATA_TRANSFER_HANDLE);
+
+    // A new transfer sees the change
+    ASSERT_EQ(getPart(1, 0, PLDM_GET_FIRSTPART, part, next, flag),
+              PLDM_SUCCESS);
+    EXPECT_NE(part, std::vector<uint8_t>(expected.begin(),
+                                         expected.begin() + part.size()));
+}
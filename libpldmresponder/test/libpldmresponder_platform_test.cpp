@@ -8,10 +8,13 @@
 #include "libpldmresponder/platform_numeric_effecter.hpp"
 #include "libpldmresponder/platform_state_effecter.hpp"
 #include "libpldmresponder/platform_state_sensor.hpp"
+#include "test/test_instance_id.hpp"
 
 #include <sdbusplus/test/sdbus_mock.hpp>
 #include <sdeventplus/event.hpp>
 
+#include <chrono>
+
 using namespace pldm::pdr;
 using namespace pldm::utils;
 using namespace pldm::responder;
@@ -684,6 +687,60 @@ TEST(StateSensorHandler, allScenarios)
     }
 }
 
+class TestStateSensorHandler : public testing::Test
+{
+  protected:
+    TestStateSensorHandler() : handler("./event_jsons/good") {}
+
+    pldm::responder::events::EventAction&
+        action(const pldm::responder::events::StateSensorEntry& entry)
+    {
+        return handler.eventMap.at(entry);
+    }
+
+    pldm::responder::events::StateSensorHandler handler;
+};
+
+TEST_F(TestStateSensorHandler, eventAction)
+{
+    using namespace pldm::responder::events;
+
+    // Event Entry 2 maps event states 2 and 3
+    StateSensorEntry entry{1, 64, 1, 1, 1};
+    const auto& setters = action(entry).setters;
+    ASSERT_EQ(setters.size(), 4u);
+    EXPECT_EQ(setters[0].append, nullptr);
+    EXPECT_EQ(setters[1].append, nullptr);
+    ASSERT_NE(setters[2].append, nullptr);
+    ASSERT_NE(setters[3].append, nullptr);
+    PropertyValue value2{std::in_place_type<uint8_t>, 9};
+    PropertyValue value3{std::in_place_type<uint8_t>, 10};
+    ASSERT_EQ(value2 == setters[2].value, true);
+    ASSERT_EQ(value3 == setters[3].value, true);
+
+    // The appender is resolved for the property type
+    EXPECT_EQ(setters[2].append, setters[3].append);
+    StateSensorEntry stringEntry{1, 64, 1, 0, 1};
+    EXPECT_NE(action(stringEntry).setters[0].append, setters[2].append);
+
+    // The entries differing only by their state set ID are both found
+    EXPECT_NE(&action({2, 67, 2, 0, 1}), &action({2, 67, 2, 0, 2}));
+
+    // No action for an unknown sensor
+    EXPECT_EQ(handler.eventAction({0, 0, 0, 0, 1}, 0), PLDM_SUCCESS);
+
+    // Event states without a D-Bus value
+    EXPECT_EQ(handler.eventAction(entry, 1), PLDM_ERROR_INVALID_DATA);
+    EXPECT_EQ(handler.eventAction(entry, 4), PLDM_ERROR_INVALID_DATA);
+    EXPECT_EQ(handler.eventAction(entry, 0xFF), PLDM_ERROR_INVALID_DATA);
+
+    // The cached service is used, and dropped once setting the property
+    // fails so it is looked up again
+    action(entry).service = "xyz.openbmc_project.pldm.test";
+    EXPECT_EQ(handler.eventAction(entry, 2), PLDM_ERROR);
+    EXPECT_TRUE(action(entry).service.empty());
+}
+
 TEST(TerminusLocatorPDR, BMCTerminusLocatorPDR)
 {
     auto inPDRRepo = pldm_pdr_init();
@@ -814,3 +871,286 @@ TEST(getStateSensorReadingsHandler, testBadRequest)
     pldm_pdr_destroy(inPDRRepo);
     pldm_pdr_destroy(outPDRRepo);
 }
+
+TEST(platformEventMessage, eventQueue)
+{
+    constexpr uint8_t eventClass = 0xF0;
+    std::vector<uint8_t> handledTids;
+    EventMap addOnHandlers{
+        {eventClass,
+         {[&handledTids](const pldm_msg*, size_t, uint8_t, uint8_t tid,
+                         size_t) {
+        handledTids.push_back(tid);
+        return PLDM_SUCCESS;
+    }}}};
+
+    MockdBusHandler mockedUtils;
+    auto pdrRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, 0, nullptr, "", pdrRepo, nullptr, nullptr,
+                    nullptr, nullptr, nullptr, nullptr, event, true,
+                    addOnHandlers);
+
+    auto sendEvent = [&handler](uint8_t tid, uint8_t eventClass) {
+        std::array<uint8_t, 1> eventData{0x01};
+        std::vector<uint8_t> requestMsg(
+            sizeof(pldm_msg_hdr) + PLDM_PLATFORM_EVENT_MESSAGE_MIN_REQ_BYTES +
+            eventData.size());
+        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+        auto rc = encode_platform_event_message_req(
+            0, 1, tid, eventClass, eventData.data(), eventData.size(), request,
+            requestMsg.size() - sizeof(pldm_msg_hdr));
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+        auto response = handler.platformEventMessage(
+            request, requestMsg.size() - sizeof(pldm_msg_hdr));
+        return response[sizeof(pldm_msg_hdr)];
+    };
+
+    // Events are acknowledged before they are handled
+    constexpr size_t depth = EVENT_QUEUE_DEPTH;
+    for (size_t i = 0; i < depth; ++i)
+    {
+        ASSERT_EQ(sendEvent(i % 256, eventClass), PLDM_SUCCESS);
+    }
+    EXPECT_TRUE(handledTids.empty());
+
+    // The queue is full
+    EXPECT_EQ(sendEvent(0, eventClass), PLDM_ERROR_NOT_READY);
+    EXPECT_EQ(sendEvent(0, eventClass + 1), PLDM_ERROR_INVALID_DATA);
+
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+    while (handledTids.size() < depth &&
+           std::chrono::steady_clock::now() < deadline)
+    {
+        event.run(std::chrono::milliseconds(100));
+    }
+    ASSERT_EQ(handledTids.size(), depth);
+    for (size_t i = 0; i < depth; ++i)
+    {
+        EXPECT_EQ(handledTids[i], static_cast<uint8_t>(i % 256));
+    }
+
+    // The queue drained, new events are accepted again
+    EXPECT_EQ(sendEvent(1, eventClass), PLDM_SUCCESS);
+
+    pldm_pdr_destroy(pdrRepo);
+}
+
+TEST(platformEventMessage, checkedBeforeAcknowledged)
+{
+    MockdBusHandler mockedUtils;
+    auto pdrRepo = pldm_pdr_init();
+    auto event = sdeventplus::Event::get_default();
+    Handler handler(&mockedUtils, 0, nullptr, "", pdrRepo, nullptr, nullptr,
+                    nullptr, nullptr, nullptr, nullptr, event, true);
+
+    auto sendEvent = [&handler](uint8_t eventClass,
+                                const std::vector<uint8_t>& eventData) {
+        std::vector<uint8_t> requestMsg(
+            sizeof(pldm_msg_hdr) + PLDM_PLATFORM_EVENT_MESSAGE_MIN_REQ_BYTES +
+            eventData.size());
+        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+        auto rc = encode_platform_event_message_req(
+            0, 1, 1, eventClass, eventData.data(), eventData.size(), request,
+            requestMsg.size() - sizeof(pldm_msg_hdr));
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+        auto response = handler.platformEventMessage(
+            request, requestMsg.size() - sizeof(pldm_msg_hdr));
+        return response[sizeof(pldm_msg_hdr)];
+    };
+
+    // Sensor ID, class, then the sensor offset, event state and previous
+    // event state of a state sensor
+    EXPECT_EQ(sendEvent(PLDM_SENSOR_EVENT,
+                        {0x01, 0x00, PLDM_STATE_SENSOR_STATE, 0, 2, 1}),
+              PLDM_SUCCESS);
+    EXPECT_EQ(sendEvent(PLDM_SENSOR_EVENT, {0x01, 0x00}),
+              PLDM_ERROR_INVALID_LENGTH);
+    EXPECT_EQ(sendEvent(PLDM_SENSOR_EVENT,
+                        {0x01, 0x00, PLDM_STATE_SENSOR_STATE, 0, 2}),
+              PLDM_ERROR_INVALID_LENGTH);
+    EXPECT_EQ(sendEvent(PLDM_SENSOR_EVENT,
+                        {0x01, 0x00, PLDM_SENSOR_OP_STATE, 0, 1}),
+              PLDM_ERROR_INVALID_DATA);
+
+    // Event data format, number of change records, then the operation and
+    // number of change entries of each record and their record handles
+    EXPECT_EQ(sendEvent(PLDM_PDR_REPOSITORY_CHG_EVENT,
+                        {FORMAT_IS_PDR_HANDLES, 1, PLDM_RECORDS_ADDED, 1, 0x01,
+                         0x00, 0x00, 0x00}),
+              PLDM_SUCCESS);
+    EXPECT_EQ(sendEvent(PLDM_PDR_REPOSITORY_CHG_EVENT,
+                        {FORMAT_IS_PDR_TYPES, 0}),
+              PLDM_ERROR_INVALID_DATA);
+    EXPECT_EQ(sendEvent(PLDM_PDR_REPOSITORY_CHG_EVENT,
+                        {FORMAT_IS_PDR_HANDLES, 1, PLDM_RECORDS_DELETED, 2,
+                         0x01, 0x00, 0x00, 0x00}),
+              PLDM_ERROR_INVALID_DATA);
+
+    pldm_pdr_destroy(pdrRepo);
+}
+
+/** @brief Records the event messages instead of sending them to the host */
+class RecordingDbusToPLDMEvent : public pldm::state_sensor::DbusToPLDMEvent
+{
+  public:
+    explicit RecordingDbusToPLDMEvent(pldm::InstanceIdDb& instanceIdDb) :
+        DbusToPLDMEvent(0, 9, instanceIdDb, nullptr)
+    {}
+
+    void sendEventMsg(uint8_t eventType,
+                      const std::vector<uint8_t>& /*eventDataVec*/) override
+    {
+        sent.push_back(eventType);
+    }
+
+    std::vector<uint8_t> sent;
+};
+
+class TestDbusToPLDMEvent : public testing::Test
+{
+  protected:
+    TestDbusToPLDMEvent() :
+        event(sdeventplus::Event::get_default()), events(instanceIdDb),
+        handler(&mockedUtils, 0, nullptr, "", pdrRepo.get(), nullptr, &events,
+                nullptr, nullptr, nullptr, nullptr, event, true)
+    {
+        events.eventPolling = true;
+    }
+
+    void queue(uint16_t sensorId, uint8_t offset, uint8_t state,
+               uint8_t previousState)
+    {
+        events.queueSensorEvent(sensorId, offset, state, previousState);
+    }
+
+    pldm::Response poll(uint8_t transferOperationFlag, uint16_t eventIdToAcknowledge)
+    {
+        std::array<uint8_t, sizeof(pldm_msg_hdr) +
+                                PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_REQ_BYTES>
+            requestMsg{};
+        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+        auto rc = encode_poll_for_platform_event_message_req(
+            0, 1, transferOperationFlag,
+            transferOperationFlag == PLDM_GET_NEXTPART ? 1 : 0,
+            eventIdToAcknowledge, request,
+            PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_REQ_BYTES);
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+        return handler.pollForPlatformEventMessage(
+            request, PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_REQ_BYTES);
+    }
+
+    /** @brief Decode a poll response
+     *  @return event ID, PLDM_PLATFORM_EVENT_ID_NULL if there was no event
+     */
+    uint16_t decodePoll(const pldm::Response& response)
+    {
+        uint8_t completionCode{};
+        uint8_t tid{};
+        uint16_t eventId{};
+        uint32_t nextDataTransferHandle{};
+        uint8_t transferFlag{};
+        uint8_t eventClass{};
+        uint32_t eventDataSize{};
+        void* eventData = nullptr;
+        uint32_t checksum{};
+        auto rc = decode_poll_for_platform_event_message_resp(
+            reinterpret_cast<const pldm_msg*>(response.data()),
+            response.size() - sizeof(pldm_msg_hdr), &completionCode, &tid,
+            &eventId, &nextDataTransferHandle, &transferFlag, &eventClass,
+            &eventDataSize, &eventData, &checksum);
+        EXPECT_EQ(rc, PLDM_SUCCESS);
+        EXPECT_EQ(completionCode, PLDM_SUCCESS);
+        if (eventId == PLDM_PLATFORM_EVENT_ID_NULL)
+        {
+            EXPECT_EQ(response.size(),
+                      sizeof(pldm_msg_hdr) +
+                          PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_MIN_RESP_BYTES);
+            return eventId;
+        }
+
+        // A single part, the checksum follows the event data
+        EXPECT_EQ(transferFlag, PLDM_START_AND_END);
+        EXPECT_EQ(eventClass, PLDM_SENSOR_EVENT);
+        EXPECT_EQ(eventDataSize,
+                  static_cast<uint32_t>(
+                      pldm::state_sensor::DbusToPLDMEvent::maxEventDataSize));
+        EXPECT_EQ(response.size(),
+                  sizeof(pldm_msg_hdr) +
+                      PLDM_POLL_FOR_PLATFORM_EVENT_MESSAGE_MIN_RESP_BYTES +
+                      sizeof(uint32_t) + 2 * sizeof(uint8_t) +
+                      sizeof(uint32_t) + eventDataSize + sizeof(uint32_t));
+        auto data = static_cast<const uint8_t*>(eventData);
+        EXPECT_EQ(checksum,
+                  crc32Final(crc32Update(crc32Init, data, eventDataSize)));
+        return eventId;
+    }
+
+    std::vector<uint8_t>& sent()
+    {
+        return events.sent;
+    }
+
+    MockdBusHandler mockedUtils;
+    TestInstanceIdDb instanceIdDb;
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo{
+        pldm_pdr_init(), pldm_pdr_destroy};
+    sdeventplus::Event event;
+    RecordingDbusToPLDMEvent events;
+    Handler handler;
+};
+
+TEST_F(TestDbusToPLDMEvent, pollForPlatformEventMessage)
+{
+    // Nothing queued
+    EXPECT_EQ(decodePoll(poll(PLDM_GET_FIRSTPART, PLDM_PLATFORM_EVENT_ID_NULL)),
+              PLDM_PLATFORM_EVENT_ID_NULL);
+
+    queue(1, 0, 2, 1);
+    ASSERT_EQ(sent().size(), 1u);
+    EXPECT_EQ(sent()[0], PLDM_MESSAGE_POLL_EVENT);
+
+    // The event is handed out until it is acknowledged
+    auto eventId = decodePoll(poll(PLDM_GET_FIRSTPART,
+                                   PLDM_PLATFORM_EVENT_ID_NULL));
+    ASSERT_NE(eventId, PLDM_PLATFORM_EVENT_ID_NULL);
+    EXPECT_EQ(decodePoll(poll(PLDM_GET_FIRSTPART, PLDM_PLATFORM_EVENT_ID_NULL)),
+              eventId);
+
+    // Events fit in a single part
+    auto response = poll(PLDM_GET_NEXTPART, PLDM_PLATFORM_EVENT_ID_FRAGMENT);
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_ERROR_INVALID_DATA);
+
+    // Acknowledged alone with an event left, the host is notified again
+    queue(2, 0, 2, 1);
+    EXPECT_EQ(sent().size(), 1u);
+    EXPECT_EQ(decodePoll(poll(PLDM_ACKNOWLEDGEMENT_ONLY, eventId)),
+              PLDM_PLATFORM_EVENT_ID_NULL);
+    ASSERT_EQ(sent().size(), 2u);
+    EXPECT_EQ(sent()[1], PLDM_MESSAGE_POLL_EVENT);
+
+    // The last event acknowledged alone, the next event notifies the host
+    auto nextEventId = decodePoll(poll(PLDM_GET_FIRSTPART,
+                                       PLDM_PLATFORM_EVENT_ID_NULL));
+    ASSERT_NE(nextEventId, PLDM_PLATFORM_EVENT_ID_NULL);
+    EXPECT_NE(nextEventId, eventId);
+    EXPECT_EQ(decodePoll(poll(PLDM_ACKNOWLEDGEMENT_ONLY, nextEventId)),
+              PLDM_PLATFORM_EVENT_ID_NULL);
+    EXPECT_EQ(sent().size(), 2u);
+    EXPECT_EQ(decodePoll(poll(PLDM_GET_FIRSTPART, PLDM_PLATFORM_EVENT_ID_NULL)),
+              PLDM_PLATFORM_EVENT_ID_NULL);
+
+    queue(3, 0, 2, 1);
+    EXPECT_EQ(sent().size(), 3u);
+}
+
+TEST_F(TestDbusToPLDMEvent, pollingDisabled)
+{
+    events.eventPolling = false;
+
+    // The events are sent to the host, none is handed out to a poll
+    EXPECT_EQ(events.getPolledEvent(), nullptr);
+    auto response = poll(PLDM_GET_FIRSTPART, PLDM_PLATFORM_EVENT_ID_NULL);
+    ASSERT_EQ(response.size(), sizeof(pldm_msg_hdr) + 1);
+    EXPECT_EQ(response[sizeof(pldm_msg_hdr)], PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+}
@@ -209,12 +209,14 @@ class Handler : public CmdHandler
             [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
             return this->getFileTable(request, payloadLength);
         });
-        handlers.emplace(
+        // Plain file reads and writes only touch the file table and the
+        // file itself, so they can run off the event loop
+        handlers.emplaceAsync(
             PLDM_READ_FILE,
             [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
             return this->readFile(request, payloadLength);
         });
-        handlers.emplace(
+        handlers.emplaceAsync(
             PLDM_WRITE_FILE,
             [this](pldm_tid_t, const pldm_msg* request, size_t payloadLength) {
             return this->writeFile(request, payloadLength);
@@ -5,6 +5,7 @@
 #include <phosphor-logging/lg2.hpp>
 
 #include <fstream>
+#include <mutex>
 
 PHOSPHOR_LOG2_USING;
 
@@ -130,7 +131,11 @@ Table FileTable::operator()() const
 
 FileTable& buildFileTable(const std::string& fileTablePath)
 {
+    // The table is read-only once built, but it may be built from an async
+    // file handler running on a worker thread
+    static std::mutex tableMutex;
     static FileTable table;
+    std::lock_guard lock(tableMutex);
     if (table.isEmpty())
     {
         table = std::move(FileTable(fileTablePath));
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "handler.hpp"
+
+#include <libpldm/base.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
+#include <sdeventplus/source/io.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <span>
+#include <thread>
+#include <vector>
+
+namespace pldm
+{
+namespace responder
+{
+
+/** @class AsyncDispatcher
+ *
+ *  @brief Runs the command handlers registered with CmdTable::emplaceAsync()
+ *         on a bounded pool of worker threads
+ *
+ *  Responses are handed back to the event loop through an eventfd and sent
+ *  from there, so they can complete in a different order than the requests
+ *  arrived. Async handlers must only touch state that is safe to access
+ *  from a worker thread while the event loop keeps running.
+ */
+class AsyncDispatcher
+{
+  public:
+    using SendResponse =
+        std::function<void(pldm_tid_t tid, const Response& response)>;
+
+    AsyncDispatcher() = delete;
+    AsyncDispatcher(const AsyncDispatcher&) = delete;
+    AsyncDispatcher(AsyncDispatcher&&) = delete;
+    AsyncDispatcher& operator=(const AsyncDispatcher&) = delete;
+    AsyncDispatcher& operator=(AsyncDispatcher&&) = delete;
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - event loop the responses are sent from
+     *  @param[in] numWorkers - number of worker threads
+     *  @param[in] maxPending - maximum number of requests waiting for a
+     *                          worker
+     *  @param[in] sendResponse - callback sending a response, invoked on the
+     *                            event loop
+     */
+    AsyncDispatcher(sdeventplus::Event& event, size_t numWorkers,
+                    size_t maxPending, SendResponse sendResponse) :
+        maxPending(maxPending),
+        sendResponse(std::move(sendResponse)),
+        notifyFd(eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)),
+        notifySource(event, notifyFd, EPOLLIN,
+                     std::bind_front(&AsyncDispatcher::drainResponses, this))
+    {
+        for (size_t i = 0; i < numWorkers; i++)
+        {
+            workers.emplace_back(&AsyncDispatcher::work, this);
+        }
+    }
+
+    /** @brief Destructor
+     *
+     *  Waits for the workers to finish the requests they are handling and
+     *  sends the responses the event loop has not sent yet. Requests still
+     *  waiting for a worker are answered with PLDM_ERROR, so no requester is
+     *  left without a response.
+     */
+    ~AsyncDispatcher()
+    {
+        {
+            std::lock_guard lock(mutex);
+            stopping = true;
+        }
+        pendingCond.notify_all();
+        for (auto& worker : workers)
+        {
+            worker.join();
+        }
+
+        if (!pending.empty())
+        {
+            lg2::error(
+                "Stopping with {COUNT} async PLDM requests not handled, answering them with PLDM_ERROR",
+                "COUNT", pending.size());
+        }
+        for (const auto& job : pending)
+        {
+            auto request =
+                reinterpret_cast<const pldm_msg*>(job.requestMsg.data());
+            lg2::error("Dropped PLDM type {TYPE} command {CMD} from TID {TID}",
+                       "TYPE", static_cast<unsigned>(request->hdr.type), "CMD",
+                       static_cast<unsigned>(request->hdr.command), "TID",
+                       static_cast<unsigned>(job.tid));
+            completed.emplace_back(
+                job.tid, CmdHandler::ccOnlyResponse(request, PLDM_ERROR));
+        }
+        pending.clear();
+
+        for (const auto& [tid, response] : completed)
+        {
+            sendResponse(tid, response);
+        }
+        close(notifyFd);
+    }
+
+    /** @brief Queue a request for a worker thread
+     *
+     *  @param[in] tid - PLDM request TID
+     *  @param[in] handler - handler of the request's command
+     *  @param[in] requestMsg - PLDM request message, copied
+     *  @return false if all workers are busy and the queue is full, in which
+     *          case the caller should handle the request inline
+     */
+    bool submit(pldm_tid_t tid, const CmdTable::Entry& handler,
+                std::span<const uint8_t> requestMsg)
+    {
+        {
+            std::lock_guard lock(mutex);
+            if (workers.empty() || pending.size() >= maxPending)
+            {
+                return false;
+            }
+            pending.emplace_back(
+                tid, handler,
+                std::vector<uint8_t>(requestMsg.begin(), requestMsg.end()));
+        }
+        pendingCond.notify_one();
+        return true;
+    }
+
+  private:
+    struct Job
+    {
+        pldm_tid_t tid;
+        CmdTable::Entry handler;
+        std::vector<uint8_t> requestMsg;
+    };
+
+    struct Completion
+    {
+        pldm_tid_t tid;
+        Response response;
+    };
+
+    void work()
+    {
+        while (true)
+        {
+            Job job;
+            {
+                std::unique_lock lock(mutex);
+                pendingCond.wait(
+                    lock, [this] { return stopping || !pending.empty(); });
+                if (stopping)
+                {
+                    return;
+                }
+                job = std::move(pending.front());
+                pending.pop_front();
+            }
+
+            auto request =
+                reinterpret_cast<const pldm_msg*>(job.requestMsg.data());
+            auto reqMsgLen = job.requestMsg.size() - sizeof(pldm_msg_hdr);
+            Response response;
+            try
+            {
+                response = job.handler(job.tid, request, reqMsgLen);
+            }
+            catch (const std::exception& e)
+            {
+                lg2::error("Failed to handle PLDM command {CMD}: {ERROR}",
+                           "CMD", static_cast<unsigned>(request->hdr.command),
+                           "ERROR", e);
+                response = CmdHandler::ccOnlyResponse(request, PLDM_ERROR);
+            }
+
+            {
+                std::lock_guard lock(mutex);
+                completed.emplace_back(job.tid, std::move(response));
+            }
+            uint64_t one = 1;
+            if (write(notifyFd, &one, sizeof(one)) < 0)
+            {
+                lg2::error("Failed to signal an async PLDM response");
+            }
+        }
+    }
+
+    void drainResponses(sdeventplus::source::IO& /*io*/, int fd,
+                        uint32_t /*revents*/)
+    {
+        uint64_t count{};
+        if (read(fd, &count, sizeof(count)) < 0)
+        {
+            return;
+        }
+
+        std::deque<Completion> ready;
+        {
+            std::lock_guard lock(mutex);
+            ready.swap(completed);
+        }
+        for (const auto& [tid, response] : ready)
+        {
+            sendResponse(tid, response);
+        }
+    }
+
+    size_t maxPending;
+    SendResponse sendResponse;
+    int notifyFd;
+    sdeventplus::source::IO notifySource;
+
+    std::mutex mutex;
+    std::condition_variable pendingCond;
+    std::deque<Job> pending;
+    std::deque<Completion> completed;
+    bool stopping = false;
+    std::vector<std::thread> workers;
+};
+
+} // namespace responder
+} // namespace pldm
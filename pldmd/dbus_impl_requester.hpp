@@ -54,9 +54,11 @@ class Requester : public RequesterIntf
         // have that infrastructure in place yet. So use the EID value for the
         // TID. This is an interim step towards the PLDM requester logic moving
         // into libpldm, and eventually this won't be needed.
+        // IDs handed out over D-Bus are freed by other processes through the
+        // shared database, so they bypass any in-process lease
         try
         {
-            id = pldmInstanceIdDb.next(eid);
+            id = pldmInstanceIdDb.InstanceIdDb::next(eid);
         }
         catch (const std::runtime_error& e)
         {
@@ -77,7 +79,7 @@ class Requester : public RequesterIntf
      */
     void markFree(uint8_t eid, uint8_t instanceId)
     {
-        pldmInstanceIdDb.free(eid, instanceId);
+        pldmInstanceIdDb.InstanceIdDb::free(eid, instanceId);
     }
 
   private:
@@ -2,9 +2,12 @@
 
 #include <libpldm/base.h>
 
+#include <array>
 #include <cassert>
 #include <functional>
-#include <map>
+#include <memory>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace pldm
@@ -20,6 +23,105 @@ class CmdHandler;
 using HandlerFunc = std::function<Response(
     pldm_tid_t tid, const pldm_msg* request, size_t reqMsgLen)>;
 
+/** @class CmdTable
+ *
+ *  @brief Dense table of PLDM command handlers indexed by command code
+ *
+ *  Each handler is stored as a plain function pointer plus the context it
+ *  was registered with, so dispatching a command is an array index and an
+ *  indirect call, without a tree lookup or std::function.
+ */
+class CmdTable
+{
+  public:
+    using Thunk = Response (*)(void* context, pldm_tid_t tid,
+                               const pldm_msg* request, size_t reqMsgLen);
+
+    /** @brief A registered command handler */
+    struct Entry
+    {
+        Thunk thunk = nullptr;
+        void* context = nullptr;
+        /** @brief run on an AsyncDispatcher worker thread if one is free */
+        bool async = false;
+
+        Response operator()(pldm_tid_t tid, const pldm_msg* request,
+                            size_t reqMsgLen) const
+        {
+            return thunk(context, tid, request, reqMsgLen);
+        }
+    };
+
+    /** @brief Register a handler for a command, unless the command already
+     *         has one
+     *
+     *  @param[in] command - PLDM command code
+     *  @param[in] func - callable taking (tid, request, reqMsgLen) and
+     *                    returning the PLDM response message
+     */
+    template <typename F>
+    void emplace(Command command, F&& func)
+    {
+        using Func = std::decay_t<F>;
+
+        auto& entry = entries[command];
+        if (entry.thunk)
+        {
+            return;
+        }
+
+        auto context = new Func(std::forward<F>(func));
+        contexts.emplace_back(context, [](void* ptr) {
+            delete static_cast<Func*>(ptr);
+        });
+        entry.context = context;
+        entry.thunk = [](void* ptr, pldm_tid_t tid, const pldm_msg* request,
+                         size_t reqMsgLen) {
+            return (*static_cast<Func*>(ptr))(tid, request, reqMsgLen);
+        };
+    }
+
+    /** @brief Register a handler that may run off the event loop, on a
+     *         worker thread of the AsyncDispatcher
+     *
+     *  The handler must only touch state that is safe to access concurrently
+     *  with the event loop and with other async handlers.
+     *
+     *  @param[in] command - PLDM command code
+     *  @param[in] func - callable taking (tid, request, reqMsgLen) and
+     *                    returning the PLDM response message
+     */
+    template <typename F>
+    void emplaceAsync(Command command, F&& func)
+    {
+        if (!entries[command].thunk)
+        {
+            emplace(command, std::forward<F>(func));
+            entries[command].async = true;
+        }
+    }
+
+    /** @brief Find the handler of a command
+     *
+     *  @param[in] command - PLDM command code
+     *  @return the handler, or nullptr if the command has none
+     */
+    const Entry* find(Command command) const
+    {
+        const auto& entry = entries[command];
+        return entry.thunk ? &entry : nullptr;
+    }
+
+    bool contains(Command command) const
+    {
+        return find(command) != nullptr;
+    }
+
+  private:
+    std::array<Entry, 256> entries{};
+    std::vector<std::unique_ptr<void, void (*)(void*)>> contexts;
+};
+
 class CmdHandler
 {
   public:
@@ -31,12 +133,18 @@ class CmdHandler
      *  @param[in] pldmCommand - PLDM command code
      *  @param[in] request - PLDM request message
      *  @param[in] reqMsgLen - PLDM request message size
-     *  @return PLDM response message
+     *  @return PLDM response message, with PLDM_ERROR_UNSUPPORTED_PLDM_CMD
+     *          if the command has no handler
      */
     Response handle(pldm_tid_t tid, Command pldmCommand,
                     const pldm_msg* request, size_t reqMsgLen)
     {
-        return handlers.at(pldmCommand)(tid, request, reqMsgLen);
+        auto entry = handlers.find(pldmCommand);
+        if (!entry)
+        {
+            return ccOnlyResponse(request, PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+        }
+        return (*entry)(tid, request, reqMsgLen);
     }
 
     /** @brief Create a response message containing only cc
@@ -57,10 +165,10 @@ class CmdHandler
     }
 
   protected:
-    /** @brief map of PLDM command code to handler - to be populated by derived
-     *         classes.
+    /** @brief table of PLDM command code to handler - to be populated by
+     *         derived classes.
      */
-    std::map<Command, HandlerFunc> handlers;
+    CmdTable handlers;
 };
 
 } // namespace responder
@@ -0,0 +1,309 @@
+#pragma once
+
+#include "common/instance_id.hpp"
+
+#include <libpldm/instance-id.h>
+
+#include <phosphor-logging/lg2.hpp>
+#include <sdbusplus/timer.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+namespace pldm
+{
+
+/** @class LeasedInstanceIdDb
+ *
+ *  @brief Instance ID allocator that leases blocks of instance IDs per TID
+ *         from the shared instance ID database
+ *
+ *  Allocating from the shared database takes file lock system calls. Here
+ *  the IDs are leased from it leaseSize at a time and then handed out from
+ *  a 32-bit bitmap per TID, so next() and free() only touch memory until a
+ *  TID runs out of leased IDs. Leases a TID hasn't used for a whole idle
+ *  period are returned to the shared database, as are all leases on
+ *  destruction.
+ */
+class LeasedInstanceIdDb : public InstanceIdDb
+{
+  public:
+    /** @brief Allocation statistics */
+    struct Stats
+    {
+        /** @brief instance IDs handed out */
+        uint64_t allocations = 0;
+        /** @brief instance IDs leased from the shared database */
+        uint64_t leased = 0;
+        /** @brief allocations that failed because a TID had no free ID */
+        uint64_t exhaustions = 0;
+        std::chrono::nanoseconds totalLatency{};
+        std::chrono::nanoseconds maxLatency{};
+    };
+
+    LeasedInstanceIdDb() = delete;
+    LeasedInstanceIdDb(const LeasedInstanceIdDb&) = delete;
+    LeasedInstanceIdDb(LeasedInstanceIdDb&&) = delete;
+    LeasedInstanceIdDb& operator=(const LeasedInstanceIdDb&) = delete;
+    LeasedInstanceIdDb& operator=(LeasedInstanceIdDb&&) = delete;
+
+    /** @brief Constructor, using the default instance ID database
+     *
+     *  @param[in] event - event loop the idle leases are released from
+     *  @param[in] leaseSize - number of IDs leased at a time, 0 allocates
+     *                         every ID from the shared database
+     *  @param[in] idleTimeout - period after which unused leases are
+     *                           returned, 0 keeps them until destruction
+     */
+    LeasedInstanceIdDb(sdeventplus::Event& event, uint8_t leaseSize,
+                       std::chrono::seconds idleTimeout) :
+        InstanceIdDb(),
+        leaseSize(leaseSize),
+        sweepTimer(event.get(),
+                   std::bind_front(&LeasedInstanceIdDb::releaseIdleLeases,
+                                   this))
+    {
+        startSweep(idleTimeout);
+    }
+
+    /** @brief Constructor
+     *
+     *  @param[in] event - event loop the idle leases are released from
+     *  @param[in] path - instance ID database path
+     *  @param[in] leaseSize - number of IDs leased at a time, 0 allocates
+     *                         every ID from the shared database
+     *  @param[in] idleTimeout - period after which unused leases are
+     *                           returned, 0 keeps them until destruction
+     */
+    LeasedInstanceIdDb(sdeventplus::Event& event, const std::string& path,
+                       uint8_t leaseSize, std::chrono::seconds idleTimeout) :
+        InstanceIdDb(path),
+        leaseSize(leaseSize),
+        sweepTimer(event.get(),
+                   std::bind_front(&LeasedInstanceIdDb::releaseIdleLeases,
+                                   this))
+    {
+        startSweep(idleTimeout);
+    }
+
+    ~LeasedInstanceIdDb() override
+    {
+        std::lock_guard lock(mutex);
+        for (size_t tid = 0; tid < leases.size(); tid++)
+        {
+            release(tid, leases[tid]);
+        }
+        if (stats.allocations)
+        {
+            lg2::info(
+                "Instance ID allocations: {COUNT}, leased: {LEASED}, exhaustions: {EXHAUSTED}, mean latency: {MEAN_NS} ns, max latency: {MAX_NS} ns",
+                "COUNT", stats.allocations, "LEASED", stats.leased,
+                "EXHAUSTED", stats.exhaustions, "MEAN_NS",
+                stats.totalLatency.count() / stats.allocations, "MAX_NS",
+                stats.maxLatency.count());
+        }
+    }
+
+    /** @brief Allocate an instance ID for the given terminus
+     *
+     *  @param[in] tid - the terminus ID the instance ID is associated with
+     *  @return - PLDM instance id
+     *  @throw std::runtime_error if there are no available instance IDs
+     */
+    uint8_t next(uint8_t tid) override
+    {
+        auto start = std::chrono::steady_clock::now();
+        std::lock_guard lock(mutex);
+
+        uint8_t id;
+        if (!leaseSize)
+        {
+            id = allocate(tid);
+        }
+        else
+        {
+            auto& lease = leases[tid];
+            uint32_t available = lease.leased & ~lease.inUse;
+            if (!available)
+            {
+                available = extend(tid, lease);
+            }
+
+            // Start the search after the last ID handed out, so a freed ID
+            // isn't reused right away
+            id = (std::countr_zero(std::rotr(available, lease.cursor)) +
+                  lease.cursor) %
+                 maxInstanceIds;
+            lease.inUse |= 1u << id;
+            lease.cursor = (id + 1) % maxInstanceIds;
+            lease.idle = false;
+        }
+
+        auto latency = std::chrono::steady_clock::now() - start;
+        stats.allocations++;
+        stats.totalLatency += latency;
+        stats.maxLatency = std::max<std::chrono::nanoseconds>(stats.maxLatency,
+                                                              latency);
+        return id;
+    }
+
+    /** @brief Mark an instance id as unused
+     *
+     *  @param[in] tid - the terminus ID the instance ID is associated with
+     *  @param[in] instanceId - PLDM instance id to be freed
+     *  @throw std::runtime_error if the instance ID wasn't allocated
+     */
+    void free(uint8_t tid, uint8_t instanceId) override
+    {
+        std::lock_guard lock(mutex);
+        if (!leaseSize)
+        {
+            InstanceIdDb::free(tid, instanceId);
+            return;
+        }
+
+        auto& lease = leases[tid];
+        if (instanceId >= maxInstanceIds ||
+            !(lease.inUse & (1u << instanceId)))
+        {
+            throw std::runtime_error(
+                "Instance ID " + std::to_string(instanceId) + " for TID " +
+                std::to_string(tid) + " was not previously allocated");
+        }
+        lease.inUse &= ~(1u << instanceId);
+    }
+
+    /** @brief Get the allocation statistics */
+    Stats getStats() const
+    {
+        std::lock_guard lock(mutex);
+        return stats;
+    }
+
+  private:
+    /** @brief instance IDs per TID, as defined by DSP0240 */
+    static constexpr uint8_t maxInstanceIds = 32;
+
+    struct Lease
+    {
+        /** @brief IDs leased from the shared database */
+        uint32_t leased = 0;
+        /** @brief leased IDs handed out and not yet freed */
+        uint32_t inUse = 0;
+        /** @brief where the search for the next free ID starts */
+        uint8_t cursor = 0;
+        /** @brief no ID was handed out since the last sweep */
+        bool idle = false;
+    };
+
+    void startSweep(std::chrono::seconds idleTimeout)
+    {
+        if (leaseSize && idleTimeout.count())
+        {
+            sweepTimer.start(idleTimeout, true);
+        }
+    }
+
+    /** @brief Allocate an ID from the shared database, counting exhaustion */
+    uint8_t allocate(uint8_t tid)
+    {
+        try
+        {
+            return InstanceIdDb::next(tid);
+        }
+        catch (const std::runtime_error&)
+        {
+            stats.exhaustions++;
+            lg2::error("No free instance IDs for TID {TID}", "TID", tid);
+            throw;
+        }
+    }
+
+    /** @brief Lease up to leaseSize more IDs for a TID
+     *
+     *  @return the leased IDs not in use
+     */
+    uint32_t extend(uint8_t tid, Lease& lease)
+    {
+        for (uint8_t i = 0; i < leaseSize; i++)
+        {
+            uint8_t id;
+            try
+            {
+                id = InstanceIdDb::next(tid);
+            }
+            catch (const std::runtime_error&)
+            {
+                break;
+            }
+            lease.leased |= 1u << id;
+            stats.leased++;
+        }
+
+        uint32_t available = lease.leased & ~lease.inUse;
+        if (!available)
+        {
+            stats.exhaustions++;
+            lg2::error("No free instance IDs for TID {TID}", "TID", tid);
+            throw std::runtime_error("No free instance ids");
+        }
+        return available;
+    }
+
+    /** @brief Return a TID's leased IDs to the shared database */
+    void release(uint8_t tid, Lease& lease)
+    {
+        for (auto leased = lease.leased; leased; leased &= leased - 1)
+        {
+            uint8_t id = std::countr_zero(leased);
+            try
+            {
+                InstanceIdDb::free(tid, id);
+            }
+            catch (...)
+            {
+                lg2::error("Failed to return instance ID {ID} of TID {TID}",
+                           "ID", id, "TID", tid);
+            }
+        }
+        lease = Lease{};
+    }
+
+    /** @brief Return the leases that were idle for a whole sweep period */
+    void releaseIdleLeases()
+    {
+        std::lock_guard lock(mutex);
+        for (size_t tid = 0; tid < leases.size(); tid++)
+        {
+            auto& lease = leases[tid];
+            if (!lease.leased || lease.inUse)
+            {
+                continue;
+            }
+            if (lease.idle)
+            {
+                release(tid, lease);
+            }
+            else
+            {
+                lease.idle = true;
+            }
+        }
+    }
+
+    uint8_t leaseSize;
+    std::array<Lease, PLDM_MAX_TIDS> leases{};
+    Stats stats{};
+    mutable std::mutex mutex;
+    sdbusplus::Timer sweepTimer;
+};
+
+} // namespace pldm
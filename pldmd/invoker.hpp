@@ -4,8 +4,9 @@
 
 #include <libpldm/base.h>
 
-#include <map>
+#include <array>
 #include <memory>
+#include <stdexcept>
 
 namespace pldm
 {
@@ -22,10 +23,15 @@ class Invoker
      *
      *  @param[in] pldmType - PLDM type code
      *  @param[in] handler - PLDM Type handler
+     *  @throw std::out_of_range if pldmType does not fit in a PLDM header
      */
     void registerHandler(Type pldmType, std::unique_ptr<CmdHandler> handler)
     {
-        handlers.emplace(pldmType, std::move(handler));
+        auto& entry = handlers.at(pldmType);
+        if (!entry)
+        {
+            entry = std::move(handler);
+        }
     }
 
     /** @brief Invoke a PLDM command handler
@@ -35,17 +41,39 @@ class Invoker
      *  @param[in] pldmCommand - PLDM command code
      *  @param[in] request - PLDM request message
      *  @param[in] reqMsgLen - PLDM request message size
-     *  @return PLDM response message
+     *  @return PLDM response message, with PLDM_ERROR_UNSUPPORTED_PLDM_CMD
+     *          if the type or command has no handler
      */
     Response handle(pldm_tid_t tid, Type pldmType, Command pldmCommand,
                     const pldm_msg* request, size_t reqMsgLen)
     {
-        return handlers.at(pldmType)->handle(tid, pldmCommand, request,
-                                             reqMsgLen);
+        auto entry = find(pldmType, pldmCommand);
+        if (!entry)
+        {
+            return CmdHandler::ccOnlyResponse(request,
+                                              PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+        }
+        return (*entry)(tid, request, reqMsgLen);
+    }
+
+    /** @brief Find the handler of a PLDM command
+     *
+     *  @param[in] pldmType - PLDM type code
+     *  @param[in] pldmCommand - PLDM command code
+     *  @return the handler, or nullptr if the type or command has none
+     */
+    const CmdTable::Entry* find(Type pldmType, Command pldmCommand) const
+    {
+        if (pldmType >= handlers.size() || !handlers[pldmType])
+        {
+            return nullptr;
+        }
+        return handlers[pldmType]->find(pldmCommand);
     }
 
   private:
-    std::map<Type, std::unique_ptr<CmdHandler>> handlers;
+    /** @brief handler of each PLDM type, indexed by the 6-bit type code */
+    std::array<std::unique_ptr<CmdHandler>, 64> handlers;
 };
 
 } // namespace responder
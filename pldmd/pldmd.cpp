@@ -1,10 +1,12 @@
 
+#include "async_dispatcher.hpp"
 #include "common/flight_recorder.hpp"
 #include "common/instance_id.hpp"
 #include "common/transport.hpp"
 #include "common/utils.hpp"
 #include "dbus_impl_requester.hpp"
 #include "fw-update/manager.hpp"
+#include "instance_id_lease.hpp"
 #include "invoker.hpp"
 #include "requester/handler.hpp"
 #include "requester/mctp_endpoint_discovery.hpp"
@@ -37,6 +39,7 @@
 #include <iterator>
 #include <memory>
 #include <ranges>
+#include <span>
 #include <sstream>
 #include <stdexcept>
 #include <string>
@@ -84,7 +87,8 @@ void interruptFlightRecorderCallBack(Signal& /*signal*/,
 }
 
 static std::optional<Response>
-    processRxMsg(const std::vector<uint8_t>& requestMsg, Invoker& invoker,
+    processRxMsg(std::span<const uint8_t> requestMsg, Invoker& invoker,
+                 AsyncDispatcher& asyncDispatcher,
                  requester::Handler<requester::Request>& handler,
                  fw_update::Manager* fwManager, pldm_tid_t tid)
 {
@@ -105,6 +109,16 @@ static std::optional<Response>
         size_t requestLen = requestMsg.size() - sizeof(struct pldm_msg_hdr);
         try
         {
+            auto entry = hdrFields.pldm_type != PLDM_FWUP
+                             ? invoker.find(hdrFields.pldm_type,
+                                            hdrFields.command)
+                             : nullptr;
+            if (entry && entry->async &&
+                asyncDispatcher.submit(tid, *entry, requestMsg))
+            {
+                // The response is sent once a worker thread has handled it
+                return std::nullopt;
+            }
             if (hdrFields.pldm_type != PLDM_FWUP)
             {
                 response = invoker.handle(tid, hdrFields.pldm_type,
@@ -117,22 +131,13 @@ static std::optional<Response>
                                                     request, requestLen);
             }
         }
-        catch (const std::out_of_range& e)
+        catch (const std::exception& e)
         {
-            uint8_t completion_code = PLDM_ERROR_UNSUPPORTED_PLDM_CMD;
-            response.resize(sizeof(pldm_msg_hdr));
-            auto responseHdr = reinterpret_cast<pldm_msg_hdr*>(response.data());
-            pldm_header_info header{};
-            header.msg_type = PLDM_RESPONSE;
-            header.instance = hdrFields.instance;
-            header.pldm_type = hdrFields.pldm_type;
-            header.command = hdrFields.command;
-            if (PLDM_SUCCESS != pack_pldm_header(&header, responseHdr))
-            {
-                error("Failed adding response header: {ERROR}", "ERROR", e);
-                return std::nullopt;
-            }
-            response.insert(response.end(), completion_code);
+            error(
+                "Failed to handle PLDM type {TYPE} command {CMD}: {ERROR}",
+                "TYPE", static_cast<unsigned>(hdrFields.pldm_type), "CMD",
+                static_cast<unsigned>(hdrFields.command), "ERROR", e);
+            response = CmdHandler::ccOnlyResponse(request, PLDM_ERROR);
         }
         return response;
     }
@@ -182,7 +187,9 @@ int main(int argc, char** argv)
     sdbusplus::server::manager_t objManager(bus,
                                             "/xyz/openbmc_project/software");
 
-    InstanceIdDb instanceIdDb;
+    LeasedInstanceIdDb instanceIdDb(
+        event, INSTANCE_ID_LEASE_SIZE,
+        std::chrono::seconds(INSTANCE_ID_LEASE_IDLE_TIMEOUT));
     dbus_api::Requester dbusImplReq(bus, "/xyz/openbmc_project/pldm",
                                     instanceIdDb);
     sdbusplus::server::manager_t inventoryManager(
@@ -303,7 +310,27 @@ int main(int argc, char** argv)
         std::make_unique<fw_update::Manager>(event, reqHandler, instanceIdDb);
     std::unique_ptr<MctpDiscovery> mctpDiscoveryHandler =
         std::make_unique<MctpDiscovery>(bus, fwManager.get());
-    auto callback = [verbose, &invoker, &reqHandler, &fwManager, &pldmTransport,
+    auto sendResponse = [verbose, &pldmTransport](pldm_tid_t tid,
+                                                  const Response& response) {
+        FlightRecorder::GetInstance().saveRecord(response, true, tid);
+        if (verbose)
+        {
+            printBuffer(Tx, response);
+        }
+
+        auto returnCode = pldmTransport.sendMsg(tid, response.data(),
+                                                response.size());
+        if (returnCode != PLDM_REQUESTER_SUCCESS)
+        {
+            warning("Failed to send PLDM response: {RETURN_CODE}",
+                    "RETURN_CODE", returnCode);
+        }
+    };
+    AsyncDispatcher asyncDispatcher(event, RESPONDER_WORKER_THREADS,
+                                    2 * RESPONDER_WORKER_THREADS, sendResponse);
+
+    auto callback = [verbose, &invoker, &asyncDispatcher, &reqHandler,
+                     &fwManager, &pldmTransport, &sendResponse,
                      TID](IO& io, int fd, uint32_t revents) mutable {
         if (!(revents & EPOLLIN))
         {
@@ -321,32 +348,25 @@ int main(int argc, char** argv)
 
         if (returnCode == PLDM_REQUESTER_SUCCESS)
         {
-            std::vector<uint8_t> requestMsgVec(
-                static_cast<uint8_t*>(requestMsg),
-                static_cast<uint8_t*>(requestMsg) + recvDataLength);
-            FlightRecorder::GetInstance().saveRecord(requestMsgVec, false);
+            // Handle the message in the buffer the transport received it
+            // into rather than copying it
+            std::unique_ptr<void, decltype(&free)> requestMsgPtr(requestMsg,
+                                                                 free);
+            std::span<const uint8_t> requestMsgSpan(
+                static_cast<const uint8_t*>(requestMsg), recvDataLength);
+            FlightRecorder::GetInstance().saveRecord(requestMsgSpan, false,
+                                                     TID);
             if (verbose)
             {
-                printBuffer(Rx, requestMsgVec);
+                printBuffer(Rx, requestMsgSpan);
             }
             // process message and send response
-            auto response = processRxMsg(requestMsgVec, invoker, reqHandler,
+            auto response = processRxMsg(requestMsgSpan, invoker,
+                                         asyncDispatcher, reqHandler,
                                          fwManager.get(), TID);
             if (response.has_value())
             {
-                FlightRecorder::GetInstance().saveRecord(*response, true);
-                if (verbose)
-                {
-                    printBuffer(Tx, *response);
-                }
-
-                returnCode = pldmTransport.sendMsg(TID, (*response).data(),
-                                                   (*response).size());
-                if (returnCode != PLDM_REQUESTER_SUCCESS)
-                {
-                    warning("Failed to send PLDM response: {RETURN_CODE}",
-                            "RETURN_CODE", returnCode);
-                }
+                sendResponse(TID, *response);
             }
         }
         // TODO check that we get here if mctp-demux dies?
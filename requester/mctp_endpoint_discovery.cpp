@@ -37,67 +37,75 @@ MctpDiscovery::MctpDiscovery(sdbusplus::bus_t& bus,
     }
 
     std::vector<mctp_eid_t> eids;
+    fw_update::EndpointRoutes routes;
+    fw_update::EndpointUUIDs uuids;
 
     for (const auto& [objectPath, interfaces] : objects)
     {
-        for (const auto& [intfName, properties] : interfaces)
-        {
-            if (intfName == mctpEndpointIntfName)
-            {
-                if (properties.contains("EID") &&
-                    properties.contains("SupportedMessageTypes"))
-                {
-                    auto eid = std::get<mctp_eid_t>(properties.at("EID"));
-                    auto types = std::get<std::vector<uint8_t>>(
-                        properties.at("SupportedMessageTypes"));
-                    if (std::find(types.begin(), types.end(), mctpTypePLDM) !=
-                        types.end())
-                    {
-                        eids.emplace_back(eid);
-                    }
-                }
-            }
-        }
+        addEndpoint(objectPath.str, interfaces, eids, routes, uuids);
     }
 
     if (eids.size() && fwManager)
     {
-        fwManager->handleMCTPEndpoints(eids);
+        fwManager->handleMCTPEndpoints(eids, routes, uuids);
     }
 }
 
 void MctpDiscovery::dicoverEndpoints(sdbusplus::message_t& msg)
 {
-    constexpr std::string_view mctpEndpointIntfName{
-        "xyz.openbmc_project.MCTP.Endpoint"};
     std::vector<mctp_eid_t> eids;
+    fw_update::EndpointRoutes routes;
+    fw_update::EndpointUUIDs uuids;
 
     sdbusplus::message::object_path objPath;
-    std::map<std::string, std::map<std::string, dbus::Value>> interfaces;
+    dbus::InterfaceMap interfaces;
     msg.read(objPath, interfaces);
+    addEndpoint(objPath.str, interfaces, eids, routes, uuids);
 
-    for (const auto& [intfName, properties] : interfaces)
+    if (eids.size() && fwManager)
     {
-        if (intfName == mctpEndpointIntfName)
-        {
-            if (properties.contains("EID") &&
-                properties.contains("SupportedMessageTypes"))
-            {
-                auto eid = std::get<mctp_eid_t>(properties.at("EID"));
-                auto types = std::get<std::vector<uint8_t>>(
-                    properties.at("SupportedMessageTypes"));
-                if (std::find(types.begin(), types.end(), mctpTypePLDM) !=
-                    types.end())
-                {
-                    eids.emplace_back(eid);
-                }
-            }
-        }
+        fwManager->handleMCTPEndpoints(eids, routes, uuids);
+    }
+}
+
+void MctpDiscovery::addEndpoint(const std::string& objectPath,
+                                const dbus::InterfaceMap& interfaces,
+                                std::vector<mctp_eid_t>& eids,
+                                fw_update::EndpointRoutes& routes,
+                                fw_update::EndpointUUIDs& uuids)
+{
+    auto endpoint = interfaces.find(std::string(mctpEndpointIntfName));
+    if (endpoint == interfaces.end())
+    {
+        return;
     }
 
-    if (eids.size() && fwManager)
+    const auto& properties = endpoint->second;
+    if (!properties.contains("EID") ||
+        !properties.contains("SupportedMessageTypes"))
     {
-        fwManager->handleMCTPEndpoints(eids);
+        return;
+    }
+
+    auto eid = std::get<mctp_eid_t>(properties.at("EID"));
+    auto types =
+        std::get<std::vector<uint8_t>>(properties.at("SupportedMessageTypes"));
+    if (std::find(types.begin(), types.end(), mctpTypePLDM) == types.end())
+    {
+        return;
+    }
+
+    eids.emplace_back(eid);
+    routes.emplace(eid, utils::findParent(objectPath));
+
+    auto uuid = interfaces.find(std::string(uuidIntfName));
+    if (uuid != interfaces.end() && uuid->second.contains("UUID"))
+    {
+        if (const auto* value =
+                std::get_if<std::string>(&uuid->second.at("UUID")))
+        {
+            uuids.emplace(eid, *value);
+        }
     }
 }
 
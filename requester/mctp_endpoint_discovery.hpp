@@ -37,10 +37,28 @@ class MctpDiscovery
 
     void dicoverEndpoints(sdbusplus::message_t& msg);
 
+    /** @brief Collect the EID, route and UUID of an MCTP endpoint object
+     *         supporting PLDM
+     *
+     *  @param[in] objectPath - D-Bus object path of the endpoint
+     *  @param[in] interfaces - interfaces and properties of the object
+     *  @param[out] eids - EIDs of the PLDM endpoints
+     *  @param[out] routes - route of the PLDM endpoints
+     *  @param[out] uuids - UUID of the PLDM endpoints that have one
+     */
+    static void addEndpoint(const std::string& objectPath,
+                            const dbus::InterfaceMap& interfaces,
+                            std::vector<mctp_eid_t>& eids,
+                            fw_update::EndpointRoutes& routes,
+                            fw_update::EndpointUUIDs& uuids);
+
     static constexpr uint8_t mctpTypePLDM = 1;
 
     static constexpr std::string_view mctpEndpointIntfName{
         "xyz.openbmc_project.MCTP.Endpoint"};
+
+    static constexpr std::string_view uuidIntfName{
+        "xyz.openbmc_project.Common.UUID"};
 };
 
 } // namespace pldm
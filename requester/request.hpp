@@ -177,7 +177,7 @@ class Request final : public RequestRetryTimer
             pldm::utils::printBuffer(pldm::utils::Tx, requestMsg);
         }
         pldm::flightrecorder::FlightRecorder::GetInstance().saveRecord(
-            requestMsg, true);
+            requestMsg, true, eid);
         const struct pldm_msg_hdr* hdr =
             (struct pldm_msg_hdr*)(requestMsg.data());
         if (!hdr->request)
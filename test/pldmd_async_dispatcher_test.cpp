@@ -0,0 +1,224 @@
+#include "pldmd/async_dispatcher.hpp"
+
+#include <libpldm/base.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace pldm::responder;
+
+constexpr Command echoCmd = 0x01;
+constexpr Command blockCmd = 0x02;
+constexpr Command throwCmd = 0x03;
+
+class AsyncDispatcherTest : public testing::Test
+{
+  protected:
+    AsyncDispatcherTest() :
+        event(sdeventplus::Event::get_default()),
+        released(release.get_future().share())
+    {
+        table.emplaceAsync(echoCmd, [](pldm_tid_t, const pldm_msg* request,
+                                       size_t) {
+            return CmdHandler::ccOnlyResponse(request, PLDM_SUCCESS);
+        });
+        table.emplaceAsync(blockCmd, [this](pldm_tid_t,
+                                            const pldm_msg* request, size_t) {
+            ++started;
+            released.wait();
+            return CmdHandler::ccOnlyResponse(request, PLDM_SUCCESS);
+        });
+        table.emplaceAsync(throwCmd, [](pldm_tid_t, const pldm_msg*,
+                                        size_t) -> Response {
+            throw std::runtime_error("handler failed");
+        });
+    }
+
+    ~AsyncDispatcherTest() override
+    {
+        if (!releasedAll)
+        {
+            release.set_value();
+        }
+    }
+
+    /** @brief Create a dispatcher, replacing the previous one */
+    void makeDispatcher(size_t numWorkers, size_t maxPending)
+    {
+        dispatcher.reset();
+        dispatcher = std::make_unique<AsyncDispatcher>(
+            event, numWorkers, maxPending,
+            [this](pldm_tid_t tid, const Response& response) {
+            sendThreads.push_back(std::this_thread::get_id());
+            responses.emplace_back(tid, response);
+        });
+    }
+
+    bool submit(pldm_tid_t tid, Command command, uint8_t instanceId)
+    {
+        std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+        auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+        request->hdr.request = 1;
+        request->hdr.instance_id = instanceId;
+        request->hdr.type = PLDM_BASE;
+        request->hdr.command = command;
+        return dispatcher->submit(tid, *table.find(command), requestMsg);
+    }
+
+    void releaseBlocked()
+    {
+        releasedAll = true;
+        release.set_value();
+    }
+
+    /** @brief Wait for count handlers of blockCmd to be running */
+    void waitForStarted(size_t count)
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::seconds(5);
+        while (started.load() < count &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        ASSERT_EQ(started.load(), count);
+    }
+
+    /** @brief Run the event loop until count responses were sent */
+    void waitForResponses(size_t count)
+    {
+        auto deadline = std::chrono::steady_clock::now() +
+                        std::chrono::seconds(5);
+        while (responses.size() < count &&
+               std::chrono::steady_clock::now() < deadline)
+        {
+            event.run(std::chrono::milliseconds(100));
+        }
+        ASSERT_EQ(responses.size(), count);
+    }
+
+    /** @brief Check a response answers a request and has completion code cc
+     */
+    static void expectResponse(const Response& response, Command command,
+                               uint8_t instanceId, uint8_t cc)
+    {
+        ASSERT_EQ(response.size(), sizeof(pldm_msg));
+        auto msg = reinterpret_cast<const pldm_msg*>(response.data());
+        EXPECT_EQ(static_cast<uint8_t>(msg->hdr.request), 0);
+        EXPECT_EQ(static_cast<uint8_t>(msg->hdr.instance_id), instanceId);
+        EXPECT_EQ(msg->hdr.command, command);
+        EXPECT_EQ(msg->payload[0], cc);
+    }
+
+    sdeventplus::Event event;
+    CmdTable table;
+    std::promise<void> release;
+    std::shared_future<void> released;
+    bool releasedAll = false;
+    std::atomic<size_t> started = 0;
+    std::vector<std::pair<pldm_tid_t, Response>> responses;
+    std::vector<std::thread::id> sendThreads;
+
+    /** @brief Destroyed first, once the blocked handlers were released */
+    std::unique_ptr<AsyncDispatcher> dispatcher;
+};
+
+TEST_F(AsyncDispatcherTest, submitAndComplete)
+{
+    makeDispatcher(2, 4);
+    ASSERT_TRUE(submit(5, echoCmd, 1));
+    ASSERT_TRUE(submit(6, echoCmd, 2));
+
+    // Responses are only sent from the event loop
+    EXPECT_TRUE(responses.empty());
+    waitForResponses(2);
+    for (const auto& id : sendThreads)
+    {
+        EXPECT_EQ(id, std::this_thread::get_id());
+    }
+
+    // Either request may complete first
+    if (responses[0].first != 5)
+    {
+        std::swap(responses[0], responses[1]);
+    }
+    EXPECT_EQ(responses[0].first, 5);
+    expectResponse(responses[0].second, echoCmd, 1, PLDM_SUCCESS);
+    EXPECT_EQ(responses[1].first, 6);
+    expectResponse(responses[1].second, echoCmd, 2, PLDM_SUCCESS);
+}
+
+TEST_F(AsyncDispatcherTest, queueFull)
+{
+    // Without workers every request is handled inline
+    makeDispatcher(0, 4);
+    EXPECT_FALSE(submit(5, echoCmd, 1));
+
+    makeDispatcher(1, 1);
+    ASSERT_TRUE(submit(5, blockCmd, 1));
+    waitForStarted(1);
+    ASSERT_TRUE(submit(5, echoCmd, 2));
+    EXPECT_FALSE(submit(5, echoCmd, 3));
+
+    releaseBlocked();
+    waitForResponses(2);
+    expectResponse(responses[0].second, blockCmd, 1, PLDM_SUCCESS);
+    expectResponse(responses[1].second, echoCmd, 2, PLDM_SUCCESS);
+
+    // The queue has room again
+    ASSERT_TRUE(submit(5, echoCmd, 4));
+    waitForResponses(3);
+    expectResponse(responses[2].second, echoCmd, 4, PLDM_SUCCESS);
+}
+
+TEST_F(AsyncDispatcherTest, handlerThrows)
+{
+    makeDispatcher(1, 1);
+    ASSERT_TRUE(submit(5, throwCmd, 1));
+    waitForResponses(1);
+    EXPECT_EQ(responses[0].first, 5);
+    expectResponse(responses[0].second, throwCmd, 1, PLDM_ERROR);
+
+    // The worker keeps handling requests
+    ASSERT_TRUE(submit(5, echoCmd, 2));
+    waitForResponses(2);
+    expectResponse(responses[1].second, echoCmd, 2, PLDM_SUCCESS);
+}
+
+TEST_F(AsyncDispatcherTest, shutdown)
+{
+    makeDispatcher(1, 2);
+    ASSERT_TRUE(submit(5, blockCmd, 1));
+    waitForStarted(1);
+    ASSERT_TRUE(submit(6, echoCmd, 2));
+    ASSERT_TRUE(submit(7, echoCmd, 3));
+
+    // The running request completes once the dispatcher is stopping, the
+    // queued ones never reach the worker
+    std::thread releaser([this] {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        releaseBlocked();
+    });
+    dispatcher.reset();
+    releaser.join();
+
+    // Every requester is answered, without running the event loop
+    ASSERT_EQ(responses.size(), 3u);
+    std::sort(responses.begin(), responses.end(),
+              [](const auto& a, const auto& b) { return a.first < b.first; });
+    expectResponse(responses[0].second, blockCmd, 1, PLDM_SUCCESS);
+    expectResponse(responses[1].second, echoCmd, 2, PLDM_ERROR);
+    expectResponse(responses[2].second, echoCmd, 3, PLDM_ERROR);
+}
@@ -0,0 +1,118 @@
+#include "pldmd/invoker.hpp"
+
+#include <libpldm/base.h>
+
+#include <chrono>
+#include <cstdio>
+#include <map>
+#include <stdexcept>
+#include <vector>
+
+using namespace pldm;
+using namespace pldm::responder;
+
+namespace
+{
+
+constexpr Type benchType = PLDM_PLATFORM;
+constexpr Command firstCmd = 0x01;
+constexpr Command lastCmd = 0x20;
+constexpr Command unknownCmd = 0xF0;
+
+class BenchHandler : public CmdHandler
+{
+  public:
+    BenchHandler()
+    {
+        for (Command cmd = firstCmd; cmd <= lastCmd; cmd++)
+        {
+            handlers.emplace(cmd, [this](pldm_tid_t, const pldm_msg* request,
+                                         size_t) {
+                return this->handle(request);
+            });
+        }
+    }
+
+    Response handle(const pldm_msg* request)
+    {
+        return ccOnlyResponse(request, PLDM_SUCCESS);
+    }
+};
+
+/** @brief The std::map of std::function lookup the invoker used before */
+class MapInvoker
+{
+  public:
+    MapInvoker()
+    {
+        auto& cmds = handlers[benchType];
+        for (Command cmd = firstCmd; cmd <= lastCmd; cmd++)
+        {
+            cmds.emplace(cmd, [](pldm_tid_t, const pldm_msg* request, size_t) {
+                return CmdHandler::ccOnlyResponse(request, PLDM_SUCCESS);
+            });
+        }
+    }
+
+    Response handle(pldm_tid_t tid, Type pldmType, Command pldmCommand,
+                    const pldm_msg* request, size_t reqMsgLen)
+    {
+        try
+        {
+            return handlers.at(pldmType).at(pldmCommand)(tid, request,
+                                                         reqMsgLen);
+        }
+        catch (const std::out_of_range&)
+        {
+            return CmdHandler::ccOnlyResponse(request,
+                                              PLDM_ERROR_UNSUPPORTED_PLDM_CMD);
+        }
+    }
+
+  private:
+    std::map<Type, std::map<Command, HandlerFunc>> handlers;
+};
+
+template <typename T>
+double nsPerMessage(T& invoker, Command cmd)
+{
+    constexpr auto iterations = 200000;
+
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    request->hdr.type = benchType;
+
+    volatile size_t sink = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; i++)
+    {
+        auto command = cmd ? cmd : firstCmd + i % (lastCmd - firstCmd + 1);
+        request->hdr.command = command;
+        sink = invoker.handle(0, benchType, command, request, 0).size();
+    }
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    (void)sink;
+
+    return std::chrono::duration<double, std::nano>(elapsed).count() /
+           iterations;
+}
+
+} // namespace
+
+/** @brief Compare the per message dispatch cost of the invoker's dispatch
+ *         table with nested std::map lookups, for known and unknown commands
+ */
+int main()
+{
+    Invoker invoker{};
+    invoker.registerHandler(benchType, std::make_unique<BenchHandler>());
+    MapInvoker mapInvoker{};
+
+    std::printf("known commands:   map %8.1f ns/msg, table %8.1f ns/msg\n",
+                nsPerMessage(mapInvoker, 0), nsPerMessage(invoker, 0));
+    std::printf("unknown commands: map %8.1f ns/msg, table %8.1f ns/msg\n",
+                nsPerMessage(mapInvoker, unknownCmd),
+                nsPerMessage(invoker, unknownCmd));
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+#include "pldmd/instance_id_lease.hpp"
+
+#include <libpldm/instance-id.h>
+#include <unistd.h>
+
+#include <sdeventplus/event.hpp>
+
+#include <bitset>
+#include <cstring>
+#include <filesystem>
+
+#include <gtest/gtest.h>
+
+using namespace pldm;
+using namespace std::chrono_literals;
+
+static constexpr uintmax_t pldmMaxInstanceIds = 32;
+
+class InstanceIdLeaseTest : public testing::Test
+{
+  protected:
+    InstanceIdLeaseTest() : event(sdeventplus::Event::get_default())
+    {
+        static const char dbTmpl[] = "/tmp/db.XXXXXX";
+        char dbName[sizeof(dbTmpl)] = {};
+
+        ::strncpy(dbName, dbTmpl, sizeof(dbName));
+        ::close(::mkstemp(dbName));
+
+        dbPath = dbName;
+        std::filesystem::resize_file(
+            dbPath, static_cast<uintmax_t>(PLDM_MAX_TIDS) * pldmMaxInstanceIds);
+    }
+
+    ~InstanceIdLeaseTest()
+    {
+        std::filesystem::remove(dbPath);
+    }
+
+    sdeventplus::Event event;
+    std::filesystem::path dbPath;
+};
+
+TEST_F(InstanceIdLeaseTest, allocatesFromLease)
+{
+    LeasedInstanceIdDb db(event, dbPath, 8, 0s);
+    InstanceIdDb shared(dbPath);
+
+    std::bitset<pldmMaxInstanceIds> ids;
+    for (int i = 0; i < 8; i++)
+    {
+        auto id = db.next(1);
+        EXPECT_FALSE(ids.test(id));
+        ids.set(id);
+    }
+
+    // The whole block is leased, so the shared database hands out other IDs
+    auto other = shared.next(1);
+    EXPECT_FALSE(ids.test(other));
+    shared.free(1, other);
+
+    auto stats = db.getStats();
+    EXPECT_EQ(stats.allocations, 8);
+    EXPECT_EQ(stats.leased, 8);
+    EXPECT_EQ(stats.exhaustions, 0);
+}
+
+TEST_F(InstanceIdLeaseTest, freedIdNotReusedImmediately)
+{
+    LeasedInstanceIdDb db(event, dbPath, 8, 0s);
+
+    auto first = db.next(1);
+    db.free(1, first);
+    auto second = db.next(1);
+    EXPECT_NE(first, second);
+    db.free(1, second);
+}
+
+TEST_F(InstanceIdLeaseTest, freeUnallocated)
+{
+    LeasedInstanceIdDb db(event, dbPath, 8, 0s);
+
+    EXPECT_THROW(db.free(1, 0), std::runtime_error);
+    auto id = db.next(1);
+    db.free(1, id);
+    EXPECT_THROW(db.free(1, id), std::runtime_error);
+}
+
+TEST_F(InstanceIdLeaseTest, exhaustion)
+{
+    LeasedInstanceIdDb db(event, dbPath, 8, 0s);
+
+    for (uintmax_t i = 0; i < pldmMaxInstanceIds; i++)
+    {
+        db.next(2);
+    }
+    EXPECT_THROW(db.next(2), std::runtime_error);
+    EXPECT_EQ(db.getStats().exhaustions, 1);
+    EXPECT_EQ(db.getStats().leased, pldmMaxInstanceIds);
+
+    // Other TIDs are unaffected
+    EXPECT_NO_THROW(db.next(3));
+}
+
+TEST_F(InstanceIdLeaseTest, leasesReturnedOnDestruction)
+{
+    {
+        LeasedInstanceIdDb db(event, dbPath, 32, 0s);
+        db.next(1);
+    }
+
+    InstanceIdDb shared(dbPath);
+    for (uintmax_t i = 0; i < pldmMaxInstanceIds; i++)
+    {
+        EXPECT_NO_THROW(shared.next(1));
+    }
+}
+
+TEST_F(InstanceIdLeaseTest, noLease)
+{
+    LeasedInstanceIdDb db(event, dbPath, 0, 0s);
+    InstanceIdDb shared(dbPath);
+
+    auto id = db.next(1);
+    auto other = shared.next(1);
+    EXPECT_NE(id, other);
+    db.free(1, id);
+    shared.free(1, other);
+    EXPECT_EQ(db.getStats().leased, 0);
+}
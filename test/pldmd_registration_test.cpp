@@ -9,7 +9,7 @@
 using namespace pldm;
 using namespace pldm::responder;
 constexpr Command testCmd = 0xFF;
-constexpr Type testType = 0xFF;
+constexpr Type testType = 0x3F;
 constexpr pldm_tid_t tid = 0;
 
 class TestHandler : public CmdHandler
@@ -52,11 +52,26 @@ TEST(Registration, testSuccess)
 
 TEST(Registration, testFailure)
 {
+    std::vector<uint8_t> requestMsg(sizeof(pldm_msg_hdr));
+    auto request = reinterpret_cast<pldm_msg*>(requestMsg.data());
+    std::vector<uint8_t> expectMsg = {0, 0x3F, 0xFF,
+                                      PLDM_ERROR_UNSUPPORTED_PLDM_CMD};
+    request->hdr.type = testType;
+    request->hdr.command = testCmd;
+
     Invoker invoker{};
-    ASSERT_THROW(invoker.handle(tid, testType, testCmd, nullptr, 0),
-                 std::out_of_range);
+    EXPECT_EQ(invoker.handle(tid, testType, testCmd, request, 0), expectMsg);
+
     invoker.registerHandler(testType, std::make_unique<TestHandler>());
     uint8_t badCmd = 0xFE;
-    ASSERT_THROW(invoker.handle(tid, testType, badCmd, nullptr, 0),
+    request->hdr.command = badCmd;
+    expectMsg[2] = badCmd;
+    EXPECT_EQ(invoker.handle(tid, testType, badCmd, request, 0), expectMsg);
+}
+
+TEST(Registration, testTypeOutOfRange)
+{
+    Invoker invoker{};
+    ASSERT_THROW(invoker.registerHandler(0x40, std::make_unique<TestHandler>()),
                  std::out_of_range);
 }
@@ -0,0 +1,308 @@
+#include "common/flight_recorder.hpp"
+#include "common/instance_id.hpp"
+#include "common/transport.hpp"
+#include "common/utils.hpp"
+#include "libpldmresponder/base.hpp"
+#include "libpldmresponder/platform.hpp"
+#include "pldmd/invoker.hpp"
+#include "requester/handler.hpp"
+#include "requester/request.hpp"
+
+#include <libpldm/base.h>
+#include <libpldm/pdr.h>
+#include <unistd.h>
+
+#include <CLI/CLI.hpp>
+#include <phosphor-logging/lg2.hpp>
+#include <sdeventplus/event.hpp>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+PHOSPHOR_LOG2_USING;
+
+using namespace pldm;
+using namespace pldm::flightrecorder;
+using namespace pldm::responder;
+using namespace pldm::utils;
+
+namespace
+{
+
+/** @class ReplayDBusHandler
+ *
+ *  Stands in for D-Bus while replaying, so the responders run without a
+ *  bus: lookups come back empty and property writes are dropped.
+ */
+class ReplayDBusHandler : public DBusHandler
+{
+  public:
+    std::string getService(const char* /*path*/,
+                           const char* /*interface*/) const override
+    {
+        return {};
+    }
+
+    GetSubTreeResponse
+        getSubtree(const std::string& /*path*/, int /*depth*/,
+                   const std::vector<std::string>& /*ifaceList*/) const override
+    {
+        return {};
+    }
+
+    PropertyValue
+        getDbusPropertyVariant(const char* /*objPath*/,
+                               const char* /*dbusProp*/,
+                               const char* /*dbusInterface*/) const override
+    {
+        return {};
+    }
+
+    void setDbusProperty(const DBusMapping& /*dBusMap*/,
+                         const PropertyValue& /*value*/) const override
+    {}
+};
+
+/** @class ReplayTransport
+ *
+ *  Stands in for MCTP while replaying: requests the responders originate
+ *  are dropped instead of sent.
+ */
+class ReplayTransport : public PldmTransport
+{
+  public:
+    ReplayTransport() : PldmTransport(nullptr) {}
+
+    pldm_requester_rc_t sendMsg(pldm_tid_t /*tid*/, const void* /*tx*/,
+                                size_t /*len*/) override
+    {
+        return PLDM_REQUESTER_SUCCESS;
+    }
+};
+
+/** @brief Instance ID database in a temporary file, so the replay doesn't
+ *         take instance IDs from a running pldmd
+ */
+class ReplayInstanceIdDb
+{
+  public:
+    ReplayInstanceIdDb() : path(createDb()), db(path) {}
+
+    ~ReplayInstanceIdDb()
+    {
+        std::filesystem::remove(path);
+    }
+
+    InstanceIdDb& get()
+    {
+        return db;
+    }
+
+  private:
+    static std::filesystem::path createDb()
+    {
+        char dbName[] = "/tmp/pldm_replay_db.XXXXXX";
+        auto fd = ::mkstemp(dbName);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(),
+                                    "Failed to create the instance ID database");
+        }
+        ::close(fd);
+        // libpldm keeps 32 instance IDs per TID
+        std::filesystem::resize_file(dbName,
+                                     static_cast<uintmax_t>(PLDM_MAX_TIDS) *
+                                         32);
+        return dbName;
+    }
+
+    std::filesystem::path path;
+    InstanceIdDb db;
+};
+
+using CommandKey = std::pair<uint8_t, uint8_t>;
+using Latencies = std::vector<std::chrono::nanoseconds>;
+
+/** @brief Nearest-rank percentile of sorted latencies */
+std::chrono::nanoseconds percentile(const Latencies& sorted, unsigned pct)
+{
+    auto rank = (sorted.size() * pct + 99) / 100;
+    return sorted[std::max<size_t>(rank, 1) - 1];
+}
+
+void printReport(std::map<CommandKey, Latencies>& latencies)
+{
+    auto us = [](std::chrono::nanoseconds ns) {
+        return std::chrono::duration<double, std::micro>(ns).count();
+    };
+
+    std::cout << "type cmd    count    p50(us)    p90(us)    p99(us)    max(us)"
+              << std::endl;
+    for (auto& [key, samples] : latencies)
+    {
+        std::sort(samples.begin(), samples.end());
+        std::cout << std::hex << std::setfill('0') << std::setw(4)
+                  << static_cast<unsigned>(key.first) << " " << std::setw(3)
+                  << static_cast<unsigned>(key.second) << std::dec
+                  << std::setfill(' ') << std::fixed << std::setprecision(1)
+                  << std::setw(9) << samples.size() << std::setw(11)
+                  << us(percentile(samples, 50)) << std::setw(11)
+                  << us(percentile(samples, 90)) << std::setw(11)
+                  << us(percentile(samples, 99)) << std::setw(11)
+                  << us(samples.back()) << std::endl;
+    }
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    CLI::App app{"Replay a PLDM flight recorder dump against the responder"};
+    std::string dumpPath{flightRecorderBinaryDumpPath};
+    app.add_option("-f,--file", dumpPath, "Binary flight recorder dump");
+    double speed = 1.0;
+    app.add_option("-s,--speed", speed,
+                   "Replay speed relative to the recording, 0 replays as "
+                   "fast as possible")
+        ->check(CLI::NonNegativeNumber);
+    std::string pdrDir{PDR_JSONS_DIR};
+    app.add_option("-p,--pdr-dir", pdrDir, "PDR JSON directory");
+    uint8_t localEid = TERMINUS_ID;
+    app.add_option("-e,--eid", localEid, "EID of the replayed responder");
+    CLI11_PARSE(app, argc, argv);
+
+    std::vector<RecordedMessage> messages;
+    try
+    {
+        messages = loadRecorderDump(dumpPath);
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to load the flight recorder dump: {ERROR}", "ERROR", e);
+        return EXIT_FAILURE;
+    }
+
+    std::unique_ptr<ReplayInstanceIdDb> instanceIdDb;
+    try
+    {
+        instanceIdDb = std::make_unique<ReplayInstanceIdDb>();
+    }
+    catch (const std::exception& e)
+    {
+        error("Failed to create the instance ID database: {ERROR}", "ERROR",
+              e);
+        return EXIT_FAILURE;
+    }
+
+    auto event = sdeventplus::Event::get_default();
+    ReplayDBusHandler dBusHandler;
+    std::unique_ptr<pldm_pdr, decltype(&pldm_pdr_destroy)> pdrRepo(
+        pldm_pdr_init(), pldm_pdr_destroy);
+    ReplayTransport transport;
+    requester::Handler<requester::Request> reqHandler(
+        &transport, event, instanceIdDb->get(), false);
+
+    Invoker invoker{};
+    invoker.registerHandler(PLDM_BASE,
+                            std::make_unique<base::Handler>(event, nullptr));
+    invoker.registerHandler(
+        PLDM_PLATFORM,
+        std::make_unique<platform::Handler>(
+            &dBusHandler, localEid, &instanceIdDb->get(), pdrDir, pdrRepo.get(),
+            nullptr, nullptr, nullptr, nullptr, nullptr, &reqHandler, event,
+            true));
+
+    std::map<CommandKey, Latencies> latencies;
+    size_t replayed = 0;
+    size_t truncated = 0;
+    size_t responses = 0;
+    auto replayStart = std::chrono::steady_clock::now();
+    auto recordStart = messages.empty() ? 0 : messages.front().timestamp;
+
+    for (const auto& message : messages)
+    {
+        // Only the messages pldmd received are replayed, what it sent is
+        // regenerated by the handlers
+        if (message.isTx)
+        {
+            continue;
+        }
+        if (message.payload.size() < message.length ||
+            message.payload.size() < sizeof(pldm_msg_hdr))
+        {
+            truncated++;
+            continue;
+        }
+
+        pldm_header_info hdrFields{};
+        auto msg = reinterpret_cast<const pldm_msg*>(message.payload.data());
+        if (PLDM_SUCCESS != unpack_pldm_header(&msg->hdr, &hdrFields))
+        {
+            truncated++;
+            continue;
+        }
+        // Received responses answered requests of the recorded pldmd, the
+        // replayed one has no request outstanding to match them against
+        if (hdrFields.msg_type == PLDM_RESPONSE)
+        {
+            responses++;
+            continue;
+        }
+
+        if (speed > 0)
+        {
+            auto due = replayStart +
+                       std::chrono::duration_cast<std::chrono::nanoseconds>(
+                           std::chrono::nanoseconds(message.timestamp -
+                                                    recordStart) /
+                           speed);
+            for (auto now = std::chrono::steady_clock::now(); now < due;
+                 now = std::chrono::steady_clock::now())
+            {
+                event.run(std::chrono::duration_cast<
+                          sdeventplus::SdEventDuration>(due - now));
+            }
+        }
+
+        auto payloadLength = message.payload.size() - sizeof(pldm_msg_hdr);
+
+        auto start = std::chrono::steady_clock::now();
+        try
+        {
+            invoker.handle(message.eid, hdrFields.pldm_type, hdrFields.command,
+                           msg, payloadLength);
+        }
+        catch (const std::exception& e)
+        {
+            error("Failed to replay PLDM command {CMD}: {ERROR}", "CMD",
+                  static_cast<unsigned>(hdrFields.command), "ERROR", e);
+        }
+        latencies[{hdrFields.pldm_type, hdrFields.command}].push_back(
+            std::chrono::steady_clock::now() - start);
+        replayed++;
+
+        // Let deferred work queued by the handler run before the next message
+        event.run(sdeventplus::SdEventDuration::zero());
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - replayStart;
+    std::cout << "Replayed " << replayed << " of " << messages.size()
+              << " recorded messages (" << truncated
+              << " truncated or malformed, " << responses
+              << " responses skipped) in "
+              << std::chrono::duration<double>(elapsed).count() << " s"
+              << std::endl;
+    printReport(latencies);
+
+    return EXIT_SUCCESS;
+}